@@ -0,0 +1,280 @@
+/**
+ * @file BlockCompressor.cpp
+ * @brief BlockCompressor class implementation file.
+ * @version 1.0.0 (2023-02-11)
+ * @date 2023-02-11
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "BlockCompressor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "Classes/TextureContainer/TextureContainer.h"
+#include "Classes/ThreadPool/ThreadPool.h"
+
+namespace aladdin_3d {
+
+	bool BlockCompressor::canEncode(GLenum format) {
+
+		return format == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT || format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT ||
+				format == GL_COMPRESSED_RG_RGTC2;
+
+	}
+
+	TextureLevel BlockCompressor::compress(const TextureLevel& level, GLenum format) {
+
+		// Allocate the blocks.
+		TextureLevel compressed;
+		compressed.width = level.width;
+		compressed.height = level.height;
+		compressed.data.resize(TextureContainer::getLevelSize(format, level.width, level.height));
+
+		int blocks_x = (level.width + 3) / 4;
+		int blocks_y = (level.height + 3) / 4;
+		size_t block_bytes = format == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT ? 8 : 16;
+
+		// Each chunk of the pool encodes some rows of blocks.
+		ThreadPool::getShared().parallelFor(blocks_y, [&](size_t first, size_t last) {
+
+			unsigned char pixels[64];
+
+			for (size_t by = first; by < last; by++) {
+
+				for (int bx = 0; bx < blocks_x; bx++) {
+
+					// Fetch the 4x4 pixels, repeating the edge in partial blocks.
+					for (int y = 0; y < 4; y++) {
+
+						for (int x = 0; x < 4; x++) {
+
+							int px = std::min(bx * 4 + x, level.width - 1);
+							int py = std::min((int) by * 4 + y, level.height - 1);
+							const unsigned char* source = &level.data[((size_t) py * level.width + px) * 4];
+							std::copy(source, source + 4, pixels + (y * 4 + x) * 4);
+
+						}
+
+					}
+
+					// Encode them.
+					unsigned char* output = &compressed.data[(by * blocks_x + bx) * block_bytes];
+
+					if (format == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT) {
+
+						BlockCompressor::encodeColorBlock(pixels, output);
+
+					} else if (format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT) {
+
+						BlockCompressor::encodeChannelBlock(pixels, 3, output);
+						BlockCompressor::encodeColorBlock(pixels, output + 8);
+
+					} else {
+
+						BlockCompressor::encodeChannelBlock(pixels, 0, output);
+						BlockCompressor::encodeChannelBlock(pixels, 1, output + 8);
+
+					}
+
+				}
+
+			}
+
+		});
+
+		return compressed;
+
+	}
+
+	void BlockCompressor::encodeColorBlock(const unsigned char* pixels, unsigned char* output) {
+
+		// Get the mean color.
+		float mean[3] = { 0.0f, 0.0f, 0.0f };
+
+		for (int i = 0; i < 16; i++)
+			for (int c = 0; c < 3; c++)
+				mean[c] += pixels[i * 4 + c] / 16.0f;
+
+		// Get the covariance of the colors.
+		float covariance[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+		for (int i = 0; i < 16; i++) {
+
+			float r = pixels[i * 4 + 0] - mean[0];
+			float g = pixels[i * 4 + 1] - mean[1];
+			float b = pixels[i * 4 + 2] - mean[2];
+
+			covariance[0] += r * r;
+			covariance[1] += r * g;
+			covariance[2] += r * b;
+			covariance[3] += g * g;
+			covariance[4] += g * b;
+			covariance[5] += b * b;
+
+		}
+
+		// Get its principal axis with a few power iterations.
+		float axis[3] = { 1.0f, 1.0f, 1.0f };
+
+		for (int iteration = 0; iteration < 4; iteration++) {
+
+			float next[3] = {
+				covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+				covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+				covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2]
+			};
+
+			float length = std::max(std::max(std::fabs(next[0]), std::fabs(next[1])), std::fabs(next[2]));
+
+			if (length < 1e-6f)
+				break;
+
+			for (int c = 0; c < 3; c++)
+				axis[c] = next[c] / length;
+
+		}
+
+		// The endpoints are the pixels at both ends of the axis.
+		float min_projection = 1e30f, max_projection = -1e30f;
+		int min_pixel = 0, max_pixel = 0;
+
+		for (int i = 0; i < 16; i++) {
+
+			float projection = pixels[i * 4 + 0] * axis[0] + pixels[i * 4 + 1] * axis[1] + pixels[i * 4 + 2] * axis[2];
+
+			if (projection < min_projection) {
+
+				min_projection = projection;
+				min_pixel = i;
+
+			}
+
+			if (projection > max_projection) {
+
+				max_projection = projection;
+				max_pixel = i;
+
+			}
+
+		}
+
+		// Quantize them to 5:6:5.
+		auto to565 = [pixels](int i) -> uint16_t {
+			return (uint16_t) (((pixels[i * 4 + 0] * 31 + 127) / 255) << 11 |
+					((pixels[i * 4 + 1] * 63 + 127) / 255) << 5 |
+					((pixels[i * 4 + 2] * 31 + 127) / 255));
+		};
+
+		uint16_t color0 = to565(max_pixel);
+		uint16_t color1 = to565(min_pixel);
+
+		// The four color mode needs the first endpoint to be the greater one.
+		if (color0 < color1)
+			std::swap(color0, color1);
+
+		// Build the palette from the quantized endpoints.
+		int palette[4][3];
+
+		for (int e = 0; e < 2; e++) {
+
+			uint16_t color = e == 0 ? color0 : color1;
+			palette[e][0] = ((color >> 11) & 31) * 255 / 31;
+			palette[e][1] = ((color >> 5) & 63) * 255 / 63;
+			palette[e][2] = (color & 31) * 255 / 31;
+
+		}
+
+		for (int c = 0; c < 3; c++) {
+
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+
+		}
+
+		// Pick the closest palette entry for each pixel.
+		uint32_t indices = 0;
+
+		for (int i = 0; i < 16 && color0 != color1; i++) {
+
+			int best = 0, best_distance = 1 << 30;
+
+			for (int p = 0; p < 4; p++) {
+
+				int distance = 0;
+
+				for (int c = 0; c < 3; c++) {
+
+					int difference = pixels[i * 4 + c] - palette[p][c];
+					distance += difference * difference;
+
+				}
+
+				if (distance < best_distance) {
+
+					best_distance = distance;
+					best = p;
+
+				}
+
+			}
+
+			indices |= (uint32_t) best << (2 * i);
+
+		}
+
+		// Write the block.
+		output[0] = color0 & 0xFF;
+		output[1] = color0 >> 8;
+		output[2] = color1 & 0xFF;
+		output[3] = color1 >> 8;
+
+		for (int i = 0; i < 4; i++)
+			output[4 + i] = (indices >> (8 * i)) & 0xFF;
+
+	}
+
+	void BlockCompressor::encodeChannelBlock(const unsigned char* pixels, int channel, unsigned char* output) {
+
+		// The endpoints are the extremes of the channel.
+		int value0 = 0, value1 = 255;
+
+		for (int i = 0; i < 16; i++) {
+
+			value0 = std::max(value0, (int) pixels[i * 4 + channel]);
+			value1 = std::min(value1, (int) pixels[i * 4 + channel]);
+
+		}
+
+		// Pick the closest of the eight values for each pixel. Index 0 and 1 are
+		// the endpoints, 2 to 7 go from the first to the second one.
+		uint64_t indices = 0;
+
+		for (int i = 0; i < 16 && value0 != value1; i++) {
+
+			int value = pixels[i * 4 + channel];
+			int step = (int) std::lround(7.0f * (value0 - value) / (value0 - value1));
+			int index = step == 0 ? 0 : (step == 7 ? 1 : step + 1);
+
+			indices |= (uint64_t) index << (3 * i);
+
+		}
+
+		// Write the block.
+		output[0] = (unsigned char) value0;
+		output[1] = (unsigned char) value1;
+
+		for (int i = 0; i < 6; i++)
+			output[2 + i] = (indices >> (8 * i)) & 0xFF;
+
+	}
+
+} // namespace aladdin_3d
@@ -0,0 +1,91 @@
+/**
+ * @file BlockCompressor.h
+ * @brief BlockCompressor class header file.
+ * @version 1.0.0 (2023-02-11)
+ * @date 2023-02-11
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_BLOCKCOMPRESSOR_H_
+#define ALADDIN_3D_CLASS_BLOCKCOMPRESSOR_H_
+
+#include "GL/glew.h"
+
+#include "Structs/TextureLevel/TextureLevel.h"
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implements a BC1, BC3 and BC5 block encoder.
+	 *
+	 * Implements an encoder of RGBA8 images into BC1, BC3 and BC5 blocks. Colors
+	 * are fitted along their principal axis, alpha and the BC5 channels use the
+	 * eight value mode.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class BlockCompressor {
+
+		public:
+
+			/**
+			 * @brief Checks if a format can be encoded.
+			 *
+			 * Checks if an OpenGL internal format can be encoded.
+			 *
+			 * @param format OpenGL internal format.
+			 *
+			 * @returns Whether the format can be encoded.
+			 */
+			static bool canEncode(GLenum format);
+
+			/**
+			 * @brief Compresses a level.
+			 *
+			 * Compresses an RGBA8 level into blocks, using the thread pool over
+			 * the rows of blocks.
+			 *
+			 * @param level RGBA8 level.
+			 * @param format OpenGL internal format of the blocks.
+			 *
+			 * @returns The compressed level.
+			 */
+			static TextureLevel compress(const TextureLevel& level, GLenum format);
+
+		private:
+
+			/**
+			 * @brief Encodes a BC1 color block.
+			 *
+			 * Encodes the colors of 16 RGBA pixels into an 8 byte block, always
+			 * using the four color mode.
+			 *
+			 * @param pixels 16 RGBA pixels, row by row.
+			 * @param output Where the block is written.
+			 */
+			static void encodeColorBlock(const unsigned char* pixels, unsigned char* output);
+
+			/**
+			 * @brief Encodes a BC4 block.
+			 *
+			 * Encodes one channel of 16 RGBA pixels into an 8 byte block, using
+			 * the eight value mode.
+			 *
+			 * @param pixels 16 RGBA pixels, row by row.
+			 * @param channel Channel to encode.
+			 * @param output Where the block is written.
+			 */
+			static void encodeChannelBlock(const unsigned char* pixels, int channel, unsigned char* output);
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_BLOCKCOMPRESSOR_H_
@@ -15,6 +15,8 @@
 
 #include "Camera.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 #include "GL/glew.h"
@@ -57,12 +59,36 @@ namespace aladdin_3d {
 
 	}
 
+	float Camera::getFar() {
+
+		return this->far;
+
+	}
+
+	float Camera::getNear() {
+
+		return this->near;
+
+	}
+
 	glm::vec3 Camera::getPosition() {
 
 		return this->position;
 
 	}
 
+	float Camera::getProjectedSize(glm::vec3 centre, float radius) {
+
+		// Distance along the view direction, at least the near plane.
+		float distance = std::max(glm::dot(centre - this->position, glm::normalize(this->direction)), this->near);
+
+		// The vertical field of view spans the window height at that distance.
+		float half_height = distance * std::tan(glm::radians(this->fov) / 2.0f);
+
+		return radius / half_height * this->window_height;
+
+	}
+
 	glm::mat4 Camera::getProjection() {
 
 		return this->projection;
@@ -237,6 +263,14 @@ namespace aladdin_3d {
 
 	}
 
+	void Camera::setViewport(int width, int height) {
+
+		// Never let the aspect ratio divide by zero, the window may be minimized.
+		this->window_width = width > 0 ? width : 1;
+		this->window_height = height > 0 ? height : 1;
+
+	}
+
 	void Camera::update() {
 
 		// Calculate the view matrix.
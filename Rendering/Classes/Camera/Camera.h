@@ -61,6 +61,20 @@ namespace aladdin_3d {
 			 */
 			glm::vec3 getDirection();
 
+			/**
+			 * @brief Get the far clipping limit.
+			 *
+			 * Get the far clipping limit.
+			 */
+			float getFar();
+
+			/**
+			 * @brief Get the near clipping limit.
+			 *
+			 * Get the near clipping limit.
+			 */
+			float getNear();
+
 			/**
 			 * @brief Get the camera position.
 			 *
@@ -68,6 +82,19 @@ namespace aladdin_3d {
 			 */
 			glm::vec3 getPosition();
 
+			/**
+			 * @brief Get the projected size of a sphere.
+			 *
+			 * Get the approximate diameter in pixels that a sphere covers on the
+			 * screen, from its distance to the camera and the field of view.
+			 *
+			 * @param centre Centre of the sphere in world coordinates.
+			 * @param radius Radius of the sphere.
+			 *
+			 * @returns The diameter in pixels.
+			 */
+			float getProjectedSize(glm::vec3 centre, float radius);
+
 			/**
 			 * @brief Get the projection matrix.
 			 * 
@@ -159,6 +186,17 @@ namespace aladdin_3d {
 			 */
 			void rotateUp();
 
+			/**
+			 * @brief Set the size of the viewport.
+			 *
+			 * Set the size in pixels of what the camera renders into, which gives the
+			 * aspect ratio and the projected sizes. Takes effect on the next update().
+			 *
+			 * @param width Width in pixels.
+			 * @param height Height in pixels.
+			 */
+			void setViewport(int width, int height);
+
 			/**
 			 * @brief Calculate the camera matrix from the parameters.
 			 *
@@ -175,8 +213,8 @@ namespace aladdin_3d {
 			float near;					/// Minimum clipping limit.
 			glm::vec3 position;			/// Coordinates of the camera.
 			glm::vec3 up;				/// Vector that tells us the rotation of the camera.
-			int window_height;			/// Height of the GLUT window.
-			int window_width;			/// Width of the GLUT window.
+			int window_height;			/// Height of the viewport.
+			int window_width;			/// Width of the viewport.
 			glm::mat4 view;				/// View matrix.
 			glm::mat4 projection;		/// Projection matrix.
 
@@ -0,0 +1,667 @@
+/**
+ * @file Environment.cpp
+ * @brief Environment class implementation file.
+ * @version 1.0.0 (2023-02-27)
+ * @date 2023-02-27
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "Environment.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#include "glm/gtc/type_ptr.hpp"
+#include "stb/stb_image.h"
+
+#include "Classes/ProfilerScope/ProfilerScope.h"
+#include "Classes/ThreadPool/ThreadPool.h"
+
+#define ENVIRONMENT_PI 3.14159265358979f
+
+namespace aladdin_3d {
+
+	// Direction through the centre of a texel of an equirectangular map, +y up and
+	// the middle column looking down -z.
+	static inline glm::vec3 texelDirection(int x, int y, int width, int height) {
+
+		float phi = (((x + 0.5f) / width) - 0.5f) * 2.0f * ENVIRONMENT_PI;
+		float theta = ((y + 0.5f) / height) * ENVIRONMENT_PI;
+
+		return glm::vec3(std::sin(theta) * std::sin(phi), std::cos(theta), -std::sin(theta) * std::cos(phi));
+
+	}
+
+	// Bilinear sample of an equirectangular map, wrapping around horizontally.
+	static inline glm::vec3 sampleMap(const std::vector<float>& pixels, int width, int height, glm::vec3 direction) {
+
+		float u = std::atan2(direction.x, -direction.z) / (2.0f * ENVIRONMENT_PI) + 0.5f;
+		float v = std::acos(std::min(std::max(direction.y, -1.0f), 1.0f)) / ENVIRONMENT_PI;
+
+		float x = u * width - 0.5f;
+		float y = std::min(std::max(v * height - 0.5f, 0.0f), (float) (height - 1));
+		int x0 = (int) std::floor(x);
+		int y0 = (int) y;
+		float fx = x - x0;
+		float fy = y - y0;
+		int y1 = std::min(y0 + 1, height - 1);
+		x0 = ((x0 % width) + width) % width;
+		int x1 = (x0 + 1) % width;
+
+		const float* p00 = &pixels[((size_t) y0 * width + x0) * 3];
+		const float* p10 = &pixels[((size_t) y0 * width + x1) * 3];
+		const float* p01 = &pixels[((size_t) y1 * width + x0) * 3];
+		const float* p11 = &pixels[((size_t) y1 * width + x1) * 3];
+
+		glm::vec3 color;
+
+		for (int c = 0; c < 3; c++)
+			color[c] = (p00[c] * (1.0f - fx) + p10[c] * fx) * (1.0f - fy) + (p01[c] * (1.0f - fx) + p11[c] * fx) * fy;
+
+		return color;
+
+	}
+
+	// Trilinear sample of the source pyramid.
+	static inline glm::vec3 samplePyramid(const std::vector<std::vector<float>>& pyramid, int source_width, glm::vec3 direction, float lod) {
+
+		lod = std::min(std::max(lod, 0.0f), (float) (pyramid.size() - 1));
+		int level = std::min((int) lod, (int) pyramid.size() - 2);
+		float blend = lod - level;
+
+		if (level < 0)
+			return sampleMap(pyramid[0], source_width, source_width / 2, direction);
+
+		int width = source_width >> level;
+		glm::vec3 fine = sampleMap(pyramid[level], width, std::max(width / 2, 1), direction);
+		glm::vec3 coarse = sampleMap(pyramid[level + 1], std::max(width / 2, 1), std::max(width / 4, 1), direction);
+
+		return fine * (1.0f - blend) + coarse * blend;
+
+	}
+
+	// Low discrepancy points on the unit square.
+	static inline glm::vec2 hammersley(uint32_t index, uint32_t count) {
+
+		uint32_t bits = index;
+		bits = (bits << 16u) | (bits >> 16u);
+		bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+		bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+		bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+		bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+
+		return glm::vec2((float) index / count, bits * 2.3283064365386963e-10f);
+
+	}
+
+	// Squared cosine of a half vector sampled from a distribution, with the roughness
+	// meaning the same as in cook_torrance.frag.
+	static inline float sampleCosineSquared(float xi, float roughness, int distribution) {
+
+		if (distribution == 1) {
+
+			float alpha_squared = roughness * roughness * roughness * roughness;
+			return (1.0f - xi) / (1.0f + (alpha_squared - 1.0f) * xi);
+
+		}
+
+		float tan_squared = -roughness * roughness * std::log(1.0f - xi);
+		return 1.0f / (1.0f + tan_squared);
+
+	}
+
+	// Normalized distribution of the half vectors.
+	static inline float evaluateDistribution(float cos_squared, float roughness, int distribution) {
+
+		if (distribution == 1) {
+
+			float alpha_squared = roughness * roughness * roughness * roughness;
+			float d = cos_squared * (alpha_squared - 1.0f) + 1.0f;
+			return alpha_squared / (ENVIRONMENT_PI * d * d);
+
+		}
+
+		float m_squared = roughness * roughness;
+		return std::exp((cos_squared - 1.0f) / (cos_squared * m_squared)) / (ENVIRONMENT_PI * m_squared * cos_squared * cos_squared);
+
+	}
+
+	// Half vector around the z axis.
+	static inline glm::vec3 sampleHalfVector(glm::vec2 xi, float roughness, int distribution) {
+
+		float cos_squared = sampleCosineSquared(xi.y, roughness, distribution);
+		float cos_theta = std::sqrt(cos_squared);
+		float sin_theta = std::sqrt(std::max(1.0f - cos_squared, 0.0f));
+		float phi = 2.0f * ENVIRONMENT_PI * xi.x;
+
+		return glm::vec3(sin_theta * std::cos(phi), sin_theta * std::sin(phi), cos_theta);
+
+	}
+
+	// Roughness of a specular level, never quite 0 so the distributions stay finite.
+	static inline float levelRoughness(int level) {
+
+		return std::max((float) level / (ENVIRONMENT_SPECULAR_LEVELS - 1), 0.02f);
+
+	}
+
+	template <typename T>
+	static inline void writeValue(std::ofstream& stream, const T& value) {
+
+		stream.write((const char*) &value, sizeof(T));
+
+	}
+
+	template <typename T>
+	static inline bool readValue(std::ifstream& stream, T* value) {
+
+		return (bool) stream.read((char*) value, sizeof(T));
+
+	}
+
+	Environment::Environment() {}
+
+	void Environment::bind(Shader& shader, Camera& camera, int distribution) {
+
+		if (!this->ready)
+			return;
+
+		GLuint program = shader.getProgramID();
+
+		glActiveTexture(GL_TEXTURE0 + ENVIRONMENT_SPECULAR_UNIT);
+		glBindTexture(GL_TEXTURE_2D, distribution == 1 ? this->ggx_texture : this->beckmann_texture);
+		glActiveTexture(GL_TEXTURE0 + ENVIRONMENT_LUT_UNIT);
+		glBindTexture(GL_TEXTURE_2D, this->lut_texture);
+		glActiveTexture(GL_TEXTURE0);
+
+		shader.passInt("environmentSpecular", ENVIRONMENT_SPECULAR_UNIT);
+		shader.passInt("environmentLUT", ENVIRONMENT_LUT_UNIT);
+		shader.passInt("environmentDistribution", distribution);
+		shader.passFloat("environmentLevels", (float) ENVIRONMENT_SPECULAR_LEVELS);
+
+		// The shaders light in view space, the map is in world space.
+		glm::mat3 rotation = glm::transpose(glm::mat3(camera.getView()));
+		glUniformMatrix3fv(glGetUniformLocation(program, "environmentRotation"), 1, GL_FALSE, glm::value_ptr(rotation));
+		glUniform3fv(glGetUniformLocation(program, "environmentSH"), 9, glm::value_ptr(this->irradiance[0]));
+
+	}
+
+	bool Environment::isFiltering() {
+
+		return this->pending.valid();
+
+	}
+
+	bool Environment::isReady() {
+
+		return this->ready;
+
+	}
+
+	void Environment::load(const std::string& path) {
+
+		// Read the cache if it is newer than the map, or filter the map and write it.
+		this->pending = ThreadPool::getShared().submit([path]() {
+
+			std::filesystem::path cache_path = std::filesystem::path(path).replace_extension(".ibl");
+			std::error_code error;
+
+			if (std::filesystem::exists(cache_path, error) &&
+					std::filesystem::last_write_time(cache_path, error) >= std::filesystem::last_write_time(path, error)) {
+
+				std::shared_ptr<EnvironmentData> cached = Environment::readCache(cache_path);
+
+				if (cached != nullptr)
+					return cached;
+
+			}
+
+			std::shared_ptr<EnvironmentData> data = Environment::filter(path);
+
+			if (data != nullptr && !Environment::writeCache(cache_path, *data))
+				std::cerr << "Environment warning - Could not write the cache " << cache_path.string() << std::endl;
+
+			return data;
+
+		});
+
+	}
+
+	void Environment::processUpload() {
+
+		if (!this->pending.valid() || this->pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			return;
+
+		std::shared_ptr<EnvironmentData> data = this->pending.get();
+
+		if (data == nullptr)
+			return;
+
+		this->remove();
+
+		// One texture per distribution, a level per roughness. They are sampled at an
+		// explicit level, so the seam of the longitude does not pick the smallest one.
+		GLuint* textures[2] = { &this->beckmann_texture, &this->ggx_texture };
+		const std::vector<std::vector<float>>* levels[2] = { &data->beckmann, &data->ggx };
+
+		for (int d = 0; d < 2; d++) {
+
+			glGenTextures(1, textures[d]);
+			glBindTexture(GL_TEXTURE_2D, *textures[d]);
+
+			for (int level = 0; level < (int) levels[d]->size(); level++) {
+
+				int width = std::max(data->width >> level, 1);
+				glTexImage2D(GL_TEXTURE_2D, level, GL_RGB16F, width, std::max(width / 2, 1), 0, GL_RGB, GL_FLOAT, (*levels[d])[level].data());
+
+			}
+
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint) levels[d]->size() - 1);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		}
+
+		// The lookup table of both distributions.
+		glGenTextures(1, &this->lut_texture);
+		glBindTexture(GL_TEXTURE_2D, this->lut_texture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, ENVIRONMENT_LUT_SIZE, ENVIRONMENT_LUT_SIZE, 0, GL_RGBA, GL_FLOAT, data->lut.data());
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		std::copy(std::begin(data->irradiance), std::end(data->irradiance), std::begin(this->irradiance));
+		this->ready = true;
+
+	}
+
+	void Environment::remove() {
+
+		glDeleteTextures(1, &this->beckmann_texture);
+		glDeleteTextures(1, &this->ggx_texture);
+		glDeleteTextures(1, &this->lut_texture);
+
+		this->beckmann_texture = this->ggx_texture = this->lut_texture = 0;
+		this->ready = false;
+
+	}
+
+	std::shared_ptr<EnvironmentData> Environment::filter(const std::string& path) {
+
+		ProfilerScope scope("Environment filtering");
+
+		// Read the map as linear floats.
+		int width = 0, height = 0, channels = 0;
+		float* image = stbi_loadf(path.c_str(), &width, &height, &channels, 3);
+
+		if (image == nullptr) {
+
+			std::cerr << "Environment error - Could not read the map " << path << std::endl;
+			return nullptr;
+
+		}
+
+		// Resample it to a fixed size, averaging the texels under each one when shrinking.
+		int source_width = ENVIRONMENT_SOURCE_WIDTH;
+		int source_height = source_width / 2;
+		std::vector<std::vector<float>> pyramid(1, std::vector<float>((size_t) source_width * source_height * 3));
+		std::vector<float> original(image, image + (size_t) width * height * 3);
+		stbi_image_free(image);
+
+		ThreadPool::getShared().parallelFor(source_height, [&](size_t first, size_t last) {
+
+			for (size_t y = first; y < last; y++) {
+
+				for (int x = 0; x < source_width; x++) {
+
+					int x0 = (int) (x * (size_t) width / source_width);
+					int x1 = std::max((int) ((x + 1) * (size_t) width / source_width), x0 + 1);
+					int y0 = (int) (y * (size_t) height / source_height);
+					int y1 = std::max((int) ((y + 1) * (size_t) height / source_height), y0 + 1);
+
+					glm::vec3 sum(0.0f);
+
+					if (width >= source_width && height >= source_height) {
+
+						for (int sy = y0; sy < y1; sy++)
+							for (int sx = x0; sx < x1; sx++)
+								sum = sum + glm::vec3(original[((size_t) sy * width + sx) * 3], original[((size_t) sy * width + sx) * 3 + 1], original[((size_t) sy * width + sx) * 3 + 2]);
+
+						sum = sum / (float) ((x1 - x0) * (y1 - y0));
+
+					} else {
+
+						sum = sampleMap(original, width, height, texelDirection(x, (int) y, source_width, source_height));
+
+					}
+
+					for (int c = 0; c < 3; c++)
+						pyramid[0][(y * source_width + x) * 3 + c] = sum[c];
+
+				}
+
+			}
+
+		});
+
+		// Halve it down to a couple of texels.
+		for (int level_width = source_width / 2; level_width >= 2; level_width /= 2) {
+
+			const std::vector<float>& above = pyramid.back();
+			int level_height = level_width / 2;
+			std::vector<float> level((size_t) level_width * level_height * 3);
+
+			for (int y = 0; y < level_height; y++)
+				for (int x = 0; x < level_width; x++)
+					for (int c = 0; c < 3; c++)
+						level[((size_t) y * level_width + x) * 3 + c] = 0.25f * (
+							above[((size_t) (2 * y) * (2 * level_width) + 2 * x) * 3 + c] +
+							above[((size_t) (2 * y) * (2 * level_width) + 2 * x + 1) * 3 + c] +
+							above[((size_t) (2 * y + 1) * (2 * level_width) + 2 * x) * 3 + c] +
+							above[((size_t) (2 * y + 1) * (2 * level_width) + 2 * x + 1) * 3 + c]);
+
+			pyramid.push_back(level);
+
+		}
+
+		// Filter everything.
+		std::shared_ptr<EnvironmentData> data = std::make_shared<EnvironmentData>();
+		data->width = ENVIRONMENT_SPECULAR_WIDTH;
+
+		prefilter(pyramid, source_width, 0, &data->beckmann);
+		prefilter(pyramid, source_width, 1, &data->ggx);
+		projectIrradiance(pyramid[std::min<size_t>(2, pyramid.size() - 1)], source_width >> std::min<size_t>(2, pyramid.size() - 1), data.get());
+		integrateLUT(data.get());
+
+		return data;
+
+	}
+
+	void Environment::integrateLUT(EnvironmentData* data) {
+
+		data->lut.assign((size_t) ENVIRONMENT_LUT_SIZE * ENVIRONMENT_LUT_SIZE * 4, 0.0f);
+
+		// The view angle across, the roughness down.
+		ThreadPool::getShared().parallelFor(ENVIRONMENT_LUT_SIZE, [data](size_t first, size_t last) {
+
+			for (size_t row = first; row < last; row++) {
+
+				float roughness = std::max((row + 0.5f) / ENVIRONMENT_LUT_SIZE, 0.02f);
+
+				for (int column = 0; column < ENVIRONMENT_LUT_SIZE; column++) {
+
+					float NdotV = (column + 0.5f) / ENVIRONMENT_LUT_SIZE;
+					glm::vec3 view(std::sqrt(1.0f - NdotV * NdotV), 0.0f, NdotV);
+
+					for (int d = 0; d < 2; d++) {
+
+						float scale = 0.0f, bias = 0.0f;
+
+						for (uint32_t i = 0; i < ENVIRONMENT_LUT_SAMPLES; i++) {
+
+							glm::vec3 half = sampleHalfVector(hammersley(i, ENVIRONMENT_LUT_SAMPLES), roughness, d);
+							float VdotH = glm::dot(view, half);
+							glm::vec3 light = half * (2.0f * VdotH) - view;
+
+							float NdotL = light.z;
+							float NdotH = half.z;
+
+							if (NdotL <= 0.0f || VdotH <= 0.0f)
+								continue;
+
+							// The same geometric term as cook_torrance.frag, weighted by the pdf.
+							float G = std::min(1.0f, std::min(2.0f * NdotH * NdotV / VdotH, 2.0f * NdotH * NdotL / VdotH));
+							float visibility = G * VdotH / (NdotH * NdotV);
+							float fresnel = std::pow(1.0f - VdotH, 5.0f);
+
+							scale += (1.0f - fresnel) * visibility;
+							bias += fresnel * visibility;
+
+						}
+
+						data->lut[(row * ENVIRONMENT_LUT_SIZE + column) * 4 + 2 * d] = scale / ENVIRONMENT_LUT_SAMPLES;
+						data->lut[(row * ENVIRONMENT_LUT_SIZE + column) * 4 + 2 * d + 1] = bias / ENVIRONMENT_LUT_SAMPLES;
+
+					}
+
+				}
+
+			}
+
+		});
+
+	}
+
+	void Environment::prefilter(const std::vector<std::vector<float>>& pyramid, int source_width, int distribution, std::vector<std::vector<float>>* levels) {
+
+		levels->resize(ENVIRONMENT_SPECULAR_LEVELS);
+
+		// Solid angle of a source texel, roughly.
+		float texel_angle = 4.0f * ENVIRONMENT_PI / ((float) source_width * source_width / 2);
+
+		for (int level = 0; level < ENVIRONMENT_SPECULAR_LEVELS; level++) {
+
+			int width = std::max(ENVIRONMENT_SPECULAR_WIDTH >> level, 1);
+			int height = std::max(width / 2, 1);
+			float roughness = levelRoughness(level);
+			float base_lod = std::log2((float) source_width / width);
+			std::vector<float>& pixels = (*levels)[level];
+			pixels.assign((size_t) width * height * 3, 0.0f);
+
+			ThreadPool::getShared().parallelFor(height, [&, width, height, roughness, base_lod](size_t first, size_t last) {
+
+				for (size_t y = first; y < last; y++) {
+
+					for (int x = 0; x < width; x++) {
+
+						glm::vec3 normal = texelDirection(x, (int) y, width, height);
+						glm::vec3 color(0.0f);
+
+						if (level == 0) {
+
+							// A mirror only needs the source at this size.
+							color = samplePyramid(pyramid, source_width, normal, base_lod);
+
+						} else {
+
+							// The view is along the normal, so the reflection is too.
+							glm::vec3 up = std::fabs(normal.y) < 0.999f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+							glm::vec3 tangent = glm::normalize(glm::cross(up, normal));
+							glm::vec3 bitangent = glm::cross(normal, tangent);
+							float weight = 0.0f;
+
+							for (uint32_t i = 0; i < ENVIRONMENT_SAMPLES; i++) {
+
+								glm::vec3 half = sampleHalfVector(hammersley(i, ENVIRONMENT_SAMPLES), roughness, distribution);
+								glm::vec3 world_half = tangent * half.x + bitangent * half.y + normal * half.z;
+								glm::vec3 light = world_half * (2.0f * half.z) - normal;
+								float NdotL = glm::dot(normal, light);
+
+								if (NdotL <= 0.0f)
+									continue;
+
+								// Read from the level where a texel covers the solid angle of the sample.
+								float pdf = evaluateDistribution(half.z * half.z, roughness, distribution) * 0.25f;
+								float sample_angle = 1.0f / (ENVIRONMENT_SAMPLES * pdf + 1e-6f);
+								float lod = std::max(0.5f * std::log2(sample_angle / texel_angle) + 1.0f, base_lod);
+
+								color = color + samplePyramid(pyramid, source_width, light, lod) * NdotL;
+								weight += NdotL;
+
+							}
+
+							color = color / std::max(weight, 1e-6f);
+
+						}
+
+						for (int c = 0; c < 3; c++)
+							pixels[(y * width + x) * 3 + c] = color[c];
+
+					}
+
+				}
+
+			});
+
+		}
+
+	}
+
+	void Environment::projectIrradiance(const std::vector<float>& pixels, int width, EnvironmentData* data) {
+
+		int height = width / 2;
+		glm::vec3 coefficients[9];
+
+		for (int i = 0; i < 9; i++)
+			coefficients[i] = glm::vec3(0.0f);
+
+		// Project the radiance, weighting each texel by its solid angle.
+		for (int y = 0; y < height; y++) {
+
+			float theta = ((y + 0.5f) / height) * ENVIRONMENT_PI;
+			float solid_angle = (2.0f * ENVIRONMENT_PI / width) * (ENVIRONMENT_PI / height) * std::sin(theta);
+
+			for (int x = 0; x < width; x++) {
+
+				glm::vec3 d = texelDirection(x, y, width, height);
+				const float* p = &pixels[((size_t) y * width + x) * 3];
+				glm::vec3 color = glm::vec3(p[0], p[1], p[2]) * solid_angle;
+
+				float basis[9] = {
+					0.282095f,
+					0.488603f * d.y, 0.488603f * d.z, 0.488603f * d.x,
+					1.092548f * d.x * d.y, 1.092548f * d.y * d.z, 0.315392f * (3.0f * d.z * d.z - 1.0f),
+					1.092548f * d.x * d.z, 0.546274f * (d.x * d.x - d.y * d.y)
+				};
+
+				for (int i = 0; i < 9; i++)
+					coefficients[i] = coefficients[i] + color * basis[i];
+
+			}
+
+		}
+
+		// Convolve with the cosine lobe and divide by pi, so the shaders multiply by the albedo.
+		const float bands[9] = { 1.0f, 2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f };
+
+		for (int i = 0; i < 9; i++)
+			data->irradiance[i] = coefficients[i] * bands[i];
+
+	}
+
+	std::shared_ptr<EnvironmentData> Environment::readCache(const std::filesystem::path& path) {
+
+		std::ifstream file_stream(path, std::ios::binary);
+
+		if (!file_stream)
+			return nullptr;
+
+		// Only use caches written with the same settings.
+		char magic[8] = {};
+		int32_t header[6] = {};
+
+		file_stream.read(magic, 8);
+
+		for (int i = 0; i < 6; i++)
+			readValue(file_stream, &header[i]);
+
+		if (!file_stream || std::memcmp(magic, "A3DIBL\0\0", 8) != 0 || header[0] != ENVIRONMENT_CACHE_VERSION ||
+				header[1] != ENVIRONMENT_SOURCE_WIDTH || header[2] != ENVIRONMENT_SPECULAR_WIDTH || header[3] != ENVIRONMENT_SPECULAR_LEVELS ||
+				header[4] != ENVIRONMENT_SAMPLES || header[5] != ENVIRONMENT_LUT_SIZE)
+			return nullptr;
+
+		std::shared_ptr<EnvironmentData> data = std::make_shared<EnvironmentData>();
+		data->width = ENVIRONMENT_SPECULAR_WIDTH;
+
+		for (int i = 0; i < 9; i++)
+			file_stream.read((char*) glm::value_ptr(data->irradiance[i]), 3 * sizeof(float));
+
+		std::vector<std::vector<float>>* levels[2] = { &data->beckmann, &data->ggx };
+
+		for (int d = 0; d < 2; d++) {
+
+			levels[d]->resize(ENVIRONMENT_SPECULAR_LEVELS);
+
+			for (int level = 0; level < ENVIRONMENT_SPECULAR_LEVELS; level++) {
+
+				int width = std::max(ENVIRONMENT_SPECULAR_WIDTH >> level, 1);
+				(*levels[d])[level].resize((size_t) width * std::max(width / 2, 1) * 3);
+				file_stream.read((char*) (*levels[d])[level].data(), (*levels[d])[level].size() * sizeof(float));
+
+			}
+
+		}
+
+		data->lut.resize((size_t) ENVIRONMENT_LUT_SIZE * ENVIRONMENT_LUT_SIZE * 4);
+		file_stream.read((char*) data->lut.data(), data->lut.size() * sizeof(float));
+
+		if (!file_stream) {
+
+			std::cerr << "Environment warning - The cache " << path.string() << " is truncated." << std::endl;
+			return nullptr;
+
+		}
+
+		return data;
+
+	}
+
+	bool Environment::writeCache(const std::filesystem::path& path, const EnvironmentData& data) {
+
+		// Write it into a temporary file and move it in place, so readers never see half a file.
+		std::string temporary_path = path.string() + ".tmp";
+		std::ofstream file_stream(temporary_path, std::ios::binary | std::ios::trunc);
+
+		if (!file_stream)
+			return false;
+
+		file_stream.write("A3DIBL\0\0", 8);
+		writeValue<int32_t>(file_stream, ENVIRONMENT_CACHE_VERSION);
+		writeValue<int32_t>(file_stream, ENVIRONMENT_SOURCE_WIDTH);
+		writeValue<int32_t>(file_stream, ENVIRONMENT_SPECULAR_WIDTH);
+		writeValue<int32_t>(file_stream, ENVIRONMENT_SPECULAR_LEVELS);
+		writeValue<int32_t>(file_stream, ENVIRONMENT_SAMPLES);
+		writeValue<int32_t>(file_stream, ENVIRONMENT_LUT_SIZE);
+
+		for (int i = 0; i < 9; i++)
+			file_stream.write((const char*) glm::value_ptr(data.irradiance[i]), 3 * sizeof(float));
+
+		for (size_t level = 0; level < data.beckmann.size(); level++)
+			file_stream.write((const char*) data.beckmann[level].data(), data.beckmann[level].size() * sizeof(float));
+
+		for (size_t level = 0; level < data.ggx.size(); level++)
+			file_stream.write((const char*) data.ggx[level].data(), data.ggx[level].size() * sizeof(float));
+
+		file_stream.write((const char*) data.lut.data(), data.lut.size() * sizeof(float));
+		file_stream.close();
+
+		if (!file_stream || std::rename(temporary_path.c_str(), path.string().c_str()) != 0) {
+
+			std::remove(temporary_path.c_str());
+			return false;
+
+		}
+
+		return true;
+
+	}
+
+} // namespace aladdin_3d
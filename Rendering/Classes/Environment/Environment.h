@@ -0,0 +1,205 @@
+/**
+ * @file Environment.h
+ * @brief Environment class header file.
+ * @version 1.0.0 (2023-02-27)
+ * @date 2023-02-27
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_ENVIRONMENT_H_
+#define ALADDIN_3D_CLASS_ENVIRONMENT_H_
+
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "GL/glew.h"
+#include "glm/glm.hpp"
+
+#include "Classes/Camera/Camera.h"
+#include "Classes/Shader/Shader.h"
+#include "Structs/EnvironmentData/EnvironmentData.h"
+
+#define ENVIRONMENT_SOURCE_WIDTH 512		/// Width the map is resampled to before filtering.
+#define ENVIRONMENT_SPECULAR_WIDTH 256		/// Width of the first specular level.
+#define ENVIRONMENT_SPECULAR_LEVELS 6		/// Specular levels, from smooth to fully rough.
+#define ENVIRONMENT_SAMPLES 128				/// Importance samples per specular texel.
+#define ENVIRONMENT_LUT_SIZE 64				/// Width and height of the split-sum lookup table.
+#define ENVIRONMENT_LUT_SAMPLES 256			/// Importance samples per lookup table texel.
+#define ENVIRONMENT_SPECULAR_UNIT 11		/// Texture unit of the specular levels.
+#define ENVIRONMENT_LUT_UNIT 12				/// Texture unit of the lookup table.
+#define ENVIRONMENT_CACHE_VERSION 1			/// Version of the cache files, bumped when the filtering changes.
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implements image-based lighting.
+	 *
+	 * Implements image-based lighting from an equirectangular HDR map. The map
+	 * is filtered on the CPU in a background job: the specular levels are
+	 * importance sampled with Beckmann and GGX, the irradiance is projected into
+	 * spherical harmonics and the split-sum lookup table is integrated. The
+	 * results are cached in a file next to the map, used while it is newer.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class Environment {
+
+		public:
+
+			/**
+			 * @brief Constructs an empty environment.
+			 *
+			 * Constructs an environment with no map.
+			 */
+			Environment();
+
+			/**
+			 * @brief Binds the environment to a shader.
+			 *
+			 * Binds the specular levels, the lookup table and the irradiance to the
+			 * active shader.
+			 *
+			 * @param shader The shader, already activated.
+			 * @param camera The camera the shader draws with, to rotate the view space
+			 * directions into the map.
+			 * @param distribution 0 for the Beckmann levels, 1 for the GGX ones.
+			 */
+			void bind(Shader& shader, Camera& camera, int distribution);
+
+			/**
+			 * @brief Checks if the environment is filtering.
+			 *
+			 * Checks if a map is still being filtered in the background.
+			 *
+			 * @returns Whether the map is being filtered.
+			 */
+			bool isFiltering();
+
+			/**
+			 * @brief Checks if the environment is ready.
+			 *
+			 * Checks if the filtered map is uploaded and can be bound.
+			 *
+			 * @returns Whether the environment is ready.
+			 */
+			bool isReady();
+
+			/**
+			 * @brief Loads a map.
+			 *
+			 * Starts reading the cache of an equirectangular HDR map, or filtering the
+			 * map if there is none, in the background.
+			 *
+			 * @param path Path to the map.
+			 */
+			void load(const std::string& path);
+
+			/**
+			 * @brief Uploads the map.
+			 *
+			 * Uploads the filtered map once the background job is done. Has to be
+			 * called from the thread with the GL context.
+			 */
+			void processUpload();
+
+			/**
+			 * @brief Removes the environment.
+			 *
+			 * Removes the textures from OpenGL.
+			 */
+			void remove();
+
+		private:
+
+			/**
+			 * @brief Filters a map.
+			 *
+			 * Reads an HDR map and filters it, in parallel.
+			 *
+			 * @param path Path to the map.
+			 *
+			 * @returns The filtered map, or nullptr if it could not be read.
+			 */
+			static std::shared_ptr<EnvironmentData> filter(const std::string& path);
+
+			/**
+			 * @brief Integrates the lookup table.
+			 *
+			 * Integrates the scale and bias of F0 for every view angle and roughness,
+			 * for both distributions.
+			 *
+			 * @param data Where the table is stored.
+			 */
+			static void integrateLUT(EnvironmentData* data);
+
+			/**
+			 * @brief Prefilters the specular levels.
+			 *
+			 * Prefilters the specular levels with a distribution, sampling lower
+			 * resolution levels of the source when the samples are sparse.
+			 *
+			 * @param pyramid The source, halved level by level.
+			 * @param source_width Width of the first level of the source.
+			 * @param distribution 0 for Beckmann, 1 for GGX.
+			 * @param levels Where the levels are stored.
+			 */
+			static void prefilter(const std::vector<std::vector<float>>& pyramid, int source_width, int distribution, std::vector<std::vector<float>>* levels);
+
+			/**
+			 * @brief Projects the irradiance.
+			 *
+			 * Projects a map into the first 9 spherical harmonics and convolves them
+			 * with the cosine lobe.
+			 *
+			 * @param pixels The map, RGB.
+			 * @param width Width of the map, twice its height.
+			 * @param data Where the coefficients are stored.
+			 */
+			static void projectIrradiance(const std::vector<float>& pixels, int width, EnvironmentData* data);
+
+			/**
+			 * @brief Reads a cache file.
+			 *
+			 * Reads a cache file, only if it was written with the current settings.
+			 *
+			 * @param path Path to the cache.
+			 *
+			 * @returns The filtered map, or nullptr if the cache is not valid.
+			 */
+			static std::shared_ptr<EnvironmentData> readCache(const std::filesystem::path& path);
+
+			/**
+			 * @brief Writes a cache file.
+			 *
+			 * Writes a filtered map, through a temporary file so a cache is never
+			 * left half written.
+			 *
+			 * @param path Path to the cache.
+			 * @param data The filtered map.
+			 *
+			 * @returns Whether the cache could be written.
+			 */
+			static bool writeCache(const std::filesystem::path& path, const EnvironmentData& data);
+
+			std::future<std::shared_ptr<EnvironmentData>> pending;	/// Background job filtering the map.
+			GLuint beckmann_texture = 0;							/// Specular levels filtered with Beckmann.
+			GLuint ggx_texture = 0;									/// Specular levels filtered with GGX.
+			GLuint lut_texture = 0;									/// Split-sum lookup table of both distributions.
+			glm::vec3 irradiance[9];								/// Irradiance over pi in spherical harmonics.
+			bool ready = false;										/// Whether the textures are uploaded.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_ENVIRONMENT_H_
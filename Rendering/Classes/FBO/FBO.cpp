@@ -0,0 +1,189 @@
+/**
+ * @file FBO.cpp
+ * @brief FBO class implementation file.
+ * @version 1.0.0 (2023-02-24)
+ * @date 2023-02-24
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "FBO.h"
+
+#include <iostream>
+#include <vector>
+
+#include "GL/glew.h"
+
+namespace aladdin_3d {
+
+	FBO::FBO() {}
+
+	FBO::FBO(int width, int height, const std::vector<GLenum>& formats, bool depth) {
+
+		// Store the layout and build it.
+		this->width = width;
+		this->height = height;
+		this->formats = formats;
+		this->depth = depth;
+
+		this->create();
+
+	}
+
+	void FBO::bind() {
+
+		// Remember where it was drawing, it may not be the window.
+		glGetIntegerv(GL_FRAMEBUFFER_BINDING, &this->previous);
+		glGetIntegerv(GL_VIEWPORT, this->viewport);
+
+		// Bind the FBO and draw in all of it.
+		glBindFramebuffer(GL_FRAMEBUFFER, this->ID);
+		glViewport(0, 0, this->width, this->height);
+
+	}
+
+	GLuint FBO::getTexture(size_t index) {
+
+		return index < this->textures.size() ? this->textures[index] : 0;
+
+	}
+
+	GLuint FBO::getDepthTexture() {
+
+		return this->depth_texture;
+
+	}
+
+	GLuint FBO::getID() {
+
+		return this->ID;
+
+	}
+
+	int FBO::getWidth() {
+
+		return this->width;
+
+	}
+
+	int FBO::getHeight() {
+
+		return this->height;
+
+	}
+
+	void FBO::remove() {
+
+		// Delete the textures and the framebuffer.
+		if (!this->textures.empty())
+			glDeleteTextures((GLsizei) this->textures.size(), this->textures.data());
+
+		if (this->depth_texture != 0)
+			glDeleteTextures(1, &this->depth_texture);
+
+		if (this->ID != 0)
+			glDeleteFramebuffers(1, &this->ID);
+
+		this->textures.clear();
+		this->depth_texture = 0;
+		this->ID = 0;
+
+	}
+
+	void FBO::resize(int width, int height) {
+
+		if (width == this->width && height == this->height && this->ID != 0)
+			return;
+
+		// Build everything again with the new size.
+		this->remove();
+		this->width = width;
+		this->height = height;
+		this->create();
+
+	}
+
+	void FBO::unbind() {
+
+		// Go back to where it was drawing before.
+		glBindFramebuffer(GL_FRAMEBUFFER, this->previous);
+		glViewport(this->viewport[0], this->viewport[1], this->viewport[2], this->viewport[3]);
+
+	}
+
+	void FBO::create() {
+
+		// It may be rebuilt while another target is bound, so leave the bindings as they were.
+		GLint bound_framebuffer = 0;
+		GLint bound_texture = 0;
+		glGetIntegerv(GL_FRAMEBUFFER_BINDING, &bound_framebuffer);
+		glGetIntegerv(GL_TEXTURE_BINDING_2D, &bound_texture);
+
+		glGenFramebuffers(1, &this->ID);
+		glBindFramebuffer(GL_FRAMEBUFFER, this->ID);
+
+		// One texture per color attachment. They are read texel by texel, so no filtering.
+		this->textures.resize(this->formats.size());
+		std::vector<GLenum> draw_buffers;
+
+		if (!this->formats.empty())
+			glGenTextures((GLsizei) this->formats.size(), this->textures.data());
+
+		for (size_t i = 0; i < this->formats.size(); i++) {
+
+			bool is_float = this->formats[i] == GL_RGBA16F || this->formats[i] == GL_RGBA32F || this->formats[i] == GL_R32F;
+
+			glBindTexture(GL_TEXTURE_2D, this->textures[i]);
+			glTexImage2D(GL_TEXTURE_2D, 0, this->formats[i], this->width, this->height, 0, GL_RGBA, is_float ? GL_FLOAT : GL_UNSIGNED_BYTE, NULL);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + (GLenum) i, GL_TEXTURE_2D, this->textures[i], 0);
+			draw_buffers.push_back(GL_COLOR_ATTACHMENT0 + (GLenum) i);
+
+		}
+
+		// Write every attachment, or none for depth only targets.
+		if (draw_buffers.empty()) {
+
+			glDrawBuffer(GL_NONE);
+			glReadBuffer(GL_NONE);
+
+		} else {
+
+			glDrawBuffers((GLsizei) draw_buffers.size(), draw_buffers.data());
+
+		}
+
+		// The depth is a texture too, so it can be sampled.
+		if (this->depth) {
+
+			glGenTextures(1, &this->depth_texture);
+			glBindTexture(GL_TEXTURE_2D, this->depth_texture);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, this->width, this->height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, this->depth_texture, 0);
+
+		}
+
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			std::cerr << "FBO error - The framebuffer is not complete." << std::endl;
+
+		glBindTexture(GL_TEXTURE_2D, bound_texture);
+		glBindFramebuffer(GL_FRAMEBUFFER, bound_framebuffer);
+
+	}
+
+} // namespace aladdin_3d
@@ -0,0 +1,162 @@
+/**
+ * @file FBO.h
+ * @brief FBO class header file.
+ * @version 1.0.0 (2023-02-24)
+ * @date 2023-02-24
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_FBO_H_
+#define ALADDIN_3D_CLASS_FBO_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "GL/glew.h"
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implementation of a FBO class.
+	 *
+	 * Implementation of a FBO class that renders into textures, one per color
+	 * attachment plus an optional depth texture, so later passes can sample them.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class FBO {
+
+		public:
+
+			/**
+			 * @brief Constructs an empty Framebuffer Object.
+			 *
+			 * Constructs a Framebuffer Object with nothing in OpenGL yet.
+			 */
+			FBO();
+
+			/**
+			 * @brief Constructs a Framebuffer Object.
+			 *
+			 * Constructs a Framebuffer Object with a texture for each of the color
+			 * formats, written by the fragment outputs in the same order.
+			 *
+			 * @param width Width in pixels.
+			 * @param height Height in pixels.
+			 * @param formats Internal format of each color attachment.
+			 * @param depth Whether to add a depth texture.
+			 */
+			FBO(int width, int height, const std::vector<GLenum>& formats, bool depth = true);
+
+			/**
+			 * @brief Binds the FBO.
+			 *
+			 * Binds the FBO in the GL pipe and sets the viewport to its size,
+			 * remembering the framebuffer and viewport it replaces.
+			 */
+			void bind();
+
+			/**
+			 * @brief Gets a color texture.
+			 *
+			 * Gets the texture of a color attachment.
+			 *
+			 * @param index Index of the attachment.
+			 *
+			 * @returns The OpenGL ID of the texture.
+			 */
+			GLuint getTexture(size_t index);
+
+			/**
+			 * @brief Gets the depth texture.
+			 *
+			 * Gets the depth texture, 0 if there is none.
+			 *
+			 * @returns The OpenGL ID of the texture.
+			 */
+			GLuint getDepthTexture();
+
+			/**
+			 * @brief Gets the ID.
+			 *
+			 * Gets the OpenGL ID of the framebuffer, to blit from or into it.
+			 *
+			 * @returns The OpenGL ID of the FBO.
+			 */
+			GLuint getID();
+
+			/**
+			 * @brief Gets the width.
+			 *
+			 * Gets the width in pixels.
+			 *
+			 * @returns The width.
+			 */
+			int getWidth();
+
+			/**
+			 * @brief Gets the height.
+			 *
+			 * Gets the height in pixels.
+			 *
+			 * @returns The height.
+			 */
+			int getHeight();
+
+			/**
+			 * @brief Removes the FBO.
+			 *
+			 * Removes the FBO and its textures from OpenGL.
+			 */
+			void remove();
+
+			/**
+			 * @brief Resizes the FBO.
+			 *
+			 * Rebuilds the textures with a new size, if it changed.
+			 *
+			 * @param width Width in pixels.
+			 * @param height Height in pixels.
+			 */
+			void resize(int width, int height);
+
+			/**
+			 * @brief Unbinds the FBO.
+			 *
+			 * Unbinds the FBO in the GL pipe, going back to the framebuffer and
+			 * viewport that were in use when it was bound.
+			 */
+			void unbind();
+
+		private:
+
+			/**
+			 * @brief Creates the FBO.
+			 *
+			 * Creates the framebuffer and its textures in OpenGL, keeping the
+			 * framebuffer and texture that were bound.
+			 */
+			void create();
+
+			GLuint ID = 0;					/// GL ID of the FBO.
+			std::vector<GLenum> formats;	/// Internal format of each color attachment.
+			std::vector<GLuint> textures;	/// Texture of each color attachment.
+			GLuint depth_texture = 0;		/// Depth texture, 0 if none.
+			bool depth = true;				/// Whether there is a depth texture.
+			int width = 0;					/// Width in pixels.
+			int height = 0;					/// Height in pixels.
+			GLint previous = 0;				/// Framebuffer bound before this one.
+			GLint viewport[4] = {};			/// Viewport before this one was bound.
+
+	};
+
+}  // namespace aladdin_3d
+
+#endif //!ALADDIN_3D_CLASS_FBO_H_
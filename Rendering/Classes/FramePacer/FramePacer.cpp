@@ -0,0 +1,127 @@
+/**
+ * @file FramePacer.cpp
+ * @brief FramePacer class implementation file.
+ * @version 1.0.0 (2023-03-02)
+ * @date 2023-03-02
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "FramePacer.h"
+
+#include <iostream>
+#include <thread>
+
+#include "GLFW/glfw3.h"
+
+namespace aladdin_3d {
+
+	FramePacer::FramePacer() {
+
+		this->deadline = std::chrono::steady_clock::now();
+
+	}
+
+	bool FramePacer::isAdaptiveSupported() {
+
+		return glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear");
+
+	}
+
+	bool FramePacer::nextFrame(bool animating) {
+
+		if (animating)
+			this->settle = FRAME_PACER_SETTLE_FRAMES;
+
+		if (this->settle <= 0)
+			return false;
+
+		this->settle--;
+		return true;
+
+	}
+
+	void FramePacer::requestFrames() {
+
+		this->settle = FRAME_PACER_SETTLE_FRAMES;
+
+	}
+
+	void FramePacer::setLimit(double fps) {
+
+		std::chrono::steady_clock::duration period{};
+
+		if (fps > 0.0)
+			period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / fps));
+
+		// Start counting again from now when the limit changes.
+		if (period != this->period) {
+
+			this->period = period;
+			this->deadline = std::chrono::steady_clock::now();
+
+		}
+
+	}
+
+	void FramePacer::setSwapMode(int mode) {
+
+		if (mode == this->swap_mode)
+			return;
+
+		this->swap_mode = mode;
+
+		// A negative interval lets late frames tear instead of waiting for the next blank.
+		if (mode == SWAP_ADAPTIVE && FramePacer::isAdaptiveSupported()) {
+
+			glfwSwapInterval(-1);
+
+		} else if (mode == SWAP_ADAPTIVE) {
+
+			std::cerr << "FramePacer warning - Adaptive sync is not supported, using vsync." << std::endl;
+			glfwSwapInterval(1);
+
+		} else {
+
+			glfwSwapInterval(mode == SWAP_VSYNC ? 1 : 0);
+
+		}
+
+	}
+
+	void FramePacer::wait() {
+
+		if (this->period == std::chrono::steady_clock::duration::zero())
+			return;
+
+		// The next deadline is one period after the last one, so the error of a frame
+		// does not carry over. After a long frame start again from now.
+		auto now = std::chrono::steady_clock::now();
+		this->deadline += this->period;
+
+		if (this->deadline < now) {
+
+			this->deadline = now;
+			return;
+
+		}
+
+		// Sleep while there is plenty of time, the scheduler wakes up late.
+		auto spin = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(FRAME_PACER_SPIN_MS));
+
+		if (this->deadline - now > spin)
+			std::this_thread::sleep_for(this->deadline - now - spin);
+
+		// Spin the rest, giving the core away between checks.
+		while (std::chrono::steady_clock::now() < this->deadline)
+			std::this_thread::yield();
+
+	}
+
+} // namespace aladdin_3d
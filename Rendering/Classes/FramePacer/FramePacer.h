@@ -0,0 +1,119 @@
+/**
+ * @file FramePacer.h
+ * @brief FramePacer class header file.
+ * @version 1.0.0 (2023-03-02)
+ * @date 2023-03-02
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_FRAMEPACER_H_
+#define ALADDIN_3D_CLASS_FRAMEPACER_H_
+
+#include <chrono>
+
+#define FRAME_PACER_SPIN_MS 2.0			/// Last part of each wait that is spun, since sleeps overshoot.
+#define FRAME_PACER_SETTLE_FRAMES 8		/// Frames drawn after the last change, for what reacts a few frames late.
+#define FRAME_PACER_IDLE_TIMEOUT 0.25	/// Seconds an idle wait lasts before looking at the background work again.
+
+#define SWAP_OFF 0			/// Swap as soon as the frame is done.
+#define SWAP_VSYNC 1		/// Swap on the vertical blank.
+#define SWAP_ADAPTIVE 2		/// Swap on the vertical blank, unless the frame is late.
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implements the pacing of the frames.
+	 *
+	 * Implements the pacing of the frames: the swap interval, a frame limiter that
+	 * sleeps most of the wait and spins the rest to hit its deadline, and the
+	 * bookkeeping that lets the main loop stop drawing while nothing changes.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class FramePacer {
+
+		public:
+
+			/**
+			 * @brief Constructs a pacer.
+			 *
+			 * Constructs a pacer with no limit, which draws the first frames.
+			 */
+			FramePacer();
+
+			/**
+			 * @brief Checks if adaptive sync is supported.
+			 *
+			 * Checks if the context can swap late frames without waiting. Needs a
+			 * current context.
+			 *
+			 * @returns Whether SWAP_ADAPTIVE can be used.
+			 */
+			static bool isAdaptiveSupported();
+
+			/**
+			 * @brief Decides whether to draw a frame.
+			 *
+			 * Decides whether the next frame has to be drawn. Frames are drawn while
+			 * something moves and for FRAME_PACER_SETTLE_FRAMES after it stops or
+			 * after requestFrames().
+			 *
+			 * @param animating Whether something is changing on its own.
+			 *
+			 * @returns Whether to draw.
+			 */
+			bool nextFrame(bool animating);
+
+			/**
+			 * @brief Requests new frames.
+			 *
+			 * Makes the next frames be drawn, after some input or change.
+			 */
+			void requestFrames();
+
+			/**
+			 * @brief Sets the frame limit.
+			 *
+			 * Sets the highest number of frames per second, 0 for no limit.
+			 *
+			 * @param fps Frames per second.
+			 */
+			void setLimit(double fps);
+
+			/**
+			 * @brief Sets the swap interval.
+			 *
+			 * Sets SWAP_OFF, SWAP_VSYNC or SWAP_ADAPTIVE, only telling the driver when
+			 * it changes. Adaptive sync falls back to vsync when it is not supported.
+			 *
+			 * @param mode The mode.
+			 */
+			void setSwapMode(int mode);
+
+			/**
+			 * @brief Waits for the next frame.
+			 *
+			 * Waits until the deadline of the next frame if there is a limit,
+			 * sleeping until FRAME_PACER_SPIN_MS before it and spinning the rest.
+			 */
+			void wait();
+
+		private:
+
+			std::chrono::steady_clock::time_point deadline;		/// When the next frame may start.
+			std::chrono::steady_clock::duration period{};			/// Time between frames, zero for no limit.
+			int settle = FRAME_PACER_SETTLE_FRAMES;					/// Frames still to draw after the last change.
+			int swap_mode = -1;										/// Swap mode given to the driver, -1 if none yet.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_FRAMEPACER_H_
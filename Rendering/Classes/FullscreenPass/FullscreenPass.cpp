@@ -0,0 +1,45 @@
+/**
+ * @file FullscreenPass.cpp
+ * @brief FullscreenPass class implementation file.
+ * @version 1.0.0 (2023-02-24)
+ * @date 2023-02-24
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "FullscreenPass.h"
+
+#include "GL/glew.h"
+
+namespace aladdin_3d {
+
+	GLuint FullscreenPass::vao = 0;
+
+	void FullscreenPass::draw() {
+
+		if (FullscreenPass::vao == 0)
+			glGenVertexArrays(1, &FullscreenPass::vao);
+
+		// The vertex shader places the three vertices from their IDs.
+		glBindVertexArray(FullscreenPass::vao);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		glBindVertexArray(0);
+
+	}
+
+	void FullscreenPass::remove() {
+
+		if (FullscreenPass::vao != 0)
+			glDeleteVertexArrays(1, &FullscreenPass::vao);
+
+		FullscreenPass::vao = 0;
+
+	}
+
+} // namespace aladdin_3d
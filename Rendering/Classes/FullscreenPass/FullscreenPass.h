@@ -0,0 +1,59 @@
+/**
+ * @file FullscreenPass.h
+ * @brief FullscreenPass class header file.
+ * @version 1.0.0 (2023-02-24)
+ * @date 2023-02-24
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_FULLSCREENPASS_H_
+#define ALADDIN_3D_CLASS_FULLSCREENPASS_H_
+
+#include "GL/glew.h"
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implements full-screen passes.
+	 *
+	 * Implements drawing a triangle that covers the whole viewport. Its vertices
+	 * come from gl_VertexID, so no buffer is needed, only an empty VAO as the
+	 * core profile asks for one.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class FullscreenPass {
+
+		public:
+
+			/**
+			 * @brief Draws the full-screen triangle.
+			 *
+			 * Draws the triangle with the active shader, creating the VAO the first
+			 * time.
+			 */
+			static void draw();
+
+			/**
+			 * @brief Removes the VAO.
+			 *
+			 * Removes the empty VAO from OpenGL.
+			 */
+			static void remove();
+
+		private:
+
+			static GLuint vao;	/// The empty VAO.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_FULLSCREENPASS_H_
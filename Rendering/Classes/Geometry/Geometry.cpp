@@ -3,10 +3,10 @@
  * @brief Geometry class implementation file.
  * @version 1.0.0 (2022-11-26)
  * @date 2022-11-26
- * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
  *
  *
- * Copyright (c) Borja Garca Quiroga, All Rights Reserved.
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
  *
  * The information and material provided below was developed as partial
  * requirements for the MSc in Computer Science at Trinity College Dublin,
@@ -15,6 +15,7 @@
 
 #include "Geometry.h"
 
+#include <algorithm>
 #include <vector>
 #include <stdexcept>
 
@@ -28,6 +29,8 @@
 #include "Classes/Shader/Shader.h"
 #include "Classes/Texture/Texture.h"
 #include "Classes/VAO/VAO.h"
+#include "Classes/VBO/VBO.h"
+#include "Structs/SweepInstance/SweepInstance.h"
 #include "Structs/Vertex/Vertex.h"
 #include "Structs/BoundingBox/BoundingBox.h"
 
@@ -55,8 +58,27 @@ namespace aladdin_3d {
 
 		vao.unbind();
 		vbo.unbind();
+
+		// A second VAO with the positions packed on their own, so depth passes fetch
+		// a third of the vertex data. It shares the indices.
+		std::vector<glm::vec3> positions(vertices.size());
+
+		for (size_t i = 0; i < vertices.size(); i++)
+			positions[i] = vertices[i].position;
+
+		this->position_vao.bind();
+		VBO position_vbo(positions.data(), (GLsizeiptr) (positions.size() * sizeof(glm::vec3)));
+		ebo.bind();
+
+		position_vao.link_attribute(position_vbo, 0, 3, GL_FLOAT, sizeof(glm::vec3), (void*)0);
+
+		position_vao.unbind();
+		position_vbo.unbind();
 		ebo.unbind();
 
+		// Cache the bounding box, it is needed every frame.
+		this->bounding_box = this->calculateBoundingBox();
+
 	}
 
 	std::vector<GLuint> Geometry::getIndices() {
@@ -95,14 +117,68 @@ namespace aladdin_3d {
         
     }
 
-	void Geometry::draw(Shader &shader, Camera &camera) {
+	void Geometry::draw(Shader &shader, Camera &camera, const glm::mat4 &model) {
+
+		// Pass everything to the shader.
+		this->prepareDraw(shader, camera, model);
+
+		// Draw the actual Geometry
+		glDrawElements(GL_TRIANGLES, (GLsizei) indices.size(), GL_UNSIGNED_INT, 0);
+
+	}
+
+	void Geometry::drawDepth(Shader &shader, Camera &camera, const glm::mat4 &model) {
+
+		// Activate the positions and the shader to access the uniforms.
+		shader.activate();
+		position_vao.bind();
+
+		// Pass the same matrices the shading pass gets, so the depth matches exactly.
+		glUniformMatrix4fv(glGetUniformLocation(shader.getProgramID(), "Model"), 1, GL_FALSE, glm::value_ptr(model));
+		glUniformMatrix4fv(glGetUniformLocation(shader.getProgramID(), "View"), 1, GL_FALSE, glm::value_ptr(camera.getView()));
+		glUniformMatrix4fv(glGetUniformLocation(shader.getProgramID(), "Projection"), 1, GL_FALSE, glm::value_ptr(camera.getProjection()));
+
+		// Draw the depth only.
+		glDrawElements(GL_TRIANGLES, (GLsizei) indices.size(), GL_UNSIGNED_INT, 0);
+
+	}
+
+	void Geometry::drawInstanced(Shader &shader, Camera &camera, VBO &instances, GLsizei count, const glm::mat4 &model) {
+
+		// Pass everything to the shader.
+		this->prepareDraw(shader, camera, model);
+
+		// Link the per-instance placement and parameters, only once per buffer.
+		if (this->instance_buffer != instances.getID()) {
+
+			vao.link_instance_attribute(instances, 5, 4, GL_FLOAT, sizeof(aladdin_3d::SweepInstance), (void*)0);
+			vao.link_instance_attribute(instances, 6, 2, GL_FLOAT, sizeof(aladdin_3d::SweepInstance), (void*)(4 * sizeof(float)));
+			this->instance_buffer = instances.getID();
+
+		}
+
+		// Draw every instance at once.
+		glDrawElementsInstanced(GL_TRIANGLES, (GLsizei) indices.size(), GL_UNSIGNED_INT, 0, count);
+
+	}
+
+	void Geometry::prepareDraw(Shader &shader, Camera &camera, const glm::mat4 &model) {
 
 		// Activate the VAO and the shader to access the uniforms.
 		shader.activate();
 		vao.bind();
 
+		// Tell the textures how big this geometry is on screen, using a sphere
+		// around the bounding box, so the levels needed get streamed in.
+		glm::vec3 centre = glm::vec3(model * glm::vec4((this->bounding_box.min + this->bounding_box.max) * 0.5f, 1.0f));
+		float scale = std::max(glm::length(glm::vec3(model[0])), std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+		float radius = glm::length(this->bounding_box.max - this->bounding_box.min) * 0.5f * scale;
+		float pixels = camera.getProjectedSize(centre, radius);
+
 		for (size_t i = 0; i < textures.size(); i++) {
 
+			textures[i].requestSize(pixels);
+
 			std::string name = textures[i].getName();
 			std::string id = "";
 			
@@ -117,29 +193,32 @@ namespace aladdin_3d {
         // Pass the shininess to the shader.
         shader.passFloat("materialShininess", this->shininess);
         
-		// Get the model matrix and pass it.
-		glm::mat4 model = this->transforms;
+		// Pass the model matrix.
 		glUniformMatrix4fv(glGetUniformLocation(shader.getProgramID(), "Model"), 1, GL_FALSE, glm::value_ptr(model));
 
-		// Get the View matrix and compute the modelView;
-		glm::mat4 view = camera.getView();
-		glm::mat4 model_view = view * model;
-		glUniformMatrix4fv(glGetUniformLocation(shader.getProgramID(), "modelView"), 1, GL_FALSE, glm::value_ptr(model_view));
+		// The normal matrix comes from the block the scene graph bound.
 
-		// Get the normal matrix and pass it.
-		glm::mat4 normal_matrix = glm::transpose(glm::inverse(model_view));
-		glUniformMatrix4fv(glGetUniformLocation(shader.getProgramID(), "normalMatrix"), 1, GL_FALSE, glm::value_ptr(normal_matrix));
+	}
 
-		// Draw the actual Geometry
-		glDrawElements(GL_TRIANGLES, (GLsizei) indices.size(), GL_UNSIGNED_INT, 0);
+	BoundingBox Geometry::getBoundingBox() {
+
+		return this->bounding_box;
 
 	}
 
-	BoundingBox Geometry::getBoundingBox() {
+	BoundingBox Geometry::calculateBoundingBox() {
 
 		// Create the bb.
 		BoundingBox bb;
 
+		if (this->vertices.empty()) {
+
+			bb.min = glm::vec3(0.0f);
+			bb.max = glm::vec3(0.0f);
+			return bb;
+
+		}
+
 		// Init the bounding box with the first vertex.
 		bb.min = glm::vec3(this->vertices[0].position.x, this->vertices[0].position.y, this->vertices[0].position.z);
 		bb.max = glm::vec3(this->vertices[0].position.x, this->vertices[0].position.y, this->vertices[0].position.z);
@@ -171,43 +250,4 @@ namespace aladdin_3d {
 
 	}
 
-	void Geometry::resetTransforms() {
-
-		this->transforms = glm::mat4(1.0f);
-
-	}
-
-	void Geometry::rotate(float x, float y, float z, float angle) {
-
-		// Get the angle as radians.
-		float radians = glm::radians(angle);
-
-		// Create a rotation matrix.
-		glm::mat4 identity_matrix(1.0f);
-		glm::mat4 rotation_matrix = glm::rotate(identity_matrix, radians, glm::vec3(x, y, z));
-
-		this->transforms *= rotation_matrix;
-
-	}
-
-	void Geometry::scale(float x, float y, float z) {
-
-		// Create the scale matrix.
-		glm::mat4 identity_matrix(1.0f);
-		glm::mat4 scale_matrix = glm::scale(identity_matrix, glm::vec3(x, y, z));
-
-		this->transforms *= scale_matrix;
-
-	}
-
-	void Geometry::translate(float x, float y, float z) {
-
-		// Get the translation matrix.
-		glm::mat4 trans_matrix = glm::translate(glm::mat4(1.0), glm::vec3(x, y, z));
-
-		// Apply it to the transormations.
-		this->transforms *= trans_matrix;
-
-	}
-
 }  // namespace aladdin_3d
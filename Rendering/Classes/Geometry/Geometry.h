@@ -3,10 +3,10 @@
  * @brief Geometry class header file.
  * @version 1.0.0 (2022-11-26)
  * @date 2022-11-26
- * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
  *
  *
- * Copyright (c) Borja Garca Quiroga, All Rights Reserved.
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
  *
  * The information and material provided below was developed as partial
  * requirements for the MSc in Computer Science at Trinity College Dublin,
@@ -39,7 +39,7 @@ namespace aladdin_3d {
 	* Implementation of a Geometry class that will allow us to handle the geometric part
 	* of the objects in the VBOs.
 	*
-	* @author Borja Garca Quiroga <garcaqub@tcd.ie>
+	* @author Borja García Quiroga <garcaqub@tcd.ie>
 	*/
 	class Geometry {
 
@@ -101,74 +101,82 @@ namespace aladdin_3d {
 			/**
 			 * @brief Draws the Geometry.
 			 *
-			 * Displays the Geometry in OpenGL.
-			 */
-			void draw(Shader &shader, Camera &camera);
-
-			/**
-			 * @brief Gets the bounding box.
-			 * 
-			 * Gets the bounding box of the geometry.
-			 * 
-			 * @returns The bounding box struct.
+			 * Displays the Geometry in OpenGL, with the model matrix of the node that
+			 * places it. Its model-view and normal matrices have to be bound already.
+			 *
+			 * @param shader The shader.
+			 * @param camera The camera.
+			 * @param model The model matrix.
 			 */
-			BoundingBox getBoundingBox();
+			void draw(Shader &shader, Camera &camera, const glm::mat4 &model);
 
 			/**
-			 * @brief Reset
+			 * @brief Draws the depth of the Geometry.
+			 *
+			 * Draws the Geometry from a VAO with only the positions, for a depth
+			 * pre-pass. Only the matrices are passed to the shader.
 			 *
-			 * Add a translation matrix to the model.
+			 * @param shader The depth shader.
+			 * @param camera The camera.
+			 * @param model The model matrix.
 			 */
-			void resetTransforms();
+			void drawDepth(Shader &shader, Camera &camera, const glm::mat4 &model);
 
 			/**
-			 * @brief Add a translation matrix to the model.
+			 * @brief Draws many instances of the Geometry.
 			 *
-			 * Add a translation matrix to the model.
+			 * Displays many instances of the Geometry in a single draw call, each
+			 * one with its own attributes from the instance buffer. The attributes
+			 * are only linked the first time a buffer is drawn with, so it has to
+			 * keep its ID while its data changes.
 			 *
-			 * @param x The x rotation.
-			 * @param y The y rotation.
-			 * @param z The z rotation.
-			 * @param angle The angle to rotate.
+			 * @param shader The shader, built with instancing.
+			 * @param camera The camera.
+			 * @param instances VBO with one SweepInstance per instance.
+			 * @param count The number of instances.
+			 * @param model The model matrix.
 			 */
-			void rotate(float x, float y, float z, float angle);
+			void drawInstanced(Shader &shader, Camera &camera, VBO &instances, GLsizei count, const glm::mat4 &model);
 
 			/**
-			 * @brief Add a translation matrix to the model.
-			 *
-			 * Add a translation matrix to the model.
-			 *
-			 * @param x The x scale.
-			 * @param y The y scale.
-			 * @param z The z scale.
+			 * @brief Gets the bounding box.
+			 * 
+			 * Gets the bounding box of the geometry.
+			 * 
+			 * @returns The bounding box struct.
 			 */
-			void scale(float x, float y, float z);
+			BoundingBox getBoundingBox();
+
+		private:
 
 			/**
-			 * @brief Add a translation matrix to the model.
+			 * @brief Calculates the bounding box.
 			 *
-			 * Add a translation matrix to the model.
+			 * Calculates the bounding box of the vertices.
 			 *
-			 * @param x The x translation.
-			 * @param y The y translation.
-			 * @param z The z translation.
+			 * @returns The bounding box struct.
 			 */
-			void translate(float x, float y, float z);
-
-		private:
+			BoundingBox calculateBoundingBox();
 
 			/**
-			 * @brief Updates the normal matrix.
-			 * 
-			 * Updates the normal matrix so it can be passed to the shader.
+			 * @brief Prepares a draw.
+			 *
+			 * Activates the VAO and the shader, and passes the textures, the camera
+			 * and the model matrix to the shader.
+			 *
+			 * @param shader The shader.
+			 * @param camera The camera.
+			 * @param model The model matrix.
 			 */
-			void updateNormalMatrix();
+			void prepareDraw(Shader &shader, Camera &camera, const glm::mat4 &model);
 
 			std::vector<GLuint> indices;				/// Indices of the vertices.
 			std::vector<Texture> textures;				/// Textures that will color this geometry.
 			VAO vao;									/// VAO containing this object.
+			VAO position_vao;							/// VAO with only the positions, for depth passes.
 			std::vector<Vertex> vertices;				/// Geometry vertices.
-			glm::mat4 transforms = glm::mat4(1.0f);		/// Tranform matrixes that will be passed to the shader.
+			BoundingBox bounding_box;					/// Bounding box of the vertices.
+			GLuint instance_buffer = 0;					/// Instance buffer linked in the VAO, 0 for none.
             float shininess = 1.0;
 
 	};
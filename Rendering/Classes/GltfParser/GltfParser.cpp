@@ -0,0 +1,375 @@
+/**
+ * @file GltfParser.cpp
+ * @brief GltfParser class implementation file.
+ * @version 1.0.0 (2023-03-04)
+ * @date 2023-03-04
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "GltfParser.h"
+
+#include <iostream>
+#include <utility>
+
+namespace aladdin_3d {
+
+	// Gets an element of an array of the document, growing it if needed.
+	template <typename T>
+	static T& element(std::vector<T>& elements, size_t index) {
+
+		if (elements.size() <= index)
+			elements.resize(index + 1);
+
+		return elements[index];
+
+	}
+
+	// Number of components of a glTF accessor type, 0 if it is not known.
+	static unsigned int typeComponents(const std::string& type) {
+
+		if (type == "SCALAR") return 1;
+		else if (type == "VEC2") return 2;
+		else if (type == "VEC3") return 3;
+		else if (type == "VEC4") return 4;
+		else return 0;
+
+	}
+
+	GltfParser::GltfParser(GltfDocument& document) : document(document) {}
+
+	bool GltfParser::parse(const std::string& text, GltfDocument& document) {
+
+		document = GltfDocument();
+
+		GltfParser parser(document);
+		return nlohmann::json::sax_parse(text, &parser);
+
+	}
+
+	bool GltfParser::null() {
+
+		this->endValue();
+		return true;
+
+	}
+
+	bool GltfParser::boolean(bool value) {
+
+		this->storeBoolean(value);
+		this->endValue();
+		return true;
+
+	}
+
+	bool GltfParser::number_integer(number_integer_t value) {
+
+		this->storeNumber((double) value);
+		this->endValue();
+		return true;
+
+	}
+
+	bool GltfParser::number_unsigned(number_unsigned_t value) {
+
+		this->storeNumber((double) value);
+		this->endValue();
+		return true;
+
+	}
+
+	bool GltfParser::number_float(number_float_t value, [[maybe_unused]] const string_t& text) {
+
+		this->storeNumber(value);
+		this->endValue();
+		return true;
+
+	}
+
+	bool GltfParser::string(string_t& value) {
+
+		this->storeString(value);
+		this->endValue();
+		return true;
+
+	}
+
+	bool GltfParser::binary([[maybe_unused]] binary_t& value) {
+
+		this->endValue();
+		return true;
+
+	}
+
+	bool GltfParser::start_object([[maybe_unused]] std::size_t elements) {
+
+		this->startElement();
+		this->path.push_back(Frame());
+		return true;
+
+	}
+
+	bool GltfParser::key(string_t& value) {
+
+		this->path.back().key = std::move(value);
+		return true;
+
+	}
+
+	bool GltfParser::end_object() {
+
+		this->path.pop_back();
+		this->endValue();
+		return true;
+
+	}
+
+	bool GltfParser::start_array([[maybe_unused]] std::size_t elements) {
+
+		Frame frame;
+		frame.array = true;
+
+		this->path.push_back(frame);
+		return true;
+
+	}
+
+	bool GltfParser::end_array() {
+
+		this->path.pop_back();
+		this->endValue();
+		return true;
+
+	}
+
+	bool GltfParser::parse_error([[maybe_unused]] std::size_t position, [[maybe_unused]] const std::string& last_token, const nlohmann::detail::exception& error) {
+
+		std::cerr << "GltfParser error - " << error.what() << std::endl;
+		return false;
+
+	}
+
+	void GltfParser::endValue() {
+
+		if (!this->path.empty() && this->path.back().array)
+			this->path.back().index++;
+
+	}
+
+	size_t GltfParser::index(size_t level) {
+
+		return this->path[level].index;
+
+	}
+
+	bool GltfParser::matches(std::initializer_list<const char*> pattern) {
+
+		if (pattern.size() != this->path.size())
+			return false;
+
+		size_t level = 0;
+
+		for (const char* part : pattern) {
+
+			const Frame& frame = this->path[level++];
+
+			if (frame.array != (part[0] == '#' && part[1] == '\0'))
+				return false;
+
+			if (!frame.array && frame.key != part)
+				return false;
+
+		}
+
+		return true;
+
+	}
+
+	void GltfParser::startElement() {
+
+		if (this->path.size() < 2)
+			return;
+
+		const std::string& root = this->path[0].key;
+
+		if (root == "nodes" && this->matches({ "nodes", "#" }))
+			element(this->document.nodes, this->index(1));
+		else if (root == "meshes" && this->matches({ "meshes", "#" }))
+			element(this->document.meshes, this->index(1));
+		else if (root == "meshes" && this->matches({ "meshes", "#", "primitives", "#" }))
+			element(element(this->document.meshes, this->index(1)).primitives, this->index(3));
+		else if (root == "accessors" && this->matches({ "accessors", "#" }))
+			element(this->document.accessors, this->index(1));
+		else if (root == "bufferViews" && this->matches({ "bufferViews", "#" }))
+			element(this->document.buffer_views, this->index(1));
+		else if (root == "bufferViews" && this->matches({ "bufferViews", "#", "extensions", "EXT_meshopt_compression" }))
+			element(this->document.buffer_views, this->index(1)).compressed = true;
+		else if (root == "buffers" && this->matches({ "buffers", "#" }))
+			element(this->document.buffers, this->index(1));
+		else if (root == "materials" && this->matches({ "materials", "#" }))
+			element(this->document.materials, this->index(1));
+		else if (root == "textures" && this->matches({ "textures", "#" }))
+			element(this->document.texture_sources, this->index(1)) = -1;
+		else if (root == "scenes" && this->matches({ "scenes", "#" }))
+			element(this->document.scenes, this->index(1));
+
+	}
+
+	void GltfParser::storeBoolean(bool value) {
+
+		if (this->matches({ "accessors", "#", "normalized" }))
+			element(this->document.accessors, this->index(1)).normalized = value;
+
+	}
+
+	void GltfParser::storeNumber(double value) {
+
+		if (this->path.empty())
+			return;
+
+		const std::string& root = this->path[0].key;
+
+		if (root == "scene" && this->matches({ "scene" })) {
+
+			this->document.scene = (int) value;
+
+		} else if (root == "scenes") {
+
+			if (this->matches({ "scenes", "#", "nodes", "#" }))
+				element(this->document.scenes, this->index(1)).push_back((unsigned int) value);
+
+		} else if (root == "nodes" && this->path.size() >= 3) {
+
+			GltfNode& node = element(this->document.nodes, this->index(1));
+			const std::string& member = this->path[2].key;
+
+			if (this->path.size() == 3 && member == "mesh") {
+
+				node.mesh = (int) value;
+
+			} else if (this->path.size() == 4 && this->path[3].array) {
+
+				size_t component = this->index(3);
+
+				if (member == "children") node.children.push_back((unsigned int) value);
+				else if (member == "translation" && component < 3) node.translation[(int) component] = (float) value;
+				else if (member == "rotation" && component < 4) node.rotation[component] = (float) value;
+				else if (member == "scale" && component < 3) node.scale[(int) component] = (float) value;
+				else if (member == "matrix" && component < 16) { node.matrix[component] = (float) value; node.has_matrix = true; }
+
+			}
+
+		} else if (root == "meshes" && this->path.size() >= 5 && this->path[2].key == "primitives" && !this->path.back().array) {
+
+			GltfPrimitive& primitive = element(element(this->document.meshes, this->index(1)).primitives, this->index(3));
+			const std::string& member = this->path.back().key;
+
+			if (this->path.size() == 5) {
+
+				if (member == "indices") primitive.indices = (int) value;
+				else if (member == "mode") primitive.mode = (int) value;
+
+			} else if (this->path.size() == 6 && this->path[4].key == "attributes") {
+
+				if (member == "POSITION") primitive.position = (int) value;
+				else if (member == "NORMAL") primitive.normal = (int) value;
+				else if (member == "TEXCOORD_0") primitive.texcoord = (int) value;
+
+			}
+
+		} else if (root == "accessors" && this->path.size() >= 3 && !this->path.back().array) {
+
+			GltfAccessor& accessor = element(this->document.accessors, this->index(1));
+			const std::string& member = this->path.back().key;
+
+			if (this->path.size() == 3) {
+
+				if (member == "bufferView") accessor.buffer_view = (int) value;
+				else if (member == "byteOffset") accessor.byte_offset = (size_t) value;
+				else if (member == "componentType") accessor.component_type = (unsigned int) value;
+				else if (member == "count") accessor.count = (size_t) value;
+
+			} else if (this->path.size() == 4 && this->path[2].key == "sparse") {
+
+				if (member == "count") accessor.sparse_count = (size_t) value;
+
+			} else if (this->path.size() == 5 && this->path[2].key == "sparse" && this->path[3].key == "indices") {
+
+				if (member == "bufferView") accessor.sparse_indices_view = (int) value;
+				else if (member == "byteOffset") accessor.sparse_indices_offset = (size_t) value;
+				else if (member == "componentType") accessor.sparse_indices_type = (unsigned int) value;
+
+			} else if (this->path.size() == 5 && this->path[2].key == "sparse" && this->path[3].key == "values") {
+
+				if (member == "bufferView") accessor.sparse_values_view = (int) value;
+				else if (member == "byteOffset") accessor.sparse_values_offset = (size_t) value;
+
+			}
+
+		} else if (root == "bufferViews" && this->path.size() >= 3 && !this->path.back().array) {
+
+			GltfBufferView& view = element(this->document.buffer_views, this->index(1));
+			const std::string& member = this->path.back().key;
+
+			if (this->path.size() == 3) {
+
+				if (member == "buffer") view.buffer = (int) value;
+				else if (member == "byteOffset") view.byte_offset = (size_t) value;
+				else if (member == "byteLength") view.byte_length = (size_t) value;
+				else if (member == "byteStride") view.byte_stride = (size_t) value;
+
+			} else if (this->path.size() == 5 && this->path[2].key == "extensions" && this->path[3].key == "EXT_meshopt_compression") {
+
+				if (member == "buffer") view.compressed_buffer = (int) value;
+				else if (member == "byteOffset") view.compressed_offset = (size_t) value;
+				else if (member == "byteLength") view.compressed_length = (size_t) value;
+				else if (member == "byteStride") view.compressed_stride = (size_t) value;
+				else if (member == "count") view.compressed_count = (size_t) value;
+
+			}
+
+		} else if (root == "materials") {
+
+			if (this->matches({ "materials", "#", "pbrMetallicRoughness", "baseColorTexture", "index" }))
+				element(this->document.materials, this->index(1)).base_color_texture = (int) value;
+
+		} else if (root == "textures") {
+
+			if (this->matches({ "textures", "#", "source" }))
+				element(this->document.texture_sources, this->index(1)) = (int) value;
+
+		}
+
+	}
+
+	void GltfParser::storeString(std::string& value) {
+
+		if (this->path.empty())
+			return;
+
+		const std::string& root = this->path[0].key;
+
+		if (root == "buffers" && this->matches({ "buffers", "#", "uri" }))
+			element(this->document.buffers, this->index(1)) = std::move(value);
+		else if (root == "images" && this->matches({ "images", "#", "uri" }))
+			element(this->document.images, this->index(1)) = std::move(value);
+		else if (root == "materials" && this->matches({ "materials", "#", "name" }))
+			element(this->document.materials, this->index(1)).name = std::move(value);
+		else if (root == "accessors" && this->matches({ "accessors", "#", "type" }))
+			element(this->document.accessors, this->index(1)).components = typeComponents(value);
+		else if (root == "extensionsRequired" && this->matches({ "extensionsRequired", "#" }))
+			this->document.extensions_required.push_back(std::move(value));
+		else if (root == "bufferViews" && this->matches({ "bufferViews", "#", "extensions", "EXT_meshopt_compression", "mode" }))
+			element(this->document.buffer_views, this->index(1)).compressed_mode = std::move(value);
+		else if (root == "bufferViews" && this->matches({ "bufferViews", "#", "extensions", "EXT_meshopt_compression", "filter" }))
+			element(this->document.buffer_views, this->index(1)).compressed_filter = std::move(value);
+
+	}
+
+} // namespace aladdin_3d
@@ -0,0 +1,168 @@
+/**
+ * @file GltfParser.h
+ * @brief GltfParser class header file.
+ * @version 1.0.0 (2023-03-04)
+ * @date 2023-03-04
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_GLTFPARSER_H_
+#define ALADDIN_3D_CLASS_GLTFPARSER_H_
+
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include "json/json.h"
+
+#include "Structs/GltfDocument/GltfDocument.h"
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implements a streaming glTF parser.
+	 *
+	 * Implements a SAX handler that reads the JSON of a glTF file event by event,
+	 * keeping only the path to the current value, and stores the values the
+	 * loader uses straight into a GltfDocument. No JSON tree is ever built, and
+	 * everything else in the file is skipped as it is read.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class GltfParser : public nlohmann::json_sax<nlohmann::json> {
+
+		public:
+
+			/**
+			 * @brief Parses a glTF file.
+			 *
+			 * Parses the JSON of a glTF file into a document.
+			 *
+			 * @param text The JSON text.
+			 * @param document Outputs the document.
+			 *
+			 * @returns Whether the JSON was valid.
+			 */
+			static bool parse(const std::string& text, GltfDocument& document);
+
+			// Events of the SAX interface, called by nlohmann::json::sax_parse.
+			bool null() override;
+			bool boolean(bool value) override;
+			bool number_integer(number_integer_t value) override;
+			bool number_unsigned(number_unsigned_t value) override;
+			bool number_float(number_float_t value, const string_t& text) override;
+			bool string(string_t& value) override;
+			bool binary(binary_t& value) override;
+			bool start_object(std::size_t elements) override;
+			bool key(string_t& value) override;
+			bool end_object() override;
+			bool start_array(std::size_t elements) override;
+			bool end_array() override;
+			bool parse_error(std::size_t position, const std::string& last_token, const nlohmann::detail::exception& error) override;
+
+		private:
+
+			/**
+			 * @brief A level of the current path.
+			 *
+			 * A level of the path to the current value: the key being read in an
+			 * object, or the index being read in an array.
+			 */
+			struct Frame {
+
+				bool array = false;		/// Whether the level is an array.
+				size_t index = 0;		/// Index of the current element, in arrays.
+				std::string key = "";	/// Key of the current member, in objects.
+
+			};
+
+			/**
+			 * @brief Builds a parser.
+			 *
+			 * Builds a parser that writes into a document.
+			 *
+			 * @param document The document.
+			 */
+			GltfParser(GltfDocument& document);
+
+			/**
+			 * @brief Moves past a value.
+			 *
+			 * Moves the current array, if there is one, to its next element.
+			 */
+			void endValue();
+
+			/**
+			 * @brief Gets an index of the path.
+			 *
+			 * Gets the index being read at a level of the path.
+			 *
+			 * @param level The level.
+			 *
+			 * @returns The index.
+			 */
+			size_t index(size_t level);
+
+			/**
+			 * @brief Checks the current path.
+			 *
+			 * Checks whether the path to the current value is the given one, where
+			 * "#" stands for any index of an array.
+			 *
+			 * @param pattern The keys and indices of the path.
+			 *
+			 * @returns Whether the path matches.
+			 */
+			bool matches(std::initializer_list<const char*> pattern);
+
+			/**
+			 * @brief Starts a container.
+			 *
+			 * Makes room in the document for the element an object stands for, so
+			 * elements without any known member keep their index.
+			 */
+			void startElement();
+
+			/**
+			 * @brief Stores a boolean.
+			 *
+			 * Stores a boolean value if the current path is one the loader uses.
+			 *
+			 * @param value The value.
+			 */
+			void storeBoolean(bool value);
+
+			/**
+			 * @brief Stores a number.
+			 *
+			 * Stores a number if the current path is one the loader uses.
+			 *
+			 * @param value The value.
+			 */
+			void storeNumber(double value);
+
+			/**
+			 * @brief Stores a string.
+			 *
+			 * Stores a string if the current path is one the loader uses.
+			 *
+			 * @param value The value.
+			 */
+			void storeString(std::string& value);
+
+			GltfDocument& document;			/// Document being filled.
+			std::vector<Frame> path;		/// Levels down to the current value.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_GLTFPARSER_H_
@@ -3,10 +3,10 @@
  * @brief Light class header file.
  * @version 1.0.0 (2022-10-27)
  * @date 2022-10-27
- * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
  *
  *
- * Copyright (c) Borja Garca Quiroga, All Rights Reserved.
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
  *
  * The information and material provided below was developed as partial
  * requirements for the MSc in Computer Science at Trinity College Dublin,
@@ -26,7 +26,7 @@ namespace aladdin_3d {
 	 *
 	 * Implementation of a Light class that will allow us light the scenes up.
 	 *
-	 * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
 	 */
 	class Light {
 
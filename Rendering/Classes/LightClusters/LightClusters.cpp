@@ -0,0 +1,397 @@
+/**
+ * @file LightClusters.cpp
+ * @brief LightClusters class implementation file.
+ * @version 1.0.0 (2023-02-25)
+ * @date 2023-02-25
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "LightClusters.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <random>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "Classes/ThreadPool/ThreadPool.h"
+
+#define CLUSTER_COUNT (CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z)
+#define CLUSTER_MASK_WORDS (CLUSTER_MAX_LIGHTS / 32)
+
+namespace aladdin_3d {
+
+	// Four clusters along a row are tested against a light at once.
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+	typedef float32x4_t Lanes;
+
+	static inline Lanes lanesLoad(const float* source) { return vld1q_f32(source); }
+	static inline Lanes lanesSet(float value) { return vdupq_n_f32(value); }
+	static inline Lanes lanesAxisDistance(Lanes minimum, Lanes maximum, Lanes point) {
+		Lanes distance = vaddq_f32(vmaxq_f32(vsubq_f32(minimum, point), vdupq_n_f32(0.0f)), vmaxq_f32(vsubq_f32(point, maximum), vdupq_n_f32(0.0f)));
+		return vmulq_f32(distance, distance);
+	}
+	static inline Lanes lanesAdd(Lanes a, Lanes b) { return vaddq_f32(a, b); }
+	static inline int lanesLessEqual(Lanes a, Lanes b) {
+		uint32x4_t mask = vcleq_f32(a, b);
+		return (vgetq_lane_u32(mask, 0) & 1) | (vgetq_lane_u32(mask, 1) & 2) | (vgetq_lane_u32(mask, 2) & 4) | (vgetq_lane_u32(mask, 3) & 8);
+	}
+
+#elif defined(__SSE2__)
+
+	typedef __m128 Lanes;
+
+	static inline Lanes lanesLoad(const float* source) { return _mm_loadu_ps(source); }
+	static inline Lanes lanesSet(float value) { return _mm_set1_ps(value); }
+	static inline Lanes lanesAxisDistance(Lanes minimum, Lanes maximum, Lanes point) {
+		Lanes distance = _mm_add_ps(_mm_max_ps(_mm_sub_ps(minimum, point), _mm_setzero_ps()), _mm_max_ps(_mm_sub_ps(point, maximum), _mm_setzero_ps()));
+		return _mm_mul_ps(distance, distance);
+	}
+	static inline Lanes lanesAdd(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+	static inline int lanesLessEqual(Lanes a, Lanes b) { return _mm_movemask_ps(_mm_cmple_ps(a, b)); }
+
+#else
+
+	struct Lanes { float v[4]; };
+
+	static inline Lanes lanesLoad(const float* source) { return Lanes{ { source[0], source[1], source[2], source[3] } }; }
+	static inline Lanes lanesSet(float value) { return Lanes{ { value, value, value, value } }; }
+	static inline Lanes lanesAxisDistance(Lanes minimum, Lanes maximum, Lanes point) {
+		for (int i = 0; i < 4; i++) {
+			float distance = std::max(minimum.v[i] - point.v[i], 0.0f) + std::max(point.v[i] - maximum.v[i], 0.0f);
+			minimum.v[i] = distance * distance;
+		}
+		return minimum;
+	}
+	static inline Lanes lanesAdd(Lanes a, Lanes b) { for (int i = 0; i < 4; i++) a.v[i] += b.v[i]; return a; }
+	static inline int lanesLessEqual(Lanes a, Lanes b) { int mask = 0; for (int i = 0; i < 4; i++) mask |= (a.v[i] <= b.v[i]) << i; return mask; }
+
+#endif
+
+	static_assert(CLUSTER_GRID_X % 4 == 0, "The clusters of a row are tested four at a time.");
+	static_assert(CLUSTER_MAX_LIGHTS % 32 == 0, "The lights of a cluster are stored in 32 bit words.");
+
+	LightClusters::LightClusters() {}
+
+	void LightClusters::bind(Shader& shader) {
+
+		if (this->light_buffer == 0)
+			return;
+
+		GLuint program = shader.getProgramID();
+
+		// The light list.
+		GLuint block = glGetUniformBlockIndex(program, "PointLights");
+
+		if (block != GL_INVALID_INDEX)
+			glUniformBlockBinding(program, block, CLUSTER_LIGHTS_BINDING);
+
+		glBindBufferBase(GL_UNIFORM_BUFFER, CLUSTER_LIGHTS_BINDING, this->light_buffer);
+
+		// The cluster table and the light indices.
+		glActiveTexture(GL_TEXTURE0 + CLUSTER_TABLE_UNIT);
+		glBindTexture(GL_TEXTURE_BUFFER, this->table_texture);
+		glActiveTexture(GL_TEXTURE0 + CLUSTER_INDEX_UNIT);
+		glBindTexture(GL_TEXTURE_BUFFER, this->index_texture);
+		glActiveTexture(GL_TEXTURE0);
+
+		shader.passInt("clusterTable", CLUSTER_TABLE_UNIT);
+		shader.passInt("clusterLights", CLUSTER_INDEX_UNIT);
+
+		// How to find the cluster of a fragment in this viewport.
+		GLint viewport[4] = { 0, 0, 1, 1 };
+		glGetIntegerv(GL_VIEWPORT, viewport);
+
+		glUniform3i(glGetUniformLocation(program, "clusterGrid"), CLUSTER_GRID_X, CLUSTER_GRID_Y, CLUSTER_GRID_Z);
+		glUniform2f(glGetUniformLocation(program, "clusterDepth"), this->slice_scale, this->slice_bias);
+		glUniform4f(glGetUniformLocation(program, "clusterViewport"), (float) viewport[0], (float) viewport[1], (float) viewport[2], (float) viewport[3]);
+
+	}
+
+	size_t LightClusters::getIndexCount() {
+
+		return this->indices.size();
+
+	}
+
+	size_t LightClusters::getLightCount() {
+
+		return this->lights.size();
+
+	}
+
+	void LightClusters::remove() {
+
+		glDeleteBuffers(1, &this->light_buffer);
+		glDeleteBuffers(1, &this->table_buffer);
+		glDeleteBuffers(1, &this->index_buffer);
+		glDeleteTextures(1, &this->table_texture);
+		glDeleteTextures(1, &this->index_texture);
+
+		this->light_buffer = this->table_buffer = this->index_buffer = 0;
+		this->table_texture = this->index_texture = 0;
+
+	}
+
+	void LightClusters::setLights(const std::vector<PointLight>& lights) {
+
+		this->lights.assign(lights.begin(), lights.begin() + std::min<size_t>(lights.size(), CLUSTER_MAX_LIGHTS));
+
+	}
+
+	void LightClusters::update(Camera& camera) {
+
+		// Rebuild the cluster bounds when the projection changes.
+		glm::mat4 projection = camera.getProjection();
+
+		if (projection != this->grid_projection || camera.getNear() != this->near || camera.getFar() != this->far)
+			this->buildGrid(projection, camera.getNear(), camera.getFar());
+
+		// Move the lights to view space, laid out as the uniform block.
+		glm::mat4 view = camera.getView();
+		std::vector<glm::vec4> view_lights(this->lights.size());
+		std::vector<glm::vec4> block(2 * CLUSTER_MAX_LIGHTS, glm::vec4(0.0f));
+
+		for (size_t i = 0; i < this->lights.size(); i++) {
+
+			glm::vec3 position = glm::vec3(view * glm::vec4(this->lights[i].position, 1.0f));
+			view_lights[i] = glm::vec4(position, this->lights[i].radius);
+
+			block[i] = view_lights[i];
+			block[CLUSTER_MAX_LIGHTS + i] = glm::vec4(this->lights[i].color, this->lights[i].intensity);
+
+		}
+
+		// Assign them, each slice on its own so no two threads write the same cluster.
+		// The pool only makes this wait for its own slices, never for the decodes
+		// queued in it, and a few lights are quicker to assign here.
+		std::fill(this->masks.begin(), this->masks.end(), 0u);
+
+		if (this->lights.size() < CLUSTER_PARALLEL_LIGHTS)
+			this->assign(view_lights, 0, CLUSTER_GRID_Z);
+		else
+			ThreadPool::getShared().parallelFor(CLUSTER_GRID_Z, [this, &view_lights](size_t first, size_t last) {
+				this->assign(view_lights, first, last);
+			});
+
+		// Turn the bits into the list of each cluster.
+		this->indices.clear();
+
+		for (size_t cluster = 0; cluster < CLUSTER_COUNT; cluster++) {
+
+			this->table[2 * cluster] = (GLuint) this->indices.size();
+
+			for (size_t word = 0; word < CLUSTER_MASK_WORDS; word++) {
+
+				uint32_t bits = this->masks[cluster * CLUSTER_MASK_WORDS + word];
+
+				while (bits != 0) {
+
+					this->indices.push_back((GLuint) (word * 32 + std::countr_zero(bits)));
+					bits &= bits - 1;
+
+				}
+
+			}
+
+			this->table[2 * cluster + 1] = (GLuint) this->indices.size() - this->table[2 * cluster];
+
+		}
+
+		// A buffer texture cannot be empty.
+		if (this->indices.empty())
+			this->indices.push_back(0);
+
+		// Create the buffers the first time.
+		if (this->light_buffer == 0) {
+
+			glGenBuffers(1, &this->light_buffer);
+			glGenBuffers(1, &this->table_buffer);
+			glGenBuffers(1, &this->index_buffer);
+			glGenTextures(1, &this->table_texture);
+			glGenTextures(1, &this->index_texture);
+
+		}
+
+		// Upload everything, replacing the whole stores so the draws in flight are not waited for.
+		glBindBuffer(GL_UNIFORM_BUFFER, this->light_buffer);
+		glBufferData(GL_UNIFORM_BUFFER, block.size() * sizeof(glm::vec4), block.data(), GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+		glBindBuffer(GL_TEXTURE_BUFFER, this->table_buffer);
+		glBufferData(GL_TEXTURE_BUFFER, this->table.size() * sizeof(GLuint), this->table.data(), GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_TEXTURE_BUFFER, this->index_buffer);
+		glBufferData(GL_TEXTURE_BUFFER, this->indices.size() * sizeof(GLuint), this->indices.data(), GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+		glBindTexture(GL_TEXTURE_BUFFER, this->table_texture);
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32UI, this->table_buffer);
+		glBindTexture(GL_TEXTURE_BUFFER, this->index_texture);
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, this->index_buffer);
+		glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+	}
+
+	std::vector<PointLight> LightClusters::buildRig(size_t count, unsigned int seed) {
+
+		std::mt19937 generator(seed);
+		std::uniform_real_distribution<float> horizontal(-1.2f, 1.2f);
+		std::uniform_real_distribution<float> vertical(-0.6f, 0.9f);
+		std::uniform_real_distribution<float> channel(0.2f, 1.0f);
+		std::uniform_real_distribution<float> reach(0.4f, 1.0f);
+
+		std::vector<PointLight> lights(count);
+
+		for (size_t i = 0; i < count; i++) {
+
+			lights[i].position = glm::vec3(horizontal(generator), vertical(generator), horizontal(generator));
+			lights[i].radius = reach(generator);
+			lights[i].color = glm::vec3(channel(generator), channel(generator), channel(generator));
+			lights[i].intensity = 1.0f;
+
+		}
+
+		return lights;
+
+	}
+
+	void LightClusters::buildGrid(const glm::mat4& projection, float near, float far) {
+
+		this->grid_projection = projection;
+		this->near = near;
+		this->far = far;
+
+		// Slices are spaced exponentially up to CLUSTER_MAX_DEPTH, and the last one
+		// reaches the far plane.
+		float max_depth = std::max(std::min(far, CLUSTER_MAX_DEPTH), near * 2.0f);
+		this->slice_scale = CLUSTER_GRID_Z / std::log(max_depth / near);
+		this->slice_bias = -CLUSTER_GRID_Z * std::log(near) / std::log(max_depth / near);
+
+		this->min_x.resize(CLUSTER_COUNT);
+		this->min_y.resize(CLUSTER_COUNT);
+		this->min_z.resize(CLUSTER_COUNT);
+		this->max_x.resize(CLUSTER_COUNT);
+		this->max_y.resize(CLUSTER_COUNT);
+		this->max_z.resize(CLUSTER_COUNT);
+		this->masks.resize(CLUSTER_COUNT * CLUSTER_MASK_WORDS);
+		this->table.resize(2 * CLUSTER_COUNT);
+
+		for (int z = 0; z < CLUSTER_GRID_Z; z++) {
+
+			float depths[2] = {
+				near * std::pow(max_depth / near, (float) z / CLUSTER_GRID_Z),
+				z == CLUSTER_GRID_Z - 1 ? far : near * std::pow(max_depth / near, (float) (z + 1) / CLUSTER_GRID_Z)
+			};
+
+			for (int y = 0; y < CLUSTER_GRID_Y; y++) {
+
+				for (int x = 0; x < CLUSTER_GRID_X; x++) {
+
+					size_t cluster = ((size_t) z * CLUSTER_GRID_Y + y) * CLUSTER_GRID_X + x;
+					glm::vec3 minimum(INFINITY);
+					glm::vec3 maximum(-INFINITY);
+
+					// The corners of the tile at both depths, following the rays of a
+					// symmetric perspective projection.
+					for (int corner = 0; corner < 8; corner++) {
+
+						float ndc_x = -1.0f + 2.0f * (x + (corner & 1)) / CLUSTER_GRID_X;
+						float ndc_y = -1.0f + 2.0f * (y + ((corner >> 1) & 1)) / CLUSTER_GRID_Y;
+						float depth = depths[corner >> 2];
+
+						glm::vec3 point(ndc_x * depth / projection[0][0], ndc_y * depth / projection[1][1], -depth);
+						minimum = glm::min(minimum, point);
+						maximum = glm::max(maximum, point);
+
+					}
+
+					this->min_x[cluster] = minimum.x;
+					this->min_y[cluster] = minimum.y;
+					this->min_z[cluster] = minimum.z;
+					this->max_x[cluster] = maximum.x;
+					this->max_y[cluster] = maximum.y;
+					this->max_z[cluster] = maximum.z;
+
+				}
+
+			}
+
+		}
+
+	}
+
+	void LightClusters::assign(const std::vector<glm::vec4>& view_lights, size_t first_slice, size_t last_slice) {
+
+		for (size_t light = 0; light < view_lights.size(); light++) {
+
+			glm::vec4 sphere = view_lights[light];
+
+			// Skip the lights behind the camera, and only visit the slices in reach.
+			float nearest = -sphere.z - sphere.w;
+			float farthest = -sphere.z + sphere.w;
+
+			if (farthest < this->near || nearest > this->far)
+				continue;
+
+			size_t first = std::max<size_t>(first_slice, this->getSlice(std::max(nearest, this->near)));
+			size_t last = std::min<size_t>(last_slice, this->getSlice(farthest) + 1);
+
+			Lanes centre_x = lanesSet(sphere.x);
+			Lanes centre_y = lanesSet(sphere.y);
+			Lanes centre_z = lanesSet(sphere.z);
+			Lanes radius_squared = lanesSet(sphere.w * sphere.w);
+			uint32_t bit = 1u << (light % 32);
+			size_t word = light / 32;
+
+			for (size_t z = first; z < last; z++) {
+
+				for (size_t row = 0; row < CLUSTER_GRID_Y; row++) {
+
+					size_t row_start = (z * CLUSTER_GRID_Y + row) * CLUSTER_GRID_X;
+
+					for (size_t x = 0; x < CLUSTER_GRID_X; x += 4) {
+
+						// Squared distance from the centre to the boxes of four clusters.
+						size_t cluster = row_start + x;
+						Lanes distance = lanesAxisDistance(lanesLoad(&this->min_x[cluster]), lanesLoad(&this->max_x[cluster]), centre_x);
+						distance = lanesAdd(distance, lanesAxisDistance(lanesLoad(&this->min_y[cluster]), lanesLoad(&this->max_y[cluster]), centre_y));
+						distance = lanesAdd(distance, lanesAxisDistance(lanesLoad(&this->min_z[cluster]), lanesLoad(&this->max_z[cluster]), centre_z));
+
+						int touched = lanesLessEqual(distance, radius_squared);
+
+						for (int lane = 0; lane < 4; lane++)
+							if (touched & (1 << lane))
+								this->masks[(cluster + lane) * CLUSTER_MASK_WORDS + word] |= bit;
+
+					}
+
+				}
+
+			}
+
+		}
+
+	}
+
+	int LightClusters::getSlice(float depth) {
+
+		int slice = (int) std::floor(std::log(depth) * this->slice_scale + this->slice_bias);
+
+		return std::min(std::max(slice, 0), CLUSTER_GRID_Z - 1);
+
+	}
+
+} // namespace aladdin_3d
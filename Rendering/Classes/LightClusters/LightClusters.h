@@ -0,0 +1,193 @@
+/**
+ * @file LightClusters.h
+ * @brief LightClusters class header file.
+ * @version 1.0.0 (2023-02-25)
+ * @date 2023-02-25
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_LIGHTCLUSTERS_H_
+#define ALADDIN_3D_CLASS_LIGHTCLUSTERS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "GL/glew.h"
+#include "glm/glm.hpp"
+
+#include "Classes/Camera/Camera.h"
+#include "Classes/Shader/Shader.h"
+#include "Structs/PointLight/PointLight.h"
+
+#define CLUSTER_GRID_X 16			/// Clusters across the screen.
+#define CLUSTER_GRID_Y 9			/// Clusters down the screen.
+#define CLUSTER_GRID_Z 24			/// Depth slices, spaced exponentially.
+#define CLUSTER_MAX_DEPTH 50.0f		/// Depth where the last slice starts to reach the far plane.
+#define CLUSTER_MAX_LIGHTS 256		/// Size of the light list. Has to match MAX_POINT_LIGHTS in clustered.glsl.
+#define CLUSTER_LIGHTS_BINDING 1	/// Uniform buffer binding of the light list.
+#define CLUSTER_TABLE_UNIT 8		/// Texture unit of the cluster table.
+#define CLUSTER_INDEX_UNIT 9		/// Texture unit of the light indices.
+#define CLUSTER_PARALLEL_LIGHTS 32	/// Lights from which the slices are assigned in the pool.
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implements clustered forward lighting.
+	 *
+	 * Implements a light list in a uniform buffer and a grid of clusters over the
+	 * view frustum, each one listing the lights whose sphere touches it. The
+	 * fragment shaders find their cluster and only loop over those lights. The
+	 * lights are assigned on the CPU, testing four clusters at once with SIMD.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class LightClusters {
+
+		public:
+
+			/**
+			 * @brief Constructs the clusters.
+			 *
+			 * Constructs the clusters with no lights. Nothing is created in OpenGL
+			 * until they are updated.
+			 */
+			LightClusters();
+
+			/**
+			 * @brief Binds the clusters to a shader.
+			 *
+			 * Binds the light list, the cluster table and the light indices to the
+			 * active shader, for the current viewport.
+			 *
+			 * @param shader The shader, already activated.
+			 */
+			void bind(Shader& shader);
+
+			/**
+			 * @brief Gets the number of light indices.
+			 *
+			 * Gets the number of light indices in all the clusters, as a measure of
+			 * the lighting work.
+			 *
+			 * @returns The number of indices.
+			 */
+			size_t getIndexCount();
+
+			/**
+			 * @brief Gets the number of lights.
+			 *
+			 * Gets the number of lights.
+			 *
+			 * @returns The number of lights.
+			 */
+			size_t getLightCount();
+
+			/**
+			 * @brief Removes the clusters from OpenGL.
+			 *
+			 * Removes the buffers and textures from OpenGL.
+			 */
+			void remove();
+
+			/**
+			 * @brief Sets the lights.
+			 *
+			 * Sets the lights, keeping at most CLUSTER_MAX_LIGHTS.
+			 *
+			 * @param lights The lights in world coordinates.
+			 */
+			void setLights(const std::vector<PointLight>& lights);
+
+			/**
+			 * @brief Updates the clusters.
+			 *
+			 * Moves the lights to view space, assigns them to the clusters of the
+			 * camera frustum and uploads everything.
+			 *
+			 * @param camera The camera, already updated.
+			 */
+			void update(Camera& camera);
+
+			/**
+			 * @brief Builds a rig of lights.
+			 *
+			 * Builds lights of random colors and reach around the origin, where the
+			 * objects are drawn.
+			 *
+			 * @param count The number of lights.
+			 * @param seed Seed of the random generator, so the rig is repeatable.
+			 *
+			 * @returns The lights.
+			 */
+			static std::vector<PointLight> buildRig(size_t count, unsigned int seed);
+
+		private:
+
+			/**
+			 * @brief Builds the cluster bounds.
+			 *
+			 * Builds the view space bounding box of every cluster for a projection.
+			 *
+			 * @param projection The projection matrix.
+			 * @param near The near clipping limit.
+			 * @param far The far clipping limit.
+			 */
+			void buildGrid(const glm::mat4& projection, float near, float far);
+
+			/**
+			 * @brief Assigns the lights to some slices.
+			 *
+			 * Sets the bit of every light in the clusters of the given slices its
+			 * sphere touches.
+			 *
+			 * @param view_lights The lights in view space, as centre and radius.
+			 * @param first_slice First slice.
+			 * @param last_slice Last slice, exclusive.
+			 */
+			void assign(const std::vector<glm::vec4>& view_lights, size_t first_slice, size_t last_slice);
+
+			/**
+			 * @brief Gets the slice of a depth.
+			 *
+			 * Gets the slice a view space depth falls in.
+			 *
+			 * @param depth The depth, positive.
+			 *
+			 * @returns The slice.
+			 */
+			int getSlice(float depth);
+
+			std::vector<PointLight> lights;		/// Lights in world coordinates.
+			std::vector<float> min_x;			/// Minimum x of each cluster in view space.
+			std::vector<float> min_y;			/// Minimum y of each cluster in view space.
+			std::vector<float> min_z;			/// Minimum z of each cluster in view space.
+			std::vector<float> max_x;			/// Maximum x of each cluster in view space.
+			std::vector<float> max_y;			/// Maximum y of each cluster in view space.
+			std::vector<float> max_z;			/// Maximum z of each cluster in view space.
+			std::vector<uint32_t> masks;		/// One bit per light in each cluster.
+			std::vector<GLuint> table;			/// First index and count of each cluster.
+			std::vector<GLuint> indices;		/// Light indices of every cluster.
+			glm::mat4 grid_projection = glm::mat4(0.0f);	/// Projection the bounds were built for.
+			float near = 0.0f;					/// Near clipping limit of the grid.
+			float far = 0.0f;					/// Far clipping limit of the grid.
+			float slice_scale = 0.0f;			/// Scale from the log of the depth to the slice.
+			float slice_bias = 0.0f;			/// Bias from the log of the depth to the slice.
+			GLuint light_buffer = 0;			/// Uniform buffer with the lights.
+			GLuint table_buffer = 0;			/// Buffer of the cluster table.
+			GLuint table_texture = 0;			/// Buffer texture of the cluster table.
+			GLuint index_buffer = 0;			/// Buffer of the light indices.
+			GLuint index_texture = 0;			/// Buffer texture of the light indices.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_LIGHTCLUSTERS_H_
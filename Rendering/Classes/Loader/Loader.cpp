@@ -3,10 +3,10 @@
  * @brief Loader class implementation file.
  * @version 1.0.0 (2022-11-27)
  * @date 2022-11-27
- * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
  *
  *
- * Copyright (c) Borja Garca Quiroga, All Rights Reserved.
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
  *
  * The information and material provided below was developed as partial
  * requirements for the MSc in Computer Science at Trinity College Dublin,
@@ -26,6 +26,9 @@ namespace aladdin_3d {
 
 		this->filename = filename;
 
+		// Every node of the model hangs from the root of the object.
+		this->scene_graph.addNode(SceneNode());
+
 	}
 
     inline void Loader::loadModel() {}
@@ -3,10 +3,10 @@
  * @brief Loader class header file.
  * @version 1.0.0 (2022-11-27)
  * @date 2022-11-27
- * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
  *
  *
- * Copyright (c) Borja Garca Quiroga, All Rights Reserved.
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
  *
  * The information and material provided below was developed as partial
  * requirements for the MSc in Computer Science at Trinity College Dublin,
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "Classes/Geometry/Geometry.h"
+#include "Classes/SceneGraph/SceneGraph.h"
 
 namespace aladdin_3d {
 
@@ -28,7 +29,7 @@ namespace aladdin_3d {
 	 * 
 	 * Implements a loader class that will allow us to load models.
 	 * 
-	 * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
 	 */
 	class Loader {
 
@@ -44,7 +45,7 @@ namespace aladdin_3d {
 			/**
 			 * @brief Build a loader instance.
 			 * 
-			 * Build a loader instance.
+			 * Build a loader instance, with the root node of the object in its graph.
 			 */
 			Loader(const char *filename);
 
@@ -54,9 +55,9 @@ namespace aladdin_3d {
 			 * Get the geometries from the loaded model.
 			 *
 			 * @param geoms Outputs the geometries returned.
-			 * @param matrices Outputs the transformation matrices.
+			 * @param graph Outputs the nodes that place the geometries.
 			 */
-			virtual void getGeometries(std::vector<Geometry> *geoms, std::vector<glm::mat4> *matrices) = 0;
+			virtual void getGeometries(std::vector<Geometry> *geoms, SceneGraph *graph) = 0;
 
 			/**
 			 * @brief Loads the data from the file.
@@ -80,7 +81,7 @@ namespace aladdin_3d {
 
 			std::vector<Geometry> geometries;			/// The Geometries loaded by the model loader.
 			const char *filename;						/// Name of the file containing the model.
-			std::vector<glm::mat4> transform_matrixes;	/// Transform matrixes for each Geometry in the object.
+			SceneGraph scene_graph;						/// Nodes placing the Geometries, under the root of the object.
 
 	};
 
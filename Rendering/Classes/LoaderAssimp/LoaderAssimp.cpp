@@ -3,10 +3,10 @@
  * @brief Loader class implementation file using Assimp library.
  * @version 1.0.0 (2023-01-30)
  * @date 2023-01-30
- * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
  *
  *
- * Copyright (c) Borja Garca Quiroga, All Rights Reserved.
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
  *
  * The information and material provided below was developed as partial
  * requirements for the MSc in Computer Science at Trinity College Dublin,
@@ -26,6 +26,7 @@
 #include "assimp/scene.h"
 #include "assimp/postprocess.h"
 
+#include "Classes/ProfilerScope/ProfilerScope.h"
 #include "Structs/Vertex/Vertex.h"
 
 namespace aladdin_3d {
@@ -34,8 +35,15 @@ namespace aladdin_3d {
 
 	void LoaderAssimp::loadModel() {
         
+        ProfilerScope scope("LoaderAssimp::loadModel");
+        
         // Import the scene from the file.
-        const aiScene* scene = aiImportFile(filename, aiProcess_Triangulate | aiProcess_PreTransformVertices);
+        const aiScene* scene = nullptr;
+        
+        {
+            ProfilerScope import_scope("Assimp import");
+            scene = aiImportFile(filename, aiProcess_Triangulate | aiProcess_PreTransformVertices);
+        }
 
         // Check if the scene was not read correctly.
         if (!scene) {
@@ -58,10 +66,12 @@ namespace aladdin_3d {
             const aiMesh* mesh = scene->mMeshes[i];
             
             // Load this mesh.
+            ProfilerScope mesh_scope("Assimp mesh");
             loadGeometry(scene, mesh);
             
         }
 
+        ProfilerScope release_scope("Assimp release");
         aiReleaseImport(scene);
 
 	}
@@ -136,6 +146,12 @@ namespace aladdin_3d {
 		// Create a Geometry object that contains all this data.
 		this->geometries.push_back(aladdin_3d::Geometry(vertices, indices, textures, shine));
 
+		// The vertices are already transformed, so the node only hangs it from the root.
+		SceneNode node;
+		node.parent = 0;
+		node.geometry = (int) this->geometries.size() - 1;
+		this->scene_graph.addNode(node);
+
 	}
 
 	std::vector<aladdin_3d::Texture> LoaderAssimp::getTextures() {
@@ -147,10 +163,10 @@ namespace aladdin_3d {
 
 	}
 
-	void LoaderAssimp::getGeometries(std::vector<Geometry> *geoms, std::vector<glm::mat4> *matrices) {
+	void LoaderAssimp::getGeometries(std::vector<Geometry> *geoms, SceneGraph *graph) {
 
 		(*geoms) = this->geometries;
-		(*matrices) = this->transform_matrixes;
+		(*graph) = this->scene_graph;
 
 	}
 
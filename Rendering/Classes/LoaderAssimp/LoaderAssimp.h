@@ -3,10 +3,10 @@
  * @brief Loader GLTF class header file.
  * @version 1.0.0 (2022-11-27)
  * @date 2022-11-27
- * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
  *
  *
- * Copyright (c) Borja Garca Quiroga, All Rights Reserved.
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
  *
  * The information and material provided below was developed as partial
  * requirements for the MSc in Computer Science at Trinity College Dublin,
@@ -33,7 +33,7 @@ namespace aladdin_3d {
 	 *
 	 * Implements a loader class that will allow us to load GLTF models.
 	 *
-	 * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
 	 */
 	class LoaderAssimp : public Loader {
 
@@ -52,9 +52,9 @@ namespace aladdin_3d {
 			 * Get the geometries from the loaded model.
 			 * 
 			 * @param geoms Outputs the geometries returned.
-			 * @param matrices Outputs the transformation matrices.
+			 * @param graph Outputs the nodes that place the geometries.
 			 */
-			void getGeometries(std::vector<Geometry> *geoms, std::vector<glm::mat4> *matrices);
+			void getGeometries(std::vector<Geometry> *geoms, SceneGraph *graph);
 
 			/**
 			 * @brief Loads the data from the file.
@@ -3,7 +3,7 @@
  * @brief Loader class implementation file.
  * @version 1.0.0 (2022-11-27)
  * @date 2022-11-27
- * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
  * 
  * The code in this class has been partially based on the OpenGL Tutorials code.
  * The auxiliary functions have been grabbed from the repository below and belong to
@@ -11,7 +11,7 @@
  * @see https://github.com/VictorGordan/opengl-tutorials
  *
  *
- * Copyright (c) Borja Garca Quiroga, All Rights Reserved.
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
  *
  * The information and material provided below was developed as partial
  * requirements for the MSc in Computer Science at Trinity College Dublin,
@@ -21,231 +21,600 @@
 #include "LoaderGLTF.h"
 #include "Classes/Loader/Loader.h"
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 #include <iostream>
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include "glm/glm.hpp"
 #include "glm/gtc/type_ptr.hpp"
-#include "json/json.h"
+#include "glm/gtx/matrix_decompose.hpp"
+
+#include "Classes/GltfParser/GltfParser.h"
+#include "Classes/MeshoptDecoder/MeshoptDecoder.h"
+#include "Classes/ProfilerScope/ProfilerScope.h"
+#include "Classes/ThreadPool/ThreadPool.h"
 
 namespace aladdin_3d {
 
+	// Size in bytes of a glTF component type, 0 if it is not one.
+	static unsigned int componentSize(unsigned int component_type) {
+
+		switch (component_type) {
+			case 5120: case 5121: return 1;
+			case 5122: case 5123: return 2;
+			case 5125: case 5126: return 4;
+			default: return 0;
+		}
+
+	}
+
+	// Reads one component, mapping normalized integers to [0, 1] or [-1, 1].
+	static double readComponent(const unsigned char* data, unsigned int component_type, bool normalized) {
+
+		switch (component_type) {
+
+			case 5120: {
+				signed char value = (signed char) data[0];
+				return normalized ? std::max(value / 127.0, -1.0) : value;
+			}
+
+			case 5121:
+				return normalized ? data[0] / 255.0 : data[0];
+
+			case 5122: {
+				short value;
+				std::memcpy(&value, data, sizeof(short));
+				return normalized ? std::max(value / 32767.0, -1.0) : value;
+			}
+
+			case 5123: {
+				unsigned short value;
+				std::memcpy(&value, data, sizeof(unsigned short));
+				return normalized ? value / 65535.0 : value;
+			}
+
+			case 5125: {
+				unsigned int value;
+				std::memcpy(&value, data, sizeof(unsigned int));
+				return value;
+			}
+
+			default: {
+				float value;
+				std::memcpy(&value, data, sizeof(float));
+				return value;
+			}
+
+		}
+
+	}
+
 	LoaderGLTF::LoaderGLTF(const char* filename) : Loader(filename) {}
 
 	void LoaderGLTF::loadModel() {
-        
+
+		ProfilerScope scope("LoaderGLTF::loadModel");
+
 		// Parse the JSON contents of the file.
-		std::string text = Loader::readFileContents(filename);
-		this->json_file = nlohmann::json::parse(text);
+		{
+			ProfilerScope parse_scope("glTF parse");
+
+			// Only what the loader uses is kept, straight from the text.
+			std::string text = Loader::readFileContents(filename);
+
+			if (!GltfParser::parse(text, this->document)) {
+
+				std::cerr << "LoaderGLTF error - Could not parse " << filename << "." << std::endl;
+				return;
+
+			}
+		}
+
+		// Quantized attributes are read as any other accessor, and compressed views
+		// are decoded below. Anything else required may not look right.
+		for (const std::string& extension : this->document.extensions_required) {
+
+			if (extension != "KHR_mesh_quantization" && extension != "EXT_meshopt_compression")
+				std::cerr << "LoaderGLTF warning - The extension " << extension << " is not supported." << std::endl;
+
+		}
 
 		// Get the URI of the data file. That file contains the real info.
-		std::string bin_file = json_file["buffers"][0]["uri"];
+		if (this->document.buffers.empty()) {
+
+			std::cerr << "LoaderGLTF error - The file has no buffers." << std::endl;
+			return;
+
+		}
+
+		std::string bin_file = this->document.buffers[0];
 
 		// Substring the file name to get the directory path.
 		std::string filename_str(filename);
 		std::string file_dir_path = filename_str.substr(0, filename_str.find_last_of('/') + 1);
 
 		// Read the contents of the bin file in the directory.
-		std::string raw_bytes = Loader::readFileContents((file_dir_path + bin_file).c_str());
+		{
+			ProfilerScope buffer_scope("glTF buffers");
+
+			std::string raw_bytes = Loader::readFileContents((file_dir_path + bin_file).c_str());
+
+			// Transform the raw text data into bytes and put them in a vector
+			this->bin_data = std::vector<unsigned char>(raw_bytes.begin(), raw_bytes.end());
+		}
+
+		// Decode the compressed views, then build every mesh before placing them.
+		decodeCompressedViews();
+		loadGeometries();
+
+		// Now, iterate the nodes of the scene recursively, or the first node if there is none.
+		ProfilerScope node_scope("glTF nodes");
+		const std::vector<std::vector<unsigned int>>& scenes = this->document.scenes;
+		size_t scene = (size_t) this->document.scene;
+
+		if (scene < scenes.size() && !scenes[scene].empty()) {
 
-		// Transform the raw text data into bytes and put them in a vector
-		this->bin_data = std::vector<unsigned char>(raw_bytes.begin(), raw_bytes.end());
+			for (size_t i = 0; i < scenes[scene].size(); i++)
+				recursiveGetNode(scenes[scene][i]);
 
-		// Now, iterate the nodes in the file recursively.
-		recursiveGetNode(0);
+		} else if (!this->document.nodes.empty()) {
+
+			recursiveGetNode(0);
+
+		}
 
 	}
 
-	void LoaderGLTF::recursiveGetNode(unsigned int nextNode, glm::mat4 matrix) {
+	void LoaderGLTF::recursiveGetNode(unsigned int nextNode, int parent) {
+
+		if (nextNode >= this->document.nodes.size()) {
+
+			std::cerr << "LoaderGLTF error - Node " << nextNode << " does not exist." << std::endl;
+			return;
+
+		}
 
 		// Get the current node.
-		nlohmann::json node = json_file["nodes"][nextNode];
+		const GltfNode& node = this->document.nodes[nextNode];
 
 		// GLTF files can have transformations built in.
+		glm::vec3 translation = node.translation;
+		glm::vec3 scale = node.scale;
 
-		// Get the translation for each element.
-		glm::vec3 translation = glm::vec3(0.0f, 0.0f, 0.0f);
-		if (node.find("translation") != node.end())	
-			translation = glm::vec3(node["translation"][0], node["translation"][1], node["translation"][2]);
+		// Get the quaternion, stored as x, y, z and w in the file.
+		float rotValues[4] =
+		{
+			node.rotation[3],
+			node.rotation[0],
+			node.rotation[1],
+			node.rotation[2]
+		};
 
-		// Get quaternion if it exists
-		glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
-		if (node.find("rotation") != node.end())
+		glm::quat rotation = glm::make_quat(rotValues);
+
+		// Get matrix if it exists. glTF only allows matrices without shear, so it
+		// always splits back into a translation, a rotation and a scale.
+		if (node.has_matrix)
 		{
-			float rotValues[4] =
-			{
-				node["rotation"][3],
-				node["rotation"][0],
-				node["rotation"][1],
-				node["rotation"][2]
-			};
-
-			rotation = glm::make_quat(rotValues);
+			glm::vec3 skew;
+			glm::vec4 perspective;
+			glm::decompose(glm::make_mat4(node.matrix), scale, rotation, translation, skew, perspective);
 		}
 
-		// Get scale if it exists
-		glm::vec3 scale = glm::vec3(1.0f, 1.0f, 1.0f);
+		// Keep the transform in the node, so it can change later.
+		SceneNode scene_node;
+		scene_node.translation = translation;
+		scene_node.rotation = rotation;
+		scene_node.scale = scale;
+		scene_node.parent = parent;
 
-		if (node.find("scale") != node.end())
-			scale = glm::vec3(node["scale"][0], node["scale"][1], node["scale"][2]);
+		// Check if the node contains a mesh and if it does place its first primitive.
+		std::vector<int> primitives;
+
+		if (node.mesh >= 0)
+			primitives = this->mesh_geometries[(unsigned int) node.mesh];
+
+		if (!primitives.empty())
+			scene_node.geometry = primitives[0];
+
+		int index = this->scene_graph.addNode(scene_node);
+
+		// The rest of the primitives go in children with no transform of their own.
+		for (size_t i = 1; i < primitives.size(); i++) {
+
+			SceneNode primitive_node;
+			primitive_node.parent = index;
+			primitive_node.geometry = primitives[i];
+
+			this->scene_graph.addNode(primitive_node);
 
-		// Get matrix if it exists
-		glm::mat4 matNode = glm::mat4(1.0f);
-		if (node.find("matrix") != node.end())
-		{
-			float matValues[16];
-			for (unsigned int i = 0; i < node["matrix"].size(); i++)
-				matValues[i] = (node["matrix"][i]);
-			matNode = glm::make_mat4(matValues);
 		}
 
-		// Initialize matrices.
-		glm::mat4 trans = glm::mat4(1.0f);
-		glm::mat4 rot = glm::mat4(1.0f);
-		glm::mat4 sca = glm::mat4(1.0f);
+		// Check if the node has children, and if it does, apply this function to them under this node
+		for (size_t i = 0; i < node.children.size(); i++)
+			recursiveGetNode(node.children[i], index);
+
+	}
 
-		// Use translation, rotation, and scale to change the initialized matrices
-		trans = glm::translate(trans, translation);
-		rot = glm::mat4_cast(rotation);
-		sca = glm::scale(sca, scale);
+	std::vector<glm::vec3> LoaderGLTF::computeNormals(const std::vector<glm::vec3>& positions, const std::vector<GLuint>& indices) {
 
-		// Multiply all matrices together to obtain the final transform.
-		glm::mat4 transform_matrix = matrix * matNode * trans * rot * sca;
+		std::vector<glm::vec3> normals(positions.size(), glm::vec3(0.0f));
 
-		// Check if the node contains a mesh and if it does load it
-		if (node.find("mesh") != node.end()) {
+		// The cross product is as long as twice the area, so bigger triangles weigh more.
+		for (size_t i = 0; i + 2 < indices.size(); i += 3) {
 
-			this->transform_matrixes.push_back(transform_matrix);
+			glm::vec3 a = positions[indices[i]];
+			glm::vec3 b = positions[indices[i + 1]];
+			glm::vec3 c = positions[indices[i + 2]];
+			glm::vec3 normal = glm::cross(b - a, c - a);
 
-			loadGeometry(node["mesh"]);
+			normals[indices[i]] += normal;
+			normals[indices[i + 1]] += normal;
+			normals[indices[i + 2]] += normal;
 
 		}
 
-		// Check if the node has children, and if it does, apply this function to them with the matNextNode
-		if (node.find("children") != node.end()) {
+		for (size_t i = 0; i < normals.size(); i++) {
 
-			for (unsigned int i = 0; i < node["children"].size(); i++)
-				recursiveGetNode(node["children"][i], transform_matrix);
+			float length = glm::length(normals[i]);
+			normals[i] = length > 0.0f ? normals[i] / length : glm::vec3(0.0f, 1.0f, 0.0f);
 
 		}
 
+		return normals;
+
 	}
 
-	void LoaderGLTF::loadGeometry(unsigned int indMesh) {
-
-		// These indices will tell us what data to grab.
-		unsigned int posAccInd = this->json_file["meshes"][indMesh]["primitives"][0]["attributes"]["POSITION"];
-		unsigned int normalAccInd = this->json_file["meshes"][indMesh]["primitives"][0]["attributes"]["NORMAL"];
-		unsigned int texAccInd = this->json_file["meshes"][indMesh]["primitives"][0]["attributes"]["TEXCOORD_0"];
-		unsigned int indAccInd = this->json_file["meshes"][indMesh]["primitives"][0]["indices"];
-
-		// Get each type of information using the get functions.
-		std::vector<float> posVec = getFloats(this->json_file["accessors"][posAccInd]);
-		std::vector<glm::vec3> positions = groupFloatsVec3(posVec);
-		std::vector<float> normalVec = getFloats(this->json_file["accessors"][normalAccInd]);
-		std::vector<glm::vec3> normals = groupFloatsVec3(normalVec);
-		std::vector<float> texVec = getFloats(this->json_file["accessors"][texAccInd]);
-		std::vector<glm::vec2> texUVs = groupFloatsVec2(texVec);
-        
-		// Combine all that data into the vertices.
-		std::vector<aladdin_3d::Vertex> vertices = assembleVertices(positions, normals, texUVs);
+	void LoaderGLTF::decodeCompressedViews() {
 
-		// Grab the indices.
-		std::vector<GLuint> indices = getIndices(this->json_file["accessors"][indAccInd]);
+		std::vector<GltfBufferView>& views = this->document.buffer_views;
 
-		// Obtain the textures.
-		std::vector<aladdin_3d::Texture> textures = getTextures();
+		// Find the views with the extension.
+		std::vector<size_t> compressed;
 
-		// Create a Geometry object that contains all this data.
-		this->geometries.push_back(aladdin_3d::Geometry(vertices, indices, textures, 1.0));
+		for (size_t i = 0; i < views.size(); i++) {
+
+			if (views[i].compressed)
+				compressed.push_back(i);
+
+		}
+
+		if (compressed.empty())
+			return;
+
+		ProfilerScope scope("glTF meshopt");
+
+		// Decode them all in the pool. Each one writes its own slot.
+		std::vector<std::vector<unsigned char>> decoded(compressed.size());
+		std::vector<unsigned char> valid(compressed.size(), 0);
+
+		ThreadPool::getShared().parallelFor(compressed.size(), [this, &views, &compressed, &decoded, &valid](size_t first, size_t last) {
+
+			for (size_t i = first; i < last; i++) {
+
+				const GltfBufferView& view = views[compressed[i]];
+
+				// Only the first buffer is loaded.
+				if (view.compressed_buffer != 0 || view.compressed_offset + view.compressed_length > this->bin_data.size())
+					continue;
+
+				valid[i] = MeshoptDecoder::decode(&this->bin_data[view.compressed_offset], view.compressed_length, view.compressed_count,
+						view.compressed_stride, view.compressed_mode, view.compressed_filter, decoded[i]);
+
+			}
+
+		});
+
+		// Append the decoded data and point the views to it.
+		for (size_t i = 0; i < compressed.size(); i++) {
+
+			if (!valid[i]) {
+
+				std::cerr << "LoaderGLTF error - Could not decode the compressed buffer view " << compressed[i] << "." << std::endl;
+				continue;
+
+			}
+
+			GltfBufferView& view = views[compressed[i]];
+
+			if (view.compressed_mode == "ATTRIBUTES")
+				view.byte_stride = view.compressed_stride;
+
+			view.buffer = 0;
+			view.byte_offset = this->bin_data.size();
+			view.byte_length = decoded[i].size();
+			view.compressed = false;
+
+			this->bin_data.insert(this->bin_data.end(), decoded[i].begin(), decoded[i].end());
+
+		}
 
 	}
 
-	std::vector<float> LoaderGLTF::getFloats(nlohmann::json accessor) {
+	void LoaderGLTF::loadGeometries() {
 
-		std::vector<float> floatVec;
+		ProfilerScope scope("glTF geometries");
 
-		// Get properties from the accessor
-		unsigned int buffViewInd = accessor.value("bufferView", 1);
-		unsigned int count = accessor["count"];
-		unsigned int accByteOffset = accessor.value("byteOffset", 0);
-		std::string type = accessor["type"];
-
-		// Get properties from the bufferView
-		nlohmann::json bufferView = this->json_file["bufferViews"][buffViewInd];
-		unsigned int byteOffset = bufferView["byteOffset"];
-
-		// Interpret the type and store it into numPerVert
-		unsigned int numPerVert;
-		if (type == "SCALAR") numPerVert = 1;
-		else if (type == "VEC2") numPerVert = 2;
-		else if (type == "VEC3") numPerVert = 3;
-		else if (type == "VEC4") numPerVert = 4;
-		else throw std::invalid_argument("Type is invalid (not SCALAR, VEC2, VEC3, or VEC4)");
-
-		// Go over all the bytes in the data at the correct place using the properties from above
-		unsigned int beginningOfData = byteOffset + accByteOffset;
-		unsigned int lengthOfData = count * 4 * numPerVert;
-		for (unsigned int i = beginningOfData; i < beginningOfData + lengthOfData; i)
+		const std::vector<GltfMesh>& meshes = this->document.meshes;
+		const std::vector<GltfAccessor>& accessors = this->document.accessors;
+
+		// Find the meshes that some node uses.
+		std::vector<unsigned char> used(meshes.size(), 0);
+
+		for (const GltfNode& node : this->document.nodes) {
+
+			if (node.mesh >= 0 && (size_t) node.mesh < meshes.size())
+				used[node.mesh] = 1;
+
+		}
+
+		// Find the accessors of their primitives, each one only once.
+		std::vector<unsigned char> is_attribute(accessors.size(), 0);
+		std::vector<unsigned char> is_index(accessors.size(), 0);
+		std::vector<unsigned int> pending;
+
+		for (size_t mesh = 0; mesh < meshes.size(); mesh++) {
+
+			if (!used[mesh])
+				continue;
+
+			for (const GltfPrimitive& primitive : meshes[mesh].primitives) {
+
+				for (int accessor : { primitive.position, primitive.normal, primitive.texcoord }) {
+
+					if (accessor >= 0 && (size_t) accessor < accessors.size() && !is_attribute[accessor]) {
+
+						is_attribute[accessor] = 1;
+						pending.push_back(accessor);
+
+					}
+
+				}
+
+				if (primitive.indices >= 0 && (size_t) primitive.indices < accessors.size() && !is_index[primitive.indices]) {
+
+					is_index[primitive.indices] = 1;
+					pending.push_back(primitive.indices | 0x80000000u);
+
+				}
+
+			}
+
+		}
+
+		// Decode them all in the pool. Each one writes its own slot.
 		{
-			unsigned char bytes[] = { this->bin_data[i++], this->bin_data[i++], this->bin_data[i++], this->bin_data[i++] };
-			float value;
-			std::memcpy(&value, bytes, sizeof(float));
-			floatVec.push_back(value);
+			ProfilerScope decode_scope("glTF accessors");
+
+			this->accessor_floats.assign(accessors.size(), std::vector<float>());
+			this->accessor_indices.assign(accessors.size(), std::vector<GLuint>());
+
+			ThreadPool::getShared().parallelFor(pending.size(), [this, &pending, &accessors](size_t first, size_t last) {
+
+				for (size_t i = first; i < last; i++) {
+
+					unsigned int accessor = pending[i] & 0x7FFFFFFFu;
+
+					if (pending[i] & 0x80000000u)
+						this->accessor_indices[accessor] = getIndices(accessors[accessor]);
+					else
+						this->accessor_floats[accessor] = getFloats(accessors[accessor]);
+
+				}
+
+			});
+		}
+
+		// Build the geometries in this thread, as they need the context.
+		std::vector<aladdin_3d::Texture> textures = getTextures();
+
+		for (size_t mesh = 0; mesh < meshes.size(); mesh++) {
+
+			if (!used[mesh])
+				continue;
+
+			std::vector<int>& primitives = this->mesh_geometries[(unsigned int) mesh];
+
+			for (const GltfPrimitive& primitive : meshes[mesh].primitives) {
+
+				int geometry = loadPrimitive(primitive, textures);
+
+				if (geometry >= 0)
+					primitives.push_back(geometry);
+
+			}
+
 		}
 
-		return floatVec;
+		// The decoded data is in the geometries now.
+		this->accessor_floats.clear();
+		this->accessor_indices.clear();
+
 	}
 
-	std::vector<GLuint> LoaderGLTF::getIndices(nlohmann::json accessor) {
+	int LoaderGLTF::loadPrimitive(const GltfPrimitive& primitive, const std::vector<Texture>& textures) {
+
+		// Only triangle lists are drawn.
+		if (primitive.mode != 4) {
+
+			std::cerr << "LoaderGLTF warning - Skipping a primitive that is not made of triangles." << std::endl;
+			return -1;
+
+		}
+
+		// These indices will tell us what data to grab. Only the positions are needed.
+		size_t accessor_count = this->accessor_floats.size();
+
+		if (primitive.position < 0 || (size_t) primitive.position >= accessor_count) {
 
+			std::cerr << "LoaderGLTF warning - Skipping a primitive without positions." << std::endl;
+			return -1;
+
+		}
+
+		std::vector<glm::vec3> positions = groupFloatsVec3(this->accessor_floats[primitive.position]);
+
+		if (positions.empty())
+			return -1;
+
+		// Grab the indices, or draw the vertices in order.
 		std::vector<GLuint> indices;
 
-		// Get properties from the accessor
-		unsigned int buffViewInd = accessor.value("bufferView", 0);
-		unsigned int count = accessor["count"];
-		unsigned int accByteOffset = accessor.value("byteOffset", 0);
-		unsigned int componentType = accessor["componentType"];
-
-		// Get properties from the bufferView
-		nlohmann::json bufferView = this->json_file["bufferViews"][buffViewInd];
-		unsigned int byteOffset = bufferView["byteOffset"];
-
-		// Get indices with regards to their type: unsigned int, unsigned short, or short
-		unsigned int beginningOfData = byteOffset + accByteOffset;
-		if (componentType == 5125)
-		{
-			for (unsigned int i = beginningOfData; i < byteOffset + accByteOffset + count * 4; i)
-			{
-				unsigned char bytes[] = { this->bin_data[i++], this->bin_data[i++], this->bin_data[i++], this->bin_data[i++] };
-				unsigned int value;
-				std::memcpy(&value, bytes, sizeof(unsigned int));
-				indices.push_back((GLuint)value);
+		if (primitive.indices >= 0 && (size_t) primitive.indices < accessor_count) {
+
+			indices = this->accessor_indices[primitive.indices];
+
+		} else {
+
+			indices.resize(positions.size());
+
+			for (size_t i = 0; i < indices.size(); i++)
+				indices[i] = (GLuint) i;
+
+		}
+
+		for (size_t i = 0; i < indices.size(); i++) {
+
+			if (indices[i] >= positions.size()) {
+
+				std::cerr << "LoaderGLTF warning - Skipping a primitive with indices out of range." << std::endl;
+				return -1;
+
 			}
+
 		}
-		else if (componentType == 5123)
-		{
-			for (unsigned int i = beginningOfData; i < byteOffset + accByteOffset + count * 2; i)
-			{
-				unsigned char bytes[] = { this->bin_data[i++], this->bin_data[i++] };
-				unsigned short value;
-				std::memcpy(&value, bytes, sizeof(unsigned short));
-				indices.push_back((GLuint)value);
+
+		// Get the normals, or compute them if there are none.
+		std::vector<glm::vec3> normals;
+
+		if (primitive.normal >= 0 && (size_t) primitive.normal < accessor_count)
+			normals = groupFloatsVec3(this->accessor_floats[primitive.normal]);
+
+		if (normals.size() != positions.size())
+			normals = computeNormals(positions, indices);
+
+		// Get the texture coordinates, or leave them at zero if there are none.
+		std::vector<glm::vec2> texUVs;
+
+		if (primitive.texcoord >= 0 && (size_t) primitive.texcoord < accessor_count)
+			texUVs = groupFloatsVec2(this->accessor_floats[primitive.texcoord]);
+
+		if (texUVs.size() != positions.size())
+			texUVs.assign(positions.size(), glm::vec2(0.0f));
+
+		// Combine all that data into the vertices.
+		std::vector<aladdin_3d::Vertex> vertices = assembleVertices(positions, normals, texUVs);
+
+		// Create a Geometry object that contains all this data.
+		this->geometries.push_back(aladdin_3d::Geometry(vertices, indices, textures, 1.0));
+
+		return (int) this->geometries.size() - 1;
+
+	}
+
+	template <typename T>
+	std::vector<T> LoaderGLTF::readAccessor(const GltfAccessor& accessor) {
+
+		const std::vector<GltfBufferView>& views = this->document.buffer_views;
+
+		// Get properties from the accessor
+		size_t count = accessor.count;
+		unsigned int components = accessor.components;
+		unsigned int component_size = componentSize(accessor.component_type);
+
+		if (components == 0 || component_size == 0) {
+
+			std::cerr << "LoaderGLTF error - An accessor has an invalid type." << std::endl;
+			return std::vector<T>();
+
+		}
+
+		std::vector<T> values(count * components, T(0));
+		size_t element_size = (size_t) component_size * components;
+
+		// Go over all the elements, which can be interleaved with other data.
+		if (accessor.buffer_view >= 0 && (size_t) accessor.buffer_view < views.size()) {
+
+			const GltfBufferView& bufferView = views[accessor.buffer_view];
+			size_t byteOffset = bufferView.byte_offset + accessor.byte_offset;
+			size_t byteStride = bufferView.byte_stride;
+
+			if (byteStride == 0)
+				byteStride = element_size;
+
+			if (count > 0 && byteOffset + (count - 1) * byteStride + element_size > this->bin_data.size()) {
+
+				std::cerr << "LoaderGLTF error - An accessor reads past the end of its buffer." << std::endl;
+				return values;
+
 			}
+
+			for (size_t i = 0; i < count; i++) {
+
+				const unsigned char* element = &this->bin_data[byteOffset + i * byteStride];
+
+				for (unsigned int c = 0; c < components; c++)
+					values[i * components + c] = (T) readComponent(element + c * component_size, accessor.component_type, accessor.normalized);
+
+			}
+
 		}
-		else if (componentType == 5122)
-		{
-			for (unsigned int i = beginningOfData; i < byteOffset + accByteOffset + count * 2; i)
-			{
-				unsigned char bytes[] = { this->bin_data[i++], this->bin_data[i++] };
-				short value;
-				std::memcpy(&value, bytes, sizeof(short));
-				indices.push_back((GLuint)value);
+
+		// Replace the elements the sparse part lists.
+		if (accessor.sparse_count > 0) {
+
+			size_t sparse_count = accessor.sparse_count;
+			unsigned int index_size = componentSize(accessor.sparse_indices_type);
+
+			if (index_size == 0 || accessor.sparse_indices_view < 0 || (size_t) accessor.sparse_indices_view >= views.size() ||
+					accessor.sparse_values_view < 0 || (size_t) accessor.sparse_values_view >= views.size()) {
+
+				std::cerr << "LoaderGLTF error - A sparse accessor is not valid." << std::endl;
+				return values;
+
+			}
+
+			size_t index_offset = views[accessor.sparse_indices_view].byte_offset + accessor.sparse_indices_offset;
+			size_t value_offset = views[accessor.sparse_values_view].byte_offset + accessor.sparse_values_offset;
+
+			if (index_offset + sparse_count * index_size > this->bin_data.size() || value_offset + sparse_count * element_size > this->bin_data.size()) {
+
+				std::cerr << "LoaderGLTF error - A sparse accessor reads past the end of its buffer." << std::endl;
+				return values;
+
+			}
+
+			for (size_t i = 0; i < sparse_count; i++) {
+
+				size_t target = (size_t) readComponent(&this->bin_data[index_offset + i * index_size], accessor.sparse_indices_type, false);
+
+				if (target >= count)
+					continue;
+
+				for (unsigned int c = 0; c < components; c++)
+					values[target * components + c] = (T) readComponent(&this->bin_data[value_offset + i * element_size + c * component_size],
+							accessor.component_type, accessor.normalized);
+
 			}
+
 		}
 
-		return indices;
+		return values;
+
+	}
+
+	std::vector<float> LoaderGLTF::getFloats(const GltfAccessor& accessor) {
+
+		return readAccessor<float>(accessor);
+
+	}
+
+	std::vector<GLuint> LoaderGLTF::getIndices(const GltfAccessor& accessor) {
+
+		return readAccessor<GLuint>(accessor);
+
 	}
 
 	std::vector<aladdin_3d::Texture> LoaderGLTF::getTextures() {
@@ -258,14 +627,28 @@ namespace aladdin_3d {
 		std::string file_dir_path = filename_str.substr(0, filename_str.find_last_of('/') + 1);
 
 		// Go through all materials.
-		for (size_t i = 0; i < this->json_file["materials"].size(); i++) {
+		for (size_t i = 0; i < this->document.materials.size(); i++) {
+
+			// Get the textures data, skipping the materials without one.
+			const GltfMaterial& material = this->document.materials[i];
+			int texture_index = material.base_color_texture;
+
+			if (texture_index < 0 || (size_t) texture_index >= this->document.texture_sources.size())
+				continue;
+
+			int image_index = this->document.texture_sources[texture_index];
+
+			if (image_index < 0)
+				image_index = texture_index;
+
+			if ((size_t) image_index >= this->document.images.size())
+				continue;
 
-			// Get the textures data.
-			std::string material_name = this->json_file["materials"][i]["name"];
-			int texture_index = this->json_file["materials"][i]["pbrMetallicRoughness"]["baseColorTexture"]["index"];
-			std::string texture_uri = this->json_file["images"][texture_index]["uri"];
+			const std::string& material_name = material.name;
+			const std::string& texture_uri = this->document.images[image_index];
 
-			// Create the new texture.
+			// Create the new texture. Materials and meshes sharing an image share
+			// the same OpenGL texture.
 			aladdin_3d::Texture new_texture = aladdin_3d::Texture((file_dir_path + texture_uri).c_str(), material_name.c_str(), textures.size());
 
 			// Add it to the textures.
@@ -304,11 +687,10 @@ namespace aladdin_3d {
 	std::vector<glm::vec2> LoaderGLTF::groupFloatsVec2(std::vector<float> floatVec)
 	{
 		std::vector<glm::vec2> vectors;
-		for (size_t i = 0; i < floatVec.size(); i) {
+		for (size_t k = 0; 2 * k + 1 < floatVec.size(); k++) {
             
-            // Do this for GLFW.
-            glm::vec2 coord(floatVec[i++], floatVec[i++]);
-            coord = glm::vec2(coord.y, coord.x);
+            // Do this for GLFW. The components are swapped, as the clang build always did.
+            glm::vec2 coord(floatVec[2 * k + 1], floatVec[2 * k + 0]);
             
 			vectors.push_back(coord);
             
@@ -319,9 +701,9 @@ namespace aladdin_3d {
 	std::vector<glm::vec3> LoaderGLTF::groupFloatsVec3(std::vector<float> floatVec)
 	{
 		std::vector<glm::vec3> vectors;
-		for (size_t i = 0; i < floatVec.size(); i)
+		for (size_t k = 0; 3 * k + 2 < floatVec.size(); k++)
 		{
-			vectors.push_back(glm::vec3(floatVec[i++], floatVec[i++], floatVec[i++]));
+			vectors.push_back(glm::vec3(floatVec[3 * k + 0], floatVec[3 * k + 1], floatVec[3 * k + 2]));
 		}
 		return vectors;
 	}
@@ -329,17 +711,17 @@ namespace aladdin_3d {
 	std::vector<glm::vec4> LoaderGLTF::groupFloatsVec4(std::vector<float> floatVec)
 	{
 		std::vector<glm::vec4> vectors;
-		for (size_t i = 0; i < floatVec.size(); i)
+		for (size_t k = 0; 4 * k + 3 < floatVec.size(); k++)
 		{
-			vectors.push_back(glm::vec4(floatVec[i++], floatVec[i++], floatVec[i++], floatVec[i++]));
+			vectors.push_back(glm::vec4(floatVec[4 * k + 0], floatVec[4 * k + 1], floatVec[4 * k + 2], floatVec[4 * k + 3]));
 		}
 		return vectors;
 	}
 
-	void LoaderGLTF::getGeometries(std::vector<Geometry> *geoms, std::vector<glm::mat4> *matrices) {
+	void LoaderGLTF::getGeometries(std::vector<Geometry> *geoms, SceneGraph *graph) {
 
 		(*geoms) = this->geometries;
-		(*matrices) = this->transform_matrixes;
+		(*graph) = this->scene_graph;
 
 	}
 
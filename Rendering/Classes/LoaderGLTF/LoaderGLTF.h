@@ -3,10 +3,10 @@
  * @brief Loader GLTF class header file.
  * @version 1.0.0 (2022-11-27)
  * @date 2022-11-27
- * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
  *
  *
- * Copyright (c) Borja Garca Quiroga, All Rights Reserved.
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
  *
  * The information and material provided below was developed as partial
  * requirements for the MSc in Computer Science at Trinity College Dublin,
@@ -18,11 +18,12 @@
 
 #include "Classes/Loader/Loader.h"
 
+#include <map>
 #include <vector>
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include "glm/glm.hpp"
-#include "json/json.h"
+#include "Structs/GltfDocument/GltfDocument.h"
 
 namespace aladdin_3d {
 
@@ -31,7 +32,7 @@ namespace aladdin_3d {
 	 *
 	 * Implements a loader class that will allow us to load GLTF models.
 	 *
-	 * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
 	 */
 	class LoaderGLTF : public Loader {
 
@@ -50,9 +51,9 @@ namespace aladdin_3d {
 			 * Get the geometries from the loaded model.
 			 * 
 			 * @param geoms Outputs the geometries returned.
-			 * @param matrices Outputs the transformation matrices.
+			 * @param graph Outputs the nodes that place the geometries.
 			 */
-			void getGeometries(std::vector<Geometry> *geoms, std::vector<glm::mat4> *matrices);
+			void getGeometries(std::vector<Geometry> *geoms, SceneGraph *graph);
 
 			/**
 			 * @brief Loads the data from the file.
@@ -64,27 +65,78 @@ namespace aladdin_3d {
 		private:
 
 			/**
-			 * @brief Loads a mesh by its index.
+			 * @brief Computes smooth normals.
 			 *
-			 * Loads a mesh by its index.
+			 * Computes the normals of some vertices as the sum of the normals of
+			 * the triangles around them, weighted by their area.
 			 *
-			 * @param indMesh the index of the mesh.
+			 * @param positions The positions of the vertices.
+			 * @param indices The triangles.
+			 *
+			 * @returns One normal per vertex.
+			 */
+			std::vector<glm::vec3> computeNormals(const std::vector<glm::vec3>& positions, const std::vector<GLuint>& indices);
+
+			/**
+			 * @brief Decodes the compressed buffer views.
+			 *
+			 * Decodes the buffer views compressed with EXT_meshopt_compression in
+			 * the thread pool, appends their data to the binary data and points the
+			 * views to it, so the accessors read them as any other.
+			 */
+			void decodeCompressedViews();
+
+			/**
+			 * @brief Loads the meshes used by the nodes.
+			 *
+			 * Decodes every accessor the primitives of those meshes use in the
+			 * thread pool, then builds a geometry for each primitive.
+			 */
+			void loadGeometries();
+
+			/**
+			 * @brief Loads a primitive.
+			 *
+			 * Builds the geometry of a primitive from its decoded accessors. Missing
+			 * normals are computed, missing texture coordinates are zero, and
+			 * missing indices draw the vertices in order.
+			 *
+			 * @param primitive The primitive.
+			 * @param textures The textures of the model.
+			 *
+			 * @returns The index of its geometry, -1 if it cannot be drawn.
+			 */
+			int loadPrimitive(const GltfPrimitive& primitive, const std::vector<Texture>& textures);
+
+			/**
+			 * @brief Reads an accessor.
+			 *
+			 * Reads every component of an accessor, following the stride of its
+			 * buffer view, normalizing integers if asked to and applying its sparse
+			 * values. An accessor without a buffer view starts as zeros.
+			 *
+			 * @param accessor The accessor.
+			 *
+			 * @returns The components of all its elements.
 			 */
-			void loadGeometry(unsigned int indMesh);
+			template <typename T>
+			std::vector<T> readAccessor(const GltfAccessor& accessor);
 
 			/**
 			 * @brief Traverses the nodes in the file.
 			 *
-			 * Traverses the nodes in the file.
+			 * Traverses the nodes in the file, adding each one to the scene graph
+			 * with its own transform, under its parent. The primitives of a mesh
+			 * after the first one hang from the node that uses it.
 			 *
 			 * @param nextNode The index of the next node.
-			 * @param matrix The matrx that will be used.
+			 * @param parent The index of the parent in the scene graph.
 			 */
-			void recursiveGetNode(unsigned int nextNode, glm::mat4 matrix = glm::mat4(1.0f));
+			void recursiveGetNode(unsigned int nextNode, int parent = 0);
 
 			// Interprets the binary data into floats, indices, and textures
-			std::vector<float> getFloats(nlohmann::json accessor);
-			std::vector<GLuint> getIndices(nlohmann::json accessor);
+			std::vector<float> getFloats(const GltfAccessor& accessor);
+			std::vector<GLuint> getIndices(const GltfAccessor& accessor);
 			std::vector<Texture> getTextures();
 
 			// Assembles all the floats into vertices
@@ -96,7 +148,10 @@ namespace aladdin_3d {
 			std::vector<glm::vec4> groupFloatsVec4(std::vector<float> floatVec);
 
 			std::vector<unsigned char> bin_data;	/// Binary data stored for convenience.
-			nlohmann::json json_file;				/// The model JSON file contents.
+			GltfDocument document;					/// The parts of the model JSON file that are used.
+			std::map<unsigned int, std::vector<int>> mesh_geometries;	/// Geometries of each mesh, one per primitive.
+			std::vector<std::vector<float>> accessor_floats;			/// Decoded accessors of attributes, by index.
+			std::vector<std::vector<GLuint>> accessor_indices;			/// Decoded accessors of indices, by index.
 
 	};
 
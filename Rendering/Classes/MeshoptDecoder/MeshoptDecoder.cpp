@@ -0,0 +1,513 @@
+/**
+ * @file MeshoptDecoder.cpp
+ * @brief MeshoptDecoder class implementation file.
+ * @version 1.0.0 (2023-03-04)
+ * @date 2023-03-04
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "MeshoptDecoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace aladdin_3d {
+
+	// Reads a variable length integer, 7 bits per byte, lowest bits first.
+	static unsigned int decodeVByte(const unsigned char*& data) {
+
+		unsigned char lead = *data++;
+
+		if (lead < 128)
+			return lead;
+
+		unsigned int result = lead & 127;
+		unsigned int shift = 7;
+
+		for (int i = 0; i < 4; i++) {
+
+			unsigned char group = *data++;
+			result |= (unsigned int) (group & 127) << shift;
+			shift += 7;
+
+			if (group < 128)
+				break;
+
+		}
+
+		return result;
+
+	}
+
+	// Reads an index coded as a zigzag delta from the last one.
+	static unsigned int decodeIndex(const unsigned char*& data, unsigned int last) {
+
+		unsigned int value = decodeVByte(data);
+		return last + ((value >> 1) ^ (0u - (value & 1)));
+
+	}
+
+	// Writes an index of 2 or 4 bytes.
+	static void writeIndex(unsigned char* output, size_t position, size_t index_size, unsigned int index) {
+
+		if (index_size == 2) {
+
+			unsigned short value = (unsigned short) index;
+			std::memcpy(output + position * 2, &value, 2);
+
+		} else {
+
+			std::memcpy(output + position * 4, &index, 4);
+
+		}
+
+	}
+
+	// Rounds a float to the nearest integer, halves away from zero.
+	static int roundSigned(float value) {
+
+		return (int) (value + (value >= 0.0f ? 0.5f : -0.5f));
+
+	}
+
+	// Rebuilds unit vectors from their octahedral coordinates, keeping the fourth component.
+	template <typename T>
+	static void decodeOctahedral(T* data, size_t count) {
+
+		const float max = (float) ((1 << (sizeof(T) * 8 - 1)) - 1);
+
+		for (size_t i = 0; i < count; i++) {
+
+			// The third component holds 1 at the same scale, so z comes from it.
+			float x = (float) data[i * 4 + 0];
+			float y = (float) data[i * 4 + 1];
+			float z = (float) data[i * 4 + 2] - std::abs(x) - std::abs(y);
+
+			// Fold the lower half back.
+			float t = std::min(z, 0.0f);
+			x += x >= 0.0f ? t : -t;
+			y += y >= 0.0f ? t : -t;
+
+			float scale = max / std::sqrt(x * x + y * y + z * z);
+
+			data[i * 4 + 0] = (T) roundSigned(x * scale);
+			data[i * 4 + 1] = (T) roundSigned(y * scale);
+			data[i * 4 + 2] = (T) roundSigned(z * scale);
+
+		}
+
+	}
+
+	bool MeshoptDecoder::decode(const unsigned char* source, size_t size, size_t count, size_t stride, const std::string& mode,
+			const std::string& filter, std::vector<unsigned char>& output) {
+
+		output.assign(count * stride, 0);
+
+		if (count == 0)
+			return true;
+
+		if (mode == "ATTRIBUTES") {
+
+			if (!decodeVertexBuffer(output.data(), count, stride, source, size))
+				return false;
+
+			return filter == "NONE" || filter.empty() || decodeFilter(output.data(), count, stride, filter);
+
+		}
+
+		if (stride != 2 && stride != 4)
+			return false;
+
+		if (mode == "TRIANGLES")
+			return count % 3 == 0 && decodeIndexBuffer(output.data(), count, stride, source, size);
+
+		if (mode == "INDICES")
+			return decodeIndexSequence(output.data(), count, stride, source, size);
+
+		return false;
+
+	}
+
+	const unsigned char* MeshoptDecoder::decodeBytes(const unsigned char* data, const unsigned char* end, unsigned char* output, size_t count) {
+
+		// Two bits per group tell how wide its values are.
+		size_t header_size = (count / MESHOPT_BYTE_GROUP + 3) / 4;
+
+		if ((size_t) (end - data) < header_size)
+			return nullptr;
+
+		const unsigned char* header = data;
+		data += header_size;
+
+		for (size_t i = 0; i < count; i += MESHOPT_BYTE_GROUP) {
+
+			size_t group = i / MESHOPT_BYTE_GROUP;
+			int bits_log2 = (header[group / 4] >> ((group % 4) * 2)) & 3;
+			unsigned char* values = output + i;
+
+			// All zeros.
+			if (bits_log2 == 0) {
+
+				std::memset(values, 0, MESHOPT_BYTE_GROUP);
+				continue;
+
+			}
+
+			// Raw bytes.
+			if (bits_log2 == 3) {
+
+				if ((size_t) (end - data) < MESHOPT_BYTE_GROUP)
+					return nullptr;
+
+				std::memcpy(values, data, MESHOPT_BYTE_GROUP);
+				data += MESHOPT_BYTE_GROUP;
+				continue;
+
+			}
+
+			// Packed 2 or 4 bit values, highest bits first. The largest value means
+			// the real byte follows the packed ones.
+			int bits = bits_log2 == 1 ? 2 : 4;
+			unsigned int escape = (1u << bits) - 1;
+			size_t packed = MESHOPT_BYTE_GROUP * bits / 8;
+
+			if ((size_t) (end - data) < packed)
+				return nullptr;
+
+			const unsigned char* extra = data + packed;
+
+			for (int k = 0; k < MESHOPT_BYTE_GROUP; k++) {
+
+				int bit = k * bits;
+				unsigned int value = (data[bit / 8] >> (8 - bits - bit % 8)) & escape;
+
+				if (value == escape) {
+
+					if (extra >= end)
+						return nullptr;
+
+					values[k] = *extra++;
+
+				} else {
+
+					values[k] = (unsigned char) value;
+
+				}
+
+			}
+
+			data = extra;
+
+		}
+
+		return data;
+
+	}
+
+	bool MeshoptDecoder::decodeFilter(unsigned char* data, size_t count, size_t stride, const std::string& filter) {
+
+		if (filter == "OCTAHEDRAL") {
+
+			if (stride == 4)
+				decodeOctahedral((signed char*) data, count);
+			else if (stride == 8)
+				decodeOctahedral((short*) data, count);
+			else
+				return false;
+
+			return true;
+
+		}
+
+		if (filter == "QUATERNION") {
+
+			if (stride != 8)
+				return false;
+
+			short* values = (short*) data;
+			const float scale = 1.0f / std::sqrt(2.0f);
+
+			for (size_t i = 0; i < count; i++) {
+
+				// The three smallest components are stored, with their range in the fourth.
+				int range = values[i * 4 + 3] | 3;
+				float component_scale = scale / (float) range;
+
+				float x = values[i * 4 + 0] * component_scale;
+				float y = values[i * 4 + 1] * component_scale;
+				float z = values[i * 4 + 2] * component_scale;
+				float w = std::sqrt(std::max(1.0f - x * x - y * y - z * z, 0.0f));
+
+				// The largest one goes back where it was.
+				int largest = values[i * 4 + 3] & 3;
+
+				values[i * 4 + ((largest + 1) & 3)] = (short) roundSigned(x * 32767.0f);
+				values[i * 4 + ((largest + 2) & 3)] = (short) roundSigned(y * 32767.0f);
+				values[i * 4 + ((largest + 3) & 3)] = (short) roundSigned(z * 32767.0f);
+				values[i * 4 + ((largest + 0) & 3)] = (short) roundSigned(w * 32767.0f);
+
+			}
+
+			return true;
+
+		}
+
+		if (filter == "EXPONENTIAL") {
+
+			if (stride % 4 != 0)
+				return false;
+
+			// A 24 bit mantissa and an 8 bit exponent become a float.
+			for (size_t i = 0; i < count * stride / 4; i++) {
+
+				int value;
+				std::memcpy(&value, data + i * 4, 4);
+
+				int mantissa = (int) ((unsigned int) value << 8) >> 8;
+				int exponent = value >> 24;
+				float result = std::ldexp((float) mantissa, exponent);
+
+				std::memcpy(data + i * 4, &result, 4);
+
+			}
+
+			return true;
+
+		}
+
+		std::cerr << "MeshoptDecoder error - Unknown filter " << filter << "." << std::endl;
+		return false;
+
+	}
+
+	bool MeshoptDecoder::decodeIndexBuffer(unsigned char* output, size_t count, size_t index_size, const unsigned char* source, size_t size) {
+
+		if (size < 1 + count / 3 + 16 || (source[0] & 0xF0) != 0xE0 || (source[0] & 0x0F) > 1)
+			return false;
+
+		int version = source[0] & 0x0F;
+
+		// Version 1 codes the two vertices next to the last one as deltas.
+		int fifo_max = version >= 1 ? 13 : 15;
+
+		unsigned int edges[MESHOPT_EDGE_FIFO][2];
+		unsigned int vertices[MESHOPT_VERTEX_FIFO];
+		std::memset(edges, -1, sizeof(edges));
+		std::memset(vertices, -1, sizeof(vertices));
+
+		size_t edge_offset = 0;
+		size_t vertex_offset = 0;
+		unsigned int next = 0;
+		unsigned int last = 0;
+
+		// One code per triangle, then the extra data, then a table of 16 codes.
+		const unsigned char* code = source + 1;
+		const unsigned char* data = code + count / 3;
+		const unsigned char* data_end = source + size - 16;
+		const unsigned char* table = data_end;
+
+		auto pushVertex = [&](unsigned int vertex, bool push) {
+			vertices[vertex_offset] = vertex;
+			vertex_offset = (vertex_offset + push) & (MESHOPT_VERTEX_FIFO - 1);
+		};
+
+		auto pushEdge = [&](unsigned int a, unsigned int b) {
+			edges[edge_offset][0] = a;
+			edges[edge_offset][1] = b;
+			edge_offset = (edge_offset + 1) & (MESHOPT_EDGE_FIFO - 1);
+		};
+
+		for (size_t i = 0; i < count; i += 3) {
+
+			// The longest triangle reads 3 indices of 5 bytes and a code byte.
+			if (data > data_end)
+				return false;
+
+			unsigned char triangle = *code++;
+			unsigned int a, b, c;
+
+			if (triangle < 0xF0) {
+
+				// Shares an edge with a recent triangle.
+				int edge = triangle >> 4;
+				a = edges[(edge_offset - 1 - edge) & (MESHOPT_EDGE_FIFO - 1)][0];
+				b = edges[(edge_offset - 1 - edge) & (MESHOPT_EDGE_FIFO - 1)][1];
+
+				int third = triangle & 15;
+
+				if (third < fifo_max) {
+
+					// A new vertex, or a recent one.
+					c = third == 0 ? next : vertices[(vertex_offset - 1 - third) & (MESHOPT_VERTEX_FIFO - 1)];
+					next += third == 0;
+					pushVertex(c, third == 0);
+
+				} else {
+
+					// 13 and 14 are one less and one more than the last free index.
+					c = last = third != 15 ? last + (third - (third ^ 3)) : decodeIndex(data, last);
+					pushVertex(c, true);
+
+				}
+
+				pushEdge(c, b);
+				pushEdge(a, c);
+
+			} else if (triangle < 0xFE) {
+
+				// A new first vertex, and the other two from the table.
+				unsigned char aux = table[triangle & 15];
+				int second = aux >> 4;
+				int third = aux & 15;
+
+				a = next++;
+				b = second == 0 ? next : vertices[(vertex_offset - second) & (MESHOPT_VERTEX_FIFO - 1)];
+				next += second == 0;
+				c = third == 0 ? next : vertices[(vertex_offset - third) & (MESHOPT_VERTEX_FIFO - 1)];
+				next += third == 0;
+
+				pushVertex(a, true);
+				pushVertex(b, second == 0);
+				pushVertex(c, third == 0);
+				pushEdge(b, a);
+				pushEdge(c, b);
+				pushEdge(a, c);
+
+			} else {
+
+				// The codes of the other two vertices in a byte of their own.
+				unsigned char aux = *data++;
+				int first = triangle == 0xFE ? 0 : 15;
+				int second = aux >> 4;
+				int third = aux & 15;
+
+				// A zero byte restarts the new vertices.
+				if (aux == 0)
+					next = 0;
+
+				a = first == 0 ? next++ : 0;
+				b = second == 0 ? next++ : vertices[(vertex_offset - second) & (MESHOPT_VERTEX_FIFO - 1)];
+				c = third == 0 ? next++ : vertices[(vertex_offset - third) & (MESHOPT_VERTEX_FIFO - 1)];
+
+				if (first == 15) last = a = decodeIndex(data, last);
+				if (second == 15) last = b = decodeIndex(data, last);
+				if (third == 15) last = c = decodeIndex(data, last);
+
+				pushVertex(a, true);
+				pushVertex(b, second == 0 || second == 15);
+				pushVertex(c, third == 0 || third == 15);
+				pushEdge(b, a);
+				pushEdge(c, b);
+				pushEdge(a, c);
+
+			}
+
+			writeIndex(output, i, index_size, a);
+			writeIndex(output, i + 1, index_size, b);
+			writeIndex(output, i + 2, index_size, c);
+
+		}
+
+		// All the data has to be used, up to the table.
+		return data == data_end;
+
+	}
+
+	bool MeshoptDecoder::decodeIndexSequence(unsigned char* output, size_t count, size_t index_size, const unsigned char* source, size_t size) {
+
+		if (size < 1 + count + 4 || (source[0] & 0xF0) != 0xD0 || (source[0] & 0x0F) > 1)
+			return false;
+
+		const unsigned char* data = source + 1;
+		const unsigned char* data_end = source + size - 4;
+		unsigned int last[2] = { 0, 0 };
+
+		for (size_t i = 0; i < count; i++) {
+
+			if (data >= data_end)
+				return false;
+
+			// The lowest bit picks which of the last two indices the delta is from.
+			unsigned int value = decodeVByte(data);
+			unsigned int base = value & 1;
+			value >>= 1;
+
+			unsigned int index = last[base] + ((value >> 1) ^ (0u - (value & 1)));
+			last[base] = index;
+
+			writeIndex(output, i, index_size, index);
+
+		}
+
+		return data == data_end;
+
+	}
+
+	bool MeshoptDecoder::decodeVertexBuffer(unsigned char* output, size_t count, size_t vertex_size, const unsigned char* source, size_t size) {
+
+		if (vertex_size == 0 || vertex_size > 256 || vertex_size % 4 != 0)
+			return false;
+
+		size_t tail_size = std::max(vertex_size, (size_t) MESHOPT_TAIL_BYTES);
+
+		if (size < 1 + tail_size || source[0] != 0xA0)
+			return false;
+
+		const unsigned char* data = source + 1;
+		const unsigned char* end = source + size;
+
+		// The vertex before the first one is stored at the end.
+		unsigned char last_vertex[256];
+		std::memcpy(last_vertex, end - vertex_size, vertex_size);
+
+		// As many vertices per block as fit, in whole groups.
+		size_t block_vertices = std::min((size_t) MESHOPT_BLOCK_BYTES / vertex_size & ~(size_t) (MESHOPT_BYTE_GROUP - 1),
+				(size_t) MESHOPT_BLOCK_VERTICES);
+
+		unsigned char deltas[MESHOPT_BLOCK_VERTICES];
+
+		for (size_t first = 0; first < count; first += block_vertices) {
+
+			size_t block_count = std::min(block_vertices, count - first);
+			size_t aligned_count = (block_count + MESHOPT_BYTE_GROUP - 1) & ~(size_t) (MESHOPT_BYTE_GROUP - 1);
+			unsigned char* block = output + first * vertex_size;
+
+			// Each byte of the vertex is a channel of its own, added up from the last vertex.
+			for (size_t k = 0; k < vertex_size; k++) {
+
+				data = decodeBytes(data, end - tail_size, deltas, aligned_count);
+
+				if (data == nullptr)
+					return false;
+
+				unsigned char previous = last_vertex[k];
+
+				for (size_t i = 0; i < block_count; i++) {
+
+					unsigned char delta = deltas[i];
+					previous = (unsigned char) (previous + ((delta >> 1) ^ (0u - (delta & 1))));
+					block[i * vertex_size + k] = previous;
+
+				}
+
+			}
+
+			std::memcpy(last_vertex, block + (block_count - 1) * vertex_size, vertex_size);
+
+		}
+
+		// Only the tail can be left.
+		return (size_t) (end - data) == tail_size;
+
+	}
+
+} // namespace aladdin_3d
@@ -0,0 +1,149 @@
+/**
+ * @file MeshoptDecoder.h
+ * @brief MeshoptDecoder class header file.
+ * @version 1.0.0 (2023-03-04)
+ * @date 2023-03-04
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_MESHOPTDECODER_H_
+#define ALADDIN_3D_CLASS_MESHOPTDECODER_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#define MESHOPT_BYTE_GROUP 16		/// Bytes of a channel that share a bit width.
+#define MESHOPT_BLOCK_BYTES 8192	/// Most bytes of vertices decoded as one block.
+#define MESHOPT_BLOCK_VERTICES 256	/// Most vertices in a block.
+#define MESHOPT_TAIL_BYTES 32		/// Smallest tail after the vertex blocks, holding the first vertex.
+#define MESHOPT_EDGE_FIFO 16		/// Edges remembered by the index codec.
+#define MESHOPT_VERTEX_FIFO 16		/// Vertices remembered by the index codec.
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implements an EXT_meshopt_compression decoder.
+	 *
+	 * Implements a decoder of the buffer views compressed with the meshoptimizer
+	 * codecs of EXT_meshopt_compression: vertex attributes stored as deltas of
+	 * byte channels, triangles stored through edge and vertex FIFOs, and plain
+	 * index sequences. The octahedral, quaternion and exponential filters are
+	 * undone after the attributes are decoded.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class MeshoptDecoder {
+
+		public:
+
+			/**
+			 * @brief Decodes a buffer view.
+			 *
+			 * Decodes the compressed data of a buffer view into the bytes the
+			 * uncompressed view would hold.
+			 *
+			 * @param source The compressed data.
+			 * @param size Size of the compressed data in bytes.
+			 * @param count Number of elements.
+			 * @param stride Size of each element in bytes.
+			 * @param mode ATTRIBUTES, TRIANGLES or INDICES.
+			 * @param filter NONE, OCTAHEDRAL, QUATERNION or EXPONENTIAL.
+			 * @param output Outputs the decoded bytes.
+			 *
+			 * @returns Whether the data could be decoded.
+			 */
+			static bool decode(const unsigned char* source, size_t size, size_t count, size_t stride, const std::string& mode,
+					const std::string& filter, std::vector<unsigned char>& output);
+
+		private:
+
+			/**
+			 * @brief Decodes the bytes of a channel.
+			 *
+			 * Decodes the zigzag deltas of one byte channel of a block, in groups
+			 * of 16 that share a bit width.
+			 *
+			 * @param data The compressed data.
+			 * @param end The end of the compressed data.
+			 * @param output Where the deltas are written.
+			 * @param count Number of deltas, a multiple of the group size.
+			 *
+			 * @returns Where the channel ends, or null if the data is too short.
+			 */
+			static const unsigned char* decodeBytes(const unsigned char* data, const unsigned char* end, unsigned char* output, size_t count);
+
+			/**
+			 * @brief Decodes an index buffer.
+			 *
+			 * Decodes triangles coded against the edges and vertices of the
+			 * previous ones.
+			 *
+			 * @param output Where the indices are written.
+			 * @param count Number of indices.
+			 * @param index_size Size of each index, 2 or 4 bytes.
+			 * @param source The compressed data.
+			 * @param size Size of the compressed data in bytes.
+			 *
+			 * @returns Whether the data could be decoded.
+			 */
+			static bool decodeIndexBuffer(unsigned char* output, size_t count, size_t index_size, const unsigned char* source, size_t size);
+
+			/**
+			 * @brief Decodes an index sequence.
+			 *
+			 * Decodes indices coded as deltas from one of the last two.
+			 *
+			 * @param output Where the indices are written.
+			 * @param count Number of indices.
+			 * @param index_size Size of each index, 2 or 4 bytes.
+			 * @param source The compressed data.
+			 * @param size Size of the compressed data in bytes.
+			 *
+			 * @returns Whether the data could be decoded.
+			 */
+			static bool decodeIndexSequence(unsigned char* output, size_t count, size_t index_size, const unsigned char* source, size_t size);
+
+			/**
+			 * @brief Decodes a vertex buffer.
+			 *
+			 * Decodes vertices coded as deltas of each byte from the same byte of
+			 * the previous vertex, in blocks.
+			 *
+			 * @param output Where the vertices are written.
+			 * @param count Number of vertices.
+			 * @param vertex_size Size of each vertex in bytes.
+			 * @param source The compressed data.
+			 * @param size Size of the compressed data in bytes.
+			 *
+			 * @returns Whether the data could be decoded.
+			 */
+			static bool decodeVertexBuffer(unsigned char* output, size_t count, size_t vertex_size, const unsigned char* source, size_t size);
+
+			/**
+			 * @brief Undoes a filter.
+			 *
+			 * Turns the decoded values of a filter back into the values of the
+			 * accessors.
+			 *
+			 * @param data The decoded vertices.
+			 * @param count Number of vertices.
+			 * @param stride Size of each vertex in bytes.
+			 * @param filter OCTAHEDRAL, QUATERNION or EXPONENTIAL.
+			 *
+			 * @returns Whether the filter fits the stride.
+			 */
+			static bool decodeFilter(unsigned char* data, size_t count, size_t stride, const std::string& filter);
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_MESHOPTDECODER_H_
@@ -0,0 +1,284 @@
+/**
+ * @file MipmapGenerator.cpp
+ * @brief MipmapGenerator class implementation file.
+ * @version 1.0.0 (2023-02-14)
+ * @date 2023-02-14
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "MipmapGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "Classes/ThreadPool/ThreadPool.h"
+
+namespace aladdin_3d {
+
+	// A pixel is filtered as one vector of four floats, RGBA.
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+	typedef float32x4_t Pixel;
+
+	static inline Pixel pixelZero() { return vdupq_n_f32(0.0f); }
+	static inline Pixel pixelLoad(const float* source) { return vld1q_f32(source); }
+	static inline void pixelStore(float* output, Pixel pixel) { vst1q_f32(output, pixel); }
+	static inline Pixel pixelAdd(Pixel a, Pixel b) { return vaddq_f32(a, b); }
+	static inline Pixel pixelMultiplyAdd(Pixel sum, Pixel pixel, float weight) { return vmlaq_n_f32(sum, pixel, weight); }
+	static inline Pixel pixelScale(Pixel pixel, float weight) { return vmulq_n_f32(pixel, weight); }
+	static inline Pixel pixelClamp(Pixel pixel) { return vminq_f32(vmaxq_f32(pixel, vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f)); }
+
+#elif defined(__SSE2__)
+
+	typedef __m128 Pixel;
+
+	static inline Pixel pixelZero() { return _mm_setzero_ps(); }
+	static inline Pixel pixelLoad(const float* source) { return _mm_loadu_ps(source); }
+	static inline void pixelStore(float* output, Pixel pixel) { _mm_storeu_ps(output, pixel); }
+	static inline Pixel pixelAdd(Pixel a, Pixel b) { return _mm_add_ps(a, b); }
+	static inline Pixel pixelMultiplyAdd(Pixel sum, Pixel pixel, float weight) { return _mm_add_ps(sum, _mm_mul_ps(pixel, _mm_set1_ps(weight))); }
+	static inline Pixel pixelScale(Pixel pixel, float weight) { return _mm_mul_ps(pixel, _mm_set1_ps(weight)); }
+	static inline Pixel pixelClamp(Pixel pixel) { return _mm_min_ps(_mm_max_ps(pixel, _mm_setzero_ps()), _mm_set1_ps(1.0f)); }
+
+#else
+
+	struct Pixel { float v[4]; };
+
+	static inline Pixel pixelZero() { return Pixel{ { 0.0f, 0.0f, 0.0f, 0.0f } }; }
+	static inline Pixel pixelLoad(const float* source) { return Pixel{ { source[0], source[1], source[2], source[3] } }; }
+	static inline void pixelStore(float* output, Pixel pixel) { std::copy(pixel.v, pixel.v + 4, output); }
+	static inline Pixel pixelAdd(Pixel a, Pixel b) { for (int c = 0; c < 4; c++) a.v[c] += b.v[c]; return a; }
+	static inline Pixel pixelMultiplyAdd(Pixel sum, Pixel pixel, float weight) { for (int c = 0; c < 4; c++) sum.v[c] += pixel.v[c] * weight; return sum; }
+	static inline Pixel pixelScale(Pixel pixel, float weight) { for (int c = 0; c < 4; c++) pixel.v[c] *= weight; return pixel; }
+	static inline Pixel pixelClamp(Pixel pixel) { for (int c = 0; c < 4; c++) pixel.v[c] = std::min(std::max(pixel.v[c], 0.0f), 1.0f); return pixel; }
+
+#endif
+
+	std::vector<TextureLevel> MipmapGenerator::generate(const TextureLevel& base, MipmapFilter filter, bool srgb) {
+
+		// Table to decode sRGB colors.
+		static const std::vector<float> srgb_to_linear = []() {
+			std::vector<float> table(256);
+			for (int i = 0; i < 256; i++) {
+				float value = i / 255.0f;
+				table[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+			}
+			return table;
+		}();
+
+		// Decode the base level into linear floats.
+		std::vector<float> current(base.data.size());
+
+		for (size_t i = 0; i < base.data.size(); i++)
+			current[i] = (srgb && i % 4 != 3) ? srgb_to_linear[base.data[i]] : base.data[i] / 255.0f;
+
+		std::vector<TextureLevel> levels = { base };
+		int width = base.width;
+		int height = base.height;
+
+		// Halve the size until it is 1x1. Each level is filtered from the last one.
+		while (width > 1 || height > 1) {
+
+			std::vector<float> next;
+
+			if (filter == MIPMAP_FILTER_KAISER)
+				MipmapGenerator::downsampleKaiser(current, width, height, &next);
+			else
+				MipmapGenerator::downsampleBox(current, width, height, &next);
+
+			width = std::max(width / 2, 1);
+			height = std::max(height / 2, 1);
+			levels.push_back(MipmapGenerator::encode(next, width, height, srgb));
+			current = std::move(next);
+
+		}
+
+		return levels;
+
+	}
+
+	void MipmapGenerator::downsampleBox(const std::vector<float>& source, int width, int height, std::vector<float>* output) {
+
+		int output_width = std::max(width / 2, 1);
+		int output_height = std::max(height / 2, 1);
+		output->resize((size_t) output_width * output_height * 4);
+
+		// Average each 2x2 square, clamping at the edges of odd sizes.
+		ThreadPool::getShared().parallelFor(output_height, [&](size_t first, size_t last) {
+
+			for (size_t y = first; y < last; y++) {
+
+				const float* row0 = &source[(size_t) std::min((int) y * 2, height - 1) * width * 4];
+				const float* row1 = &source[(size_t) std::min((int) y * 2 + 1, height - 1) * width * 4];
+
+				for (int x = 0; x < output_width; x++) {
+
+					int x0 = std::min(x * 2, width - 1) * 4;
+					int x1 = std::min(x * 2 + 1, width - 1) * 4;
+
+					Pixel sum = pixelAdd(pixelAdd(pixelLoad(row0 + x0), pixelLoad(row0 + x1)),
+							pixelAdd(pixelLoad(row1 + x0), pixelLoad(row1 + x1)));
+
+					pixelStore(&(*output)[((size_t) y * output_width + x) * 4], pixelScale(sum, 0.25f));
+
+				}
+
+			}
+
+		});
+
+	}
+
+	void MipmapGenerator::downsampleKaiser(const std::vector<float>& source, int width, int height, std::vector<float>* output) {
+
+		const std::vector<float>& weights = MipmapGenerator::getKaiserWeights();
+		int half_taps = MIPMAP_KAISER_TAPS / 2;
+
+		int output_width = std::max(width / 2, 1);
+		int output_height = std::max(height / 2, 1);
+
+		// Filter the rows first, into a level as tall as the source.
+		std::vector<float> horizontal((size_t) output_width * height * 4);
+
+		ThreadPool::getShared().parallelFor(height, [&](size_t first, size_t last) {
+
+			for (size_t y = first; y < last; y++) {
+
+				const float* row = &source[(size_t) y * width * 4];
+
+				for (int x = 0; x < output_width; x++) {
+
+					Pixel sum = pixelZero();
+
+					for (int k = 0; k < MIPMAP_KAISER_TAPS; k++) {
+
+						int sample = std::min(std::max(x * 2 - half_taps + 1 + k, 0), width - 1);
+						sum = pixelMultiplyAdd(sum, pixelLoad(row + sample * 4), weights[k]);
+
+					}
+
+					pixelStore(&horizontal[((size_t) y * output_width + x) * 4], sum);
+
+				}
+
+			}
+
+		});
+
+		// Then the columns. The negative lobes can take values out of range.
+		output->resize((size_t) output_width * output_height * 4);
+
+		ThreadPool::getShared().parallelFor(output_height, [&](size_t first, size_t last) {
+
+			for (size_t y = first; y < last; y++) {
+
+				for (int x = 0; x < output_width; x++) {
+
+					Pixel sum = pixelZero();
+
+					for (int k = 0; k < MIPMAP_KAISER_TAPS; k++) {
+
+						int sample = std::min(std::max((int) y * 2 - half_taps + 1 + k, 0), height - 1);
+						sum = pixelMultiplyAdd(sum, pixelLoad(&horizontal[((size_t) sample * output_width + x) * 4]), weights[k]);
+
+					}
+
+					pixelStore(&(*output)[((size_t) y * output_width + x) * 4], pixelClamp(sum));
+
+				}
+
+			}
+
+		});
+
+	}
+
+	const std::vector<float>& MipmapGenerator::getKaiserWeights() {
+
+		static const std::vector<float> weights = []() {
+
+			// Modified Bessel function of the first kind, by its series.
+			auto bessel = [](float x) {
+				float sum = 1.0f, term = 1.0f;
+				for (int k = 1; k < 16; k++) {
+					term *= (x / (2.0f * k)) * (x / (2.0f * k));
+					sum += term;
+				}
+				return sum;
+			};
+
+			// The taps sit at half pixel offsets around the centre of the output
+			// pixel. Distances are in output pixels, the window spans two of them.
+			std::vector<float> result(MIPMAP_KAISER_TAPS);
+			float total = 0.0f;
+
+			for (int k = 0; k < MIPMAP_KAISER_TAPS; k++) {
+
+				float distance = (k - (MIPMAP_KAISER_TAPS - 1) / 2.0f) / 2.0f;
+				float window_position = distance / (MIPMAP_KAISER_TAPS / 4.0f);
+				float sinc = std::sin(3.14159265f * distance) / (3.14159265f * distance);
+				float window = bessel(MIPMAP_KAISER_ALPHA * std::sqrt(std::max(1.0f - window_position * window_position, 0.0f))) / bessel(MIPMAP_KAISER_ALPHA);
+
+				result[k] = sinc * window;
+				total += result[k];
+
+			}
+
+			for (int k = 0; k < MIPMAP_KAISER_TAPS; k++)
+				result[k] /= total;
+
+			return result;
+
+		}();
+
+		return weights;
+
+	}
+
+	TextureLevel MipmapGenerator::encode(const std::vector<float>& source, int width, int height, bool srgb) {
+
+		// Table to encode linear values as sRGB, fine enough for 8 bits.
+		static const std::vector<unsigned char> linear_to_srgb = []() {
+			std::vector<unsigned char> table(4096);
+			for (int i = 0; i < 4096; i++) {
+				float value = i / 4095.0f;
+				float encoded = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+				table[i] = (unsigned char) std::lround(encoded * 255.0f);
+			}
+			return table;
+		}();
+
+		TextureLevel level;
+		level.width = width;
+		level.height = height;
+		level.data.resize(source.size());
+
+		for (size_t i = 0; i < source.size(); i++) {
+
+			float value = std::min(std::max(source[i], 0.0f), 1.0f);
+
+			if (srgb && i % 4 != 3)
+				level.data[i] = linear_to_srgb[(int) (value * 4095.0f + 0.5f)];
+			else
+				level.data[i] = (unsigned char) (value * 255.0f + 0.5f);
+
+		}
+
+		return level;
+
+	}
+
+} // namespace aladdin_3d
@@ -0,0 +1,122 @@
+/**
+ * @file MipmapGenerator.h
+ * @brief MipmapGenerator class header file.
+ * @version 1.0.0 (2023-02-14)
+ * @date 2023-02-14
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_MIPMAPGENERATOR_H_
+#define ALADDIN_3D_CLASS_MIPMAPGENERATOR_H_
+
+#include <vector>
+
+#include "Structs/TextureLevel/TextureLevel.h"
+
+#define MIPMAP_KAISER_ALPHA 4.0f	/// Shape of the Kaiser window.
+#define MIPMAP_KAISER_TAPS 8		/// Taps of the Kaiser filter in each direction.
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Filters used to build the mip levels.
+	 *
+	 * Filters used to build the mip levels.
+	 */
+	enum MipmapFilter {
+
+		MIPMAP_FILTER_BOX,		// Averages 2x2 pixels.
+		MIPMAP_FILTER_KAISER	// Kaiser windowed sinc, sharper than the box.
+
+	};
+
+	/**
+	 * @brief Implements a CPU mip chain generator.
+	 *
+	 * Implements the generation of mip chains from RGBA8 images. Filtering is
+	 * done in linear space, so sRGB colors are decoded before and encoded after.
+	 * Pixels are filtered as 4 float vectors with NEON or SSE when available, and
+	 * the rows of each level are split across the thread pool.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class MipmapGenerator {
+
+		public:
+
+			/**
+			 * @brief Generates a mip chain.
+			 *
+			 * Generates the whole mip chain of an RGBA8 level, down to 1x1.
+			 *
+			 * @param base The largest level.
+			 * @param filter Filter used to halve each level.
+			 * @param srgb Whether the colors are sRGB encoded. Alpha is always linear.
+			 *
+			 * @returns All the levels, the largest first.
+			 */
+			static std::vector<TextureLevel> generate(const TextureLevel& base, MipmapFilter filter, bool srgb);
+
+		private:
+
+			/**
+			 * @brief Halves a level with a box filter.
+			 *
+			 * Halves a linear RGBA float level averaging 2x2 pixels.
+			 *
+			 * @param source Source pixels.
+			 * @param width Source width.
+			 * @param height Source height.
+			 * @param output Where the halved pixels are written.
+			 */
+			static void downsampleBox(const std::vector<float>& source, int width, int height, std::vector<float>* output);
+
+			/**
+			 * @brief Halves a level with a Kaiser filter.
+			 *
+			 * Halves a linear RGBA float level with a separable Kaiser windowed
+			 * sinc, horizontally first and vertically after.
+			 *
+			 * @param source Source pixels.
+			 * @param width Source width.
+			 * @param height Source height.
+			 * @param output Where the halved pixels are written.
+			 */
+			static void downsampleKaiser(const std::vector<float>& source, int width, int height, std::vector<float>* output);
+
+			/**
+			 * @brief Gets the Kaiser filter weights.
+			 *
+			 * Gets the normalized weights of the Kaiser filter for halving.
+			 *
+			 * @returns The MIPMAP_KAISER_TAPS weights.
+			 */
+			static const std::vector<float>& getKaiserWeights();
+
+			/**
+			 * @brief Converts a float level into RGBA8.
+			 *
+			 * Converts a linear RGBA float level into RGBA8, encoding the colors
+			 * as sRGB if asked to.
+			 *
+			 * @param source Source pixels.
+			 * @param width Width of the level.
+			 * @param height Height of the level.
+			 * @param srgb Whether to encode the colors as sRGB.
+			 *
+			 * @returns The RGBA8 level.
+			 */
+			static TextureLevel encode(const std::vector<float>& source, int width, int height, bool srgb);
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_MIPMAPGENERATOR_H_
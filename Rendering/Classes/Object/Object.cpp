@@ -3,10 +3,10 @@
  * @brief Object class implementation file.
  * @version 1.0.0 (2022-10-21)
  * @date 2022-10-21
- * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
  *
  *
- * Copyright (c) Borja Garca Quiroga, All Rights Reserved.
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
  *
  * The information and material provided below was developed as partial
  * requirements for the MSc in Computer Science at Trinity College Dublin,
@@ -15,6 +15,7 @@
 
 #include "Object.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
@@ -23,6 +24,7 @@
 #include "Classes/Loader/Loader.h"
 #include "Classes/LoaderGLTF/LoaderGLTF.h"
 #include "Classes/LoaderAssimp/LoaderAssimp.h"
+#include "Classes/ProfilerScope/ProfilerScope.h"
 #include "Structs/Vertex/Vertex.h"
 #include "Structs/BoundingBox/BoundingBox.h"
 
@@ -53,7 +55,14 @@ namespace aladdin_3d {
 		
         (*model_loader).loadModel();
 
-		(*model_loader).getGeometries(&this->geoms, &this->matrices_geoms);
+		(*model_loader).getGeometries(&this->geoms, &this->graph);
+
+		// Find the node that places each geometry, for the transforms of a single one.
+		this->geometry_nodes = std::vector<int>(this->geoms.size(), 0);
+
+		for (int i = (int) this->graph.getNodeCount() - 1; i >= 0; i--)
+			if (this->graph.getNode(i).geometry >= 0)
+				this->geometry_nodes[this->graph.getNode(i).geometry] = i;
 
 	}
 
@@ -62,48 +71,107 @@ namespace aladdin_3d {
 		// Copy the geometries.
 		this->geoms = geometries;
 
-		// Get an identity matrix for each.
-		this->matrices_geoms = std::vector<glm::mat4>(geometries.size(), glm::mat4(1.0f));
+		// Hang a node for each from the root of the object.
+		this->graph.addNode(SceneNode());
+
+		for (size_t i = 0; i < geometries.size(); i++) {
+
+			SceneNode node;
+			node.parent = 0;
+			node.geometry = (int) i;
+			this->geometry_nodes.push_back(this->graph.addNode(node));
+
+		}
 
 	}
 
 	void Object::draw(aladdin_3d::Shader& shader, aladdin_3d::Camera& camera)
 	{
-		// Go over all meshes and draw each one
-		for (unsigned int i = 0; i < this->geoms.size(); i++)
+		// Measure the whole object.
+		ProfilerScope scope("Object::draw", true);
+
+		// Only the nodes that moved, or all of them for a new view, are computed again.
+		this->graph.update(camera.getView());
+
+		// Go over all nodes and draw the mesh of each one
+		for (int i = 0; i < (int) this->graph.getNodeCount(); i++)
+		{
+			int geometry = this->graph.getNode(i).geometry;
+			if (geometry < 0) continue;
+
+			this->graph.bindNode(shader, i);
+			geoms[geometry].draw(shader, camera, this->graph.getWorld(i));
+		}
+	}
+
+	void Object::drawDepth(aladdin_3d::Shader& shader, aladdin_3d::Camera& camera)
+	{
+		// Depth passes only need the world matrices, which do not depend on the camera.
+		this->graph.updateWorld();
+
+		// Go over all nodes and draw the depth of the mesh of each one
+		for (int i = 0; i < (int) this->graph.getNodeCount(); i++)
+		{
+			int geometry = this->graph.getNode(i).geometry;
+			if (geometry < 0) continue;
+
+			geoms[geometry].drawDepth(shader, camera, this->graph.getWorld(i));
+		}
+	}
+
+	void Object::drawInstanced(aladdin_3d::Shader& shader, aladdin_3d::Camera& camera, aladdin_3d::VBO& instances, GLsizei count)
+	{
+		// Measure the whole object.
+		ProfilerScope scope("Object::drawInstanced", true);
+
+		this->graph.update(camera.getView());
+
+		// Go over all nodes and draw all the instances of the mesh of each one
+		for (int i = 0; i < (int) this->graph.getNodeCount(); i++)
 		{
-			geoms[i].draw(shader, camera);
+			int geometry = this->graph.getNode(i).geometry;
+			if (geometry < 0) continue;
+
+			this->graph.bindNode(shader, i);
+			geoms[geometry].drawInstanced(shader, camera, instances, count, this->graph.getWorld(i));
 		}
 	}
 
 	BoundingBox Object::getBoundingBox() {
 
-		// Create the bb.
-		BoundingBox global_bb = this->geoms[0].getBoundingBox();
+		// Place the boxes with the nodes, but leave the root of the object out.
+		this->graph.updateWorld();
+		glm::mat4 to_object = glm::inverse(this->graph.getWorld(0));
 
-		// Loop through the vertices and get tge min and max values.
-		for (int i = 1; i < this->geoms.size(); i++) {
+		BoundingBox global_bb;
+		bool first = true;
 
-			// Get the current bb.
-			BoundingBox bb = this->geoms[i].getBoundingBox();
+		for (int i = 0; i < (int) this->graph.getNodeCount(); i++) {
 
-			if (global_bb.min.x > bb.min.x)
-				global_bb.min.x = bb.min.x;
+			int geometry = this->graph.getNode(i).geometry;
+			if (geometry < 0) continue;
 
-			if (global_bb.min.y > bb.min.y)
-				global_bb.min.y = bb.min.y;
+			// Get the current bb, and grow the global one with its corners.
+			BoundingBox bb = this->geoms[geometry].getBoundingBox();
+			glm::mat4 matrix = to_object * this->graph.getWorld(i);
 
-			if (global_bb.min.z > bb.min.z)
-				global_bb.min.z = bb.min.z;
+			for (int c = 0; c < 8; c++) {
 
-			if (global_bb.max.x < bb.max.x)
-				global_bb.max.x = bb.max.x;
+				glm::vec3 corner((c & 1) ? bb.max.x : bb.min.x, (c & 2) ? bb.max.y : bb.min.y, (c & 4) ? bb.max.z : bb.min.z);
+				corner = glm::vec3(matrix * glm::vec4(corner, 1.0f));
 
-			if (global_bb.max.y < bb.max.y)
-				global_bb.max.y = bb.max.y;
+				global_bb.min = first ? corner : glm::min(global_bb.min, corner);
+				global_bb.max = first ? corner : glm::max(global_bb.max, corner);
+				first = false;
 
-			if (global_bb.max.z < bb.max.z)
-				global_bb.max.z = bb.max.z;
+			}
+
+		}
+
+		if (first) {
+
+			global_bb.min = glm::vec3(0.0f);
+			global_bb.max = glm::vec3(0.0f);
 
 		}
 
@@ -119,7 +187,20 @@ namespace aladdin_3d {
 
 	std::vector<glm::mat4> Object::getGeometryMatrices() {
 
-		return this->matrices_geoms;
+		this->graph.updateWorld();
+
+		std::vector<glm::mat4> matrices;
+
+		for (size_t i = 0; i < this->geometry_nodes.size(); i++)
+			matrices.push_back(this->graph.getWorld(this->geometry_nodes[i]));
+
+		return matrices;
+
+	}
+
+	SceneGraph& Object::getSceneGraph() {
+
+		return this->graph;
 
 	}
 
@@ -133,63 +214,77 @@ namespace aladdin_3d {
 
 	void Object::resetTransforms() {
 
-		// Do the same for the subobjects.
-		for (size_t i = 0; i < geoms.size(); i++) {
+		this->setTransform(glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f));
+
+	}
 
-			geoms[i].resetTransforms();
+	void Object::setTransform(const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale) {
 
-		}
+		this->graph.setTransform(0, translation, rotation, scale);
 
 	}
 
 	void Object::rotate(float x, float y, float z, float angle) {
 
-		// Do the same for the subobjects.
-		for (size_t i = 0; i < geoms.size(); i++) {
-
-			geoms[i].rotate(x, y, z, angle);
-
-		}
+		// Rotate the root, and everything below it follows.
+		this->rotateNode(0, glm::vec3(x, y, z), angle);
 
 	}
 
 	void Object::rotate(int num, float x, float y, float z, float angle) {
 
-		geoms[num].rotate(x, y, z, angle);
+		this->rotateNode(this->geometry_nodes[num], glm::vec3(x, y, z), angle);
 
 	}
 
 	void Object::scale(float x, float y, float z) {
 
-		// Do the same for the subobjects.
-		for (size_t i = 0; i < geoms.size(); i++) {
-
-			geoms[i].scale(x, y, z);
-
-		}
+		this->scaleNode(0, glm::vec3(x, y, z));
 
 	}
 
 	void Object::scale(int num, float x, float y, float z) {
 
-		geoms[num].scale(x, y, z);
+		this->scaleNode(this->geometry_nodes[num], glm::vec3(x, y, z));
 
 	}
 
 	void Object::translate(float x, float y, float z) {
 
-		// Do the same for the subobjects.
-		for (size_t i = 0; i < geoms.size(); i++) {
+		this->translateNode(0, glm::vec3(x, y, z));
+
+	}
 
-			geoms[i].translate(x, y, z);
+	void Object::translate(int num, float x, float y, float z) {
 
-		}
+		this->translateNode(this->geometry_nodes[num], glm::vec3(x, y, z));
 
 	}
 
-	void Object::translate(int num, float x, float y, float z) {
+	void Object::rotateNode(int node, glm::vec3 axis, float angle) {
+
+		const SceneNode& current = this->graph.getNode(node);
+		glm::quat rotation = current.rotation * glm::angleAxis(glm::radians(angle), glm::normalize(axis));
+
+		this->graph.setTransform(node, current.translation, glm::normalize(rotation), current.scale);
+
+	}
+
+	void Object::scaleNode(int node, glm::vec3 factors) {
+
+		const SceneNode& current = this->graph.getNode(node);
+
+		this->graph.setTransform(node, current.translation, current.rotation, current.scale * factors);
+
+	}
+
+	void Object::translateNode(int node, glm::vec3 offset) {
+
+		// The offset is in the space of the node, after its rotation and scale.
+		const SceneNode& current = this->graph.getNode(node);
+		glm::vec3 translation = current.translation + current.rotation * (current.scale * offset);
 
-		geoms[num].translate(x, y, z);
+		this->graph.setTransform(node, translation, current.rotation, current.scale);
 
 	}
 
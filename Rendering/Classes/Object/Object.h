@@ -3,10 +3,10 @@
  * @brief Object class header file.
  * @version 1.0.0 (2022-10-21)
  * @date 2022-10-21
- * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
  *
  *
- * Copyright (c) Borja Garca Quiroga, All Rights Reserved.
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
  *
  * The information and material provided below was developed as partial
  * requirements for the MSc in Computer Science at Trinity College Dublin,
@@ -22,6 +22,7 @@
 
 #include "Classes/Geometry/Geometry.h"
 #include "Classes/Loader/Loader.h"
+#include "Classes/SceneGraph/SceneGraph.h"
 #include "Structs/BoundingBox/BoundingBox.h"
 
 namespace aladdin_3d {
@@ -56,10 +57,34 @@ namespace aladdin_3d {
 			 */
 			void draw(Shader &shader, Camera &camera);
 
+			/**
+			 * @brief Draws the depth of this object.
+			 *
+			 * Draws only the depth of every geometry, from their positions alone.
+			 *
+			 * @param shader The depth shader.
+			 * @param camera The camera.
+			 */
+			void drawDepth(Shader &shader, Camera &camera);
+
+			/**
+			 * @brief Draws many instances of this object.
+			 *
+			 * Draws many instances of this object, with one instanced draw call
+			 * per geometry.
+			 *
+			 * @param shader The shader, built with instancing.
+			 * @param camera The camera.
+			 * @param instances VBO with one SweepInstance per instance.
+			 * @param count The number of instances.
+			 */
+			void drawInstanced(Shader &shader, Camera &camera, VBO &instances, GLsizei count);
+
 			/**
 			 * @brief Gets the bounding box.
 			 *
-			 * Gets the bounding box of all the geometries.
+			 * Gets the bounding box of all the geometries, placed by their nodes,
+			 * relative to the root of the object.
 			 *
 			 * @returns The bounding box struct.
 			 */
@@ -75,9 +100,18 @@ namespace aladdin_3d {
 			/**
 			 * @brief Get the matrices of the geometries.
 			 * 
-			 * Get the matrices of the geometries.
+			 * Get the world matrix of the first node that draws each geometry.
 			 */
 			std::vector<glm::mat4> getGeometryMatrices();
+
+			/**
+			 * @brief Gets the scene graph.
+			 *
+			 * Gets the nodes that place the geometries. Node 0 is the root of the object.
+			 *
+			 * @returns The scene graph.
+			 */
+			SceneGraph& getSceneGraph();
         
             /**
              * @brief Set the object shininess.
@@ -87,12 +121,24 @@ namespace aladdin_3d {
             void setShininess(float shine);
 
 			/**
-			 * @brief Reset 
+			 * @brief Reset the transforms.
 			 *
-			 * Add a translation matrix to the model.
+			 * Puts the root of the object back at the origin, unrotated and unscaled.
 			 */
 			void resetTransforms();
 
+			/**
+			 * @brief Set the transform of the object.
+			 *
+			 * Set the translation, rotation and scale of the root of the object. Only
+			 * a transform that changed makes the nodes be computed again.
+			 *
+			 * @param translation The translation.
+			 * @param rotation The rotation.
+			 * @param scale The scale.
+			 */
+			void setTransform(const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale);
+
 			/**
 			 * @brief Add a translation matrix to the model.
 			 *
@@ -166,9 +212,42 @@ namespace aladdin_3d {
 
 		private:
 
-			// All the geometries and transformations
+			/**
+			 * @brief Rotates a node.
+			 *
+			 * Composes a rotation after the current transform of a node. It is exact
+			 * while the scale of the node is uniform.
+			 *
+			 * @param node Index of the node.
+			 * @param axis The rotation axis.
+			 * @param angle The angle to rotate, in degrees.
+			 */
+			void rotateNode(int node, glm::vec3 axis, float angle);
+
+			/**
+			 * @brief Scales a node.
+			 *
+			 * Composes a scale after the current transform of a node.
+			 *
+			 * @param node Index of the node.
+			 * @param factors The scale along each axis.
+			 */
+			void scaleNode(int node, glm::vec3 factors);
+
+			/**
+			 * @brief Translates a node.
+			 *
+			 * Composes a translation after the current transform of a node.
+			 *
+			 * @param node Index of the node.
+			 * @param offset The translation.
+			 */
+			void translateNode(int node, glm::vec3 offset);
+
+			// All the geometries and the nodes that place them
 			std::vector<Geometry> geoms;
-			std::vector<glm::mat4> matrices_geoms;
+			SceneGraph graph;
+			std::vector<int> geometry_nodes;	/// First node drawing each geometry.
 
 	};
 
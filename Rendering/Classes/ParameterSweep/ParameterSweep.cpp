@@ -0,0 +1,164 @@
+/**
+ * @file ParameterSweep.cpp
+ * @brief ParameterSweep class implementation file.
+ * @version 1.0.0 (2023-02-23)
+ * @date 2023-02-23
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "ParameterSweep.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Classes/Geometry/Geometry.h"
+#include "Classes/Texture/Texture.h"
+#include "Structs/Vertex/Vertex.h"
+
+namespace aladdin_3d {
+
+	ParameterSweep::ParameterSweep() {}
+
+	void ParameterSweep::setGrid(int columns, int rows, glm::vec2 column_range, glm::vec2 row_range) {
+
+		columns = std::max(columns, 1);
+		rows = std::max(rows, 1);
+
+		// Nothing to do if the grid is the same.
+		if (!this->dirty && columns == this->columns && rows == this->rows && column_range == this->column_range && row_range == this->row_range)
+			return;
+
+		this->columns = columns;
+		this->rows = rows;
+		this->column_range = column_range;
+		this->row_range = row_range;
+
+		// Square cells, fitting the largest side of the grid in the extent.
+		float cell = SWEEP_GRID_EXTENT / std::max(columns, rows);
+		float scale = cell * SWEEP_CELL_FILL;
+
+		this->data.resize((size_t) columns * rows);
+
+		for (int row = 0; row < rows; row++) {
+
+			for (int column = 0; column < columns; column++) {
+
+				// Where this cell is in each range, the first parameter grows to the
+				// right and the second one upwards.
+				float u = columns > 1 ? (float) column / (columns - 1) : 0.0f;
+				float v = rows > 1 ? (float) row / (rows - 1) : 0.0f;
+
+				SweepInstance& instance = this->data[(size_t) row * columns + column];
+				instance.placement = glm::vec4((column - (columns - 1) * 0.5f) * cell, (row - (rows - 1) * 0.5f) * cell, 0.0f, scale);
+				instance.parameters = glm::vec2(column_range.x + (column_range.y - column_range.x) * u, row_range.x + (row_range.y - row_range.x) * v);
+
+			}
+
+		}
+
+		this->dirty = true;
+
+	}
+
+	void ParameterSweep::draw(Object& object, Shader& shader, Camera& camera) {
+
+		if (this->data.empty())
+			return;
+
+		// Upload the grid if it changed. The buffer only grows, so it keeps its
+		// ID and the attributes linked to it stay valid.
+		if (this->dirty) {
+
+			size_t size = this->data.size() * sizeof(SweepInstance);
+
+			if (size > this->capacity) {
+
+				this->instances.setData(this->data.data(), size);
+				this->capacity = size;
+
+			} else {
+
+				this->instances.updateData(this->data.data(), size);
+
+			}
+
+			this->instances.unbind();
+			this->dirty = false;
+
+		}
+
+		object.drawInstanced(shader, camera, this->instances, this->getCount());
+
+	}
+
+	GLsizei ParameterSweep::getCount() {
+
+		return (GLsizei) this->data.size();
+
+	}
+
+	void ParameterSweep::remove() {
+
+		this->instances.remove();
+		this->capacity = 0;
+		this->dirty = true;
+
+	}
+
+	Object ParameterSweep::buildSphere() {
+
+		std::vector<Vertex> vertices;
+		std::vector<GLuint> indices;
+		const float pi = 3.1415926535897932384626433832795f;
+
+		// Rings of vertices from the north to the south pole, with a repeated seam
+		// so the UVs wrap.
+		for (int stack = 0; stack <= SWEEP_SPHERE_STACKS; stack++) {
+
+			float theta = pi * stack / SWEEP_SPHERE_STACKS;
+
+			for (int slice = 0; slice <= SWEEP_SPHERE_SLICES; slice++) {
+
+				float phi = 2.0f * pi * slice / SWEEP_SPHERE_SLICES;
+				glm::vec3 normal(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+
+				Vertex vertex;
+				vertex.position = normal * 0.5f;
+				vertex.normal = normal;
+				vertex.color = glm::vec3(0.8f, 0.8f, 0.8f);
+				vertex.uv = glm::vec2((float) slice / SWEEP_SPHERE_SLICES, 1.0f - (float) stack / SWEEP_SPHERE_STACKS);
+				vertices.push_back(vertex);
+
+			}
+
+		}
+
+		// Two triangles between each pair of rings.
+		for (int stack = 0; stack < SWEEP_SPHERE_STACKS; stack++) {
+
+			for (int slice = 0; slice < SWEEP_SPHERE_SLICES; slice++) {
+
+				GLuint top = stack * (SWEEP_SPHERE_SLICES + 1) + slice;
+				GLuint bottom = top + SWEEP_SPHERE_SLICES + 1;
+
+				indices.insert(indices.end(), { top, top + 1, bottom });
+				indices.insert(indices.end(), { top + 1, bottom + 1, bottom });
+
+			}
+
+		}
+
+		Geometry sphere(vertices, indices, std::vector<Texture>(), 50.0f);
+
+		return Object(std::vector<Geometry>(1, sphere));
+
+	}
+
+} // namespace aladdin_3d
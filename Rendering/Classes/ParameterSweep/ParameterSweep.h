@@ -0,0 +1,126 @@
+/**
+ * @file ParameterSweep.h
+ * @brief ParameterSweep class header file.
+ * @version 1.0.0 (2023-02-23)
+ * @date 2023-02-23
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_PARAMETERSWEEP_H_
+#define ALADDIN_3D_CLASS_PARAMETERSWEEP_H_
+
+#include <vector>
+
+#include "GL/glew.h"
+#include "glm/glm.hpp"
+
+#include "Classes/Camera/Camera.h"
+#include "Classes/Object/Object.h"
+#include "Classes/Shader/Shader.h"
+#include "Classes/VBO/VBO.h"
+#include "Structs/SweepInstance/SweepInstance.h"
+
+#define SWEEP_GRID_EXTENT 2.0	/// Width of the largest side of the grid, in world units.
+#define SWEEP_CELL_FILL 0.85	/// Part of each cell the object fills.
+#define SWEEP_SPHERE_SLICES 48	/// Slices of the sweep sphere.
+#define SWEEP_SPHERE_STACKS 24	/// Stacks of the sweep sphere.
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implements a BRDF parameter sweep.
+	 *
+	 * Implements a grid of instances of an object, each one with its own pair of
+	 * BRDF parameters. The first one goes along the columns and the second one
+	 * along the rows, and the whole grid is drawn with one instanced draw call
+	 * per geometry.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class ParameterSweep {
+
+		public:
+
+			/**
+			 * @brief Constructs the sweep.
+			 *
+			 * Constructs an empty sweep. Nothing is created in OpenGL until it is
+			 * drawn.
+			 */
+			ParameterSweep();
+
+			/**
+			 * @brief Sets the grid.
+			 *
+			 * Sets the size of the grid and the range of each parameter. The
+			 * instance buffer is only rebuilt if something changed.
+			 *
+			 * @param columns Number of columns.
+			 * @param rows Number of rows.
+			 * @param column_range Range of the first parameter, along the columns.
+			 * @param row_range Range of the second parameter, along the rows.
+			 */
+			void setGrid(int columns, int rows, glm::vec2 column_range, glm::vec2 row_range);
+
+			/**
+			 * @brief Draws the sweep.
+			 *
+			 * Draws every instance of the object. The object has to be scaled to a
+			 * unit size and centred, as each instance is scaled and moved to its
+			 * cell after the model matrix.
+			 *
+			 * @param object The object to draw.
+			 * @param shader The shader, built with the INSTANCED define.
+			 * @param camera The camera.
+			 */
+			void draw(Object& object, Shader& shader, Camera& camera);
+
+			/**
+			 * @brief Gets the number of instances.
+			 *
+			 * Gets the number of instances in the grid.
+			 *
+			 * @returns The number of instances.
+			 */
+			GLsizei getCount();
+
+			/**
+			 * @brief Removes the sweep from OpenGL.
+			 *
+			 * Removes the instance buffer from OpenGL.
+			 */
+			void remove();
+
+			/**
+			 * @brief Builds a sphere.
+			 *
+			 * Builds a white UV sphere of unit diameter, centred in the origin, to
+			 * sweep without the details of a model.
+			 *
+			 * @returns The sphere object.
+			 */
+			static Object buildSphere();
+
+		private:
+
+			VBO instances;							/// Instance buffer.
+			std::vector<SweepInstance> data;		/// Instances in the grid.
+			int columns = 0;						/// Number of columns.
+			int rows = 0;							/// Number of rows.
+			glm::vec2 column_range = glm::vec2(0.0f);	/// Range of the first parameter.
+			glm::vec2 row_range = glm::vec2(0.0f);		/// Range of the second parameter.
+			bool dirty = true;						/// Whether the buffer has to be uploaded.
+			size_t capacity = 0;					/// Bytes the instance buffer can hold.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_PARAMETERSWEEP_H_
@@ -0,0 +1,304 @@
+/**
+ * @file Profiler.cpp
+ * @brief Profiler class implementation file.
+ * @version 1.0.0 (2023-02-20)
+ * @date 2023-02-20
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <map>
+
+#include "GL/glew.h"
+#include <imgui/imgui.h>
+
+#include "Classes/TraceRecorder/TraceRecorder.h"
+
+namespace aladdin_3d {
+
+	std::vector<ProfilerFrame> Profiler::history(PROFILER_HISTORY);
+	int Profiler::current_frame = -1;
+	int Profiler::current_slot = -1;
+	int Profiler::frame_range = -1;
+	std::chrono::steady_clock::time_point Profiler::frame_start;
+	std::vector<GLuint> Profiler::queries[PROFILER_FRAMES_IN_FLIGHT];
+	size_t Profiler::used_queries[PROFILER_FRAMES_IN_FLIGHT] = {};
+	std::vector<Profiler::GPURange> Profiler::ranges[PROFILER_FRAMES_IN_FLIGHT];
+	GLint64 Profiler::slot_gpu_clocks[PROFILER_FRAMES_IN_FLIGHT] = { 0 };
+	double Profiler::slot_cpu_clocks[PROFILER_FRAMES_IN_FLIGHT] = { 0.0 };
+	int Profiler::slot_frames[PROFILER_FRAMES_IN_FLIGHT] = {};
+	double Profiler::latest_gpu_ms = 0.0;
+	std::mutex Profiler::mutex;
+
+	void Profiler::beginFrame() {
+
+		// Move to the next slot, whose queries are now old enough to be read.
+		Profiler::current_slot = (Profiler::current_slot + 1) % PROFILER_FRAMES_IN_FLIGHT;
+		Profiler::resolve(Profiler::current_slot);
+
+		// Start a new frame in the history.
+		{
+			std::lock_guard<std::mutex> lock(Profiler::mutex);
+			Profiler::current_frame = (Profiler::current_frame + 1) % PROFILER_HISTORY;
+			Profiler::history[Profiler::current_frame] = ProfilerFrame();
+		}
+
+		Profiler::slot_frames[Profiler::current_slot] = Profiler::current_frame + 1;
+		Profiler::used_queries[Profiler::current_slot] = 0;
+		Profiler::ranges[Profiler::current_slot].clear();
+
+		// Measure the whole frame.
+		Profiler::frame_start = std::chrono::steady_clock::now();
+		Profiler::frame_range = Profiler::beginGPU("Frame");
+
+		// Pair both clocks to put the GPU scopes in the trace timeline.
+		Profiler::slot_gpu_clocks[Profiler::current_slot] = 0;
+
+		if (TraceRecorder::isRecording()) {
+
+			glGetInteger64v(GL_TIMESTAMP, &Profiler::slot_gpu_clocks[Profiler::current_slot]);
+			Profiler::slot_cpu_clocks[Profiler::current_slot] = TraceRecorder::getTime(std::chrono::steady_clock::now());
+
+		}
+
+	}
+
+	void Profiler::endFrame() {
+
+		if (Profiler::current_frame < 0)
+			return;
+
+		Profiler::endGPU(Profiler::frame_range);
+
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - Profiler::frame_start;
+		Profiler::history[Profiler::current_frame].cpu_ms = elapsed.count();
+
+		TraceRecorder::addEvent("Frame", "cpu", TraceRecorder::getTime(Profiler::frame_start), elapsed.count() * 1000.0);
+
+	}
+
+	int Profiler::beginGPU(const std::string& name) {
+
+		if (Profiler::current_slot < 0)
+			return -1;
+
+		// Write the timestamp before the commands of the scope.
+		GPURange range;
+		range.name = name;
+		range.begin = Profiler::nextQuery();
+		glQueryCounter(Profiler::queries[Profiler::current_slot][range.begin], GL_TIMESTAMP);
+
+		Profiler::ranges[Profiler::current_slot].push_back(range);
+
+		return (int) Profiler::ranges[Profiler::current_slot].size() - 1;
+
+	}
+
+	void Profiler::endGPU(int handle) {
+
+		if (handle < 0 || Profiler::current_slot < 0)
+			return;
+
+		// Write the timestamp after the commands of the scope.
+		GPURange& range = Profiler::ranges[Profiler::current_slot][handle];
+		range.end = Profiler::nextQuery();
+		glQueryCounter(Profiler::queries[Profiler::current_slot][range.end], GL_TIMESTAMP);
+
+	}
+
+	void Profiler::addCPU(const std::string& name, double milliseconds) {
+
+		std::lock_guard<std::mutex> lock(Profiler::mutex);
+
+		if (Profiler::current_frame < 0)
+			return;
+
+		ProfilerSample& sample = Profiler::history[Profiler::current_frame].samples[name];
+		sample.cpu_ms += milliseconds;
+		sample.calls++;
+
+	}
+
+	void Profiler::resolve(int slot) {
+
+		int frame = Profiler::slot_frames[slot] - 1;
+
+		if (frame < 0)
+			return;
+
+		ProfilerFrame& record = Profiler::history[frame];
+
+		for (size_t i = 0; i < Profiler::ranges[slot].size(); i++) {
+
+			GPURange& range = Profiler::ranges[slot][i];
+
+			// Scopes that were never ended have no time.
+			if (range.end == 0)
+				continue;
+
+			// These are frames old, so the results are normally there already.
+			GLuint64 begin = 0, end = 0;
+			glGetQueryObjectui64v(Profiler::queries[slot][range.begin], GL_QUERY_RESULT, &begin);
+			glGetQueryObjectui64v(Profiler::queries[slot][range.end], GL_QUERY_RESULT, &end);
+
+			double milliseconds = (end - begin) / 1e6;
+
+			if (range.name == "Frame")
+				record.gpu_ms = Profiler::latest_gpu_ms = milliseconds;
+			else
+				record.samples[range.name].gpu_ms += milliseconds;
+
+			// Add it to the GPU track of the trace.
+			if (Profiler::slot_gpu_clocks[slot] != 0) {
+
+				double start_us = Profiler::slot_cpu_clocks[slot] + ((GLint64) begin - Profiler::slot_gpu_clocks[slot]) / 1e3;
+				TraceRecorder::addEvent(range.name, "gpu", start_us, milliseconds * 1000.0, TRACE_GPU_THREAD);
+
+			}
+
+		}
+
+		record.gpu_resolved = true;
+		Profiler::slot_frames[slot] = 0;
+
+	}
+
+	double Profiler::getLatestGPUTime() {
+
+		return Profiler::latest_gpu_ms;
+
+	}
+
+	size_t Profiler::nextQuery() {
+
+		std::vector<GLuint>& pool = Profiler::queries[Profiler::current_slot];
+		size_t& used = Profiler::used_queries[Profiler::current_slot];
+
+		// Grow the pool when it runs out.
+		if (used == pool.size()) {
+
+			size_t grow = std::max<size_t>(pool.size(), 32);
+			pool.resize(pool.size() + grow);
+			glGenQueries((GLsizei) grow, &pool[pool.size() - grow]);
+
+		}
+
+		return used++;
+
+	}
+
+	void Profiler::drawPanel() {
+
+		// Gather the frames whose GPU times are known, oldest first.
+		std::vector<float> cpu_times, gpu_times;
+		std::map<std::string, ProfilerSample> totals;
+		int averaged = 0;
+
+		for (int i = PROFILER_HISTORY - 1; i >= 0; i--) {
+
+			const ProfilerFrame& frame = Profiler::history[(Profiler::current_frame - i + PROFILER_HISTORY) % PROFILER_HISTORY];
+
+			if (!frame.gpu_resolved)
+				continue;
+
+			cpu_times.push_back((float) frame.cpu_ms);
+			gpu_times.push_back((float) frame.gpu_ms);
+
+		}
+
+		// Add up the scopes of the last frames.
+		for (int i = 0, counted = 0; i < PROFILER_HISTORY && counted < PROFILER_AVERAGE_FRAMES; i++) {
+
+			const ProfilerFrame& frame = Profiler::history[(Profiler::current_frame - i + PROFILER_HISTORY) % PROFILER_HISTORY];
+
+			if (!frame.gpu_resolved)
+				continue;
+
+			for (auto it = frame.samples.begin(); it != frame.samples.end(); it++) {
+
+				totals[it->first].cpu_ms += it->second.cpu_ms;
+				totals[it->first].gpu_ms += it->second.gpu_ms;
+				totals[it->first].calls += it->second.calls;
+
+			}
+
+			counted++;
+			averaged = counted;
+
+		}
+
+		ImGui::Begin("Profiler");
+
+		if (!cpu_times.empty()) {
+
+			// Frame time graphs.
+			char overlay[32];
+			float scale = std::max(*std::max_element(cpu_times.begin(), cpu_times.end()),
+					*std::max_element(gpu_times.begin(), gpu_times.end()));
+
+			snprintf(overlay, sizeof(overlay), "%.2f ms", cpu_times.back());
+			ImGui::PlotLines("CPU frame", cpu_times.data(), (int) cpu_times.size(), 0, overlay, 0.0f, scale, ImVec2(0, 60));
+
+			snprintf(overlay, sizeof(overlay), "%.2f ms", gpu_times.back());
+			ImGui::PlotLines("GPU frame", gpu_times.data(), (int) gpu_times.size(), 0, overlay, 0.0f, scale, ImVec2(0, 60));
+
+		}
+
+		// Average time of each scope per frame.
+		ImGui::Separator();
+		ImGui::Columns(4, "scopes");
+		ImGui::Text("Scope");
+		ImGui::NextColumn();
+		ImGui::Text("CPU ms");
+		ImGui::NextColumn();
+		ImGui::Text("GPU ms");
+		ImGui::NextColumn();
+		ImGui::Text("Calls");
+		ImGui::NextColumn();
+		ImGui::Separator();
+
+		for (auto it = totals.begin(); it != totals.end() && averaged > 0; it++) {
+
+			ImGui::Text("%s", it->first.c_str());
+			ImGui::NextColumn();
+			ImGui::Text("%.3f", it->second.cpu_ms / averaged);
+			ImGui::NextColumn();
+			ImGui::Text("%.3f", it->second.gpu_ms / averaged);
+			ImGui::NextColumn();
+			ImGui::Text("%.1f", (float) it->second.calls / averaged);
+			ImGui::NextColumn();
+
+		}
+
+		ImGui::Columns(1);
+		ImGui::End();
+
+	}
+
+	void Profiler::remove() {
+
+		for (int i = 0; i < PROFILER_FRAMES_IN_FLIGHT; i++) {
+
+			if (!Profiler::queries[i].empty())
+				glDeleteQueries((GLsizei) Profiler::queries[i].size(), Profiler::queries[i].data());
+
+			Profiler::queries[i].clear();
+			Profiler::ranges[i].clear();
+			Profiler::slot_frames[i] = 0;
+
+		}
+
+		Profiler::current_slot = -1;
+
+	}
+
+} // namespace aladdin_3d
@@ -0,0 +1,172 @@
+/**
+ * @file Profiler.h
+ * @brief Profiler class header file.
+ * @version 1.0.0 (2023-02-20)
+ * @date 2023-02-20
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_PROFILER_H_
+#define ALADDIN_3D_CLASS_PROFILER_H_
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "GL/glew.h"
+
+#include "Structs/ProfilerFrame/ProfilerFrame.h"
+
+#define PROFILER_HISTORY 240			/// Frames kept in the ring buffer.
+#define PROFILER_FRAMES_IN_FLIGHT 3		/// Frames before the GPU timestamps are read back.
+#define PROFILER_AVERAGE_FRAMES 60		/// Frames averaged in the breakdown.
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implements the frame profiler.
+	 *
+	 * Implements the collection of CPU and GPU times per named scope and frame,
+	 * kept in a ring buffer and shown in an ImGui panel. GPU scopes are measured
+	 * with pairs of GL_TIMESTAMP queries rather than GL_TIME_ELAPSED ones, since
+	 * those cannot be nested. The queries of each frame are read back
+	 * PROFILER_FRAMES_IN_FLIGHT frames later, so the CPU never waits for them.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class Profiler {
+
+		public:
+
+			/**
+			 * @brief Starts a frame.
+			 *
+			 * Reads back the GPU times of an old frame and starts measuring a new
+			 * one. Call it from the OpenGL thread.
+			 */
+			static void beginFrame();
+
+			/**
+			 * @brief Ends the frame.
+			 *
+			 * Ends measuring the current frame.
+			 */
+			static void endFrame();
+
+			/**
+			 * @brief Starts a GPU scope.
+			 *
+			 * Writes a timestamp query before the next commands.
+			 *
+			 * @param name Name of the scope.
+			 *
+			 * @returns The handle of the scope, to end it.
+			 */
+			static int beginGPU(const std::string& name);
+
+			/**
+			 * @brief Ends a GPU scope.
+			 *
+			 * Writes a timestamp query after the commands of the scope.
+			 *
+			 * @param handle Handle returned by beginGPU().
+			 */
+			static void endGPU(int handle);
+
+			/**
+			 * @brief Adds CPU time to a scope.
+			 *
+			 * Adds CPU time to a scope in the current frame. It can be called
+			 * from any thread.
+			 *
+			 * @param name Name of the scope.
+			 * @param milliseconds Time spent.
+			 */
+			static void addCPU(const std::string& name, double milliseconds);
+
+			/**
+			 * @brief Draws the profiler panel.
+			 *
+			 * Draws the ImGui panel with the frame time graphs and the time spent
+			 * in each scope, averaged over the last frames.
+			 */
+			static void drawPanel();
+
+			/**
+			 * @brief Gets the latest GPU frame time.
+			 *
+			 * Gets the GPU time of the frame read back by the last beginFrame(),
+			 * PROFILER_FRAMES_IN_FLIGHT frames old.
+			 *
+			 * @returns The time in milliseconds, 0 if none has been read yet.
+			 */
+			static double getLatestGPUTime();
+
+			/**
+			 * @brief Deletes the queries.
+			 *
+			 * Deletes the OpenGL queries. Call it before destroying the context.
+			 */
+			static void remove();
+
+		private:
+
+			/**
+			 * @brief A GPU scope waiting to be read back.
+			 *
+			 * The queries around a GPU scope.
+			 */
+			struct GPURange {
+
+				std::string name;	// Name of the scope.
+				size_t begin = 0;	// Query before the scope.
+				size_t end = 0;		// Query after the scope.
+
+			};
+
+			/**
+			 * @brief Reads back the GPU times of a frame.
+			 *
+			 * Reads back the timestamps written in a slot and stores the times in
+			 * its frame.
+			 *
+			 * @param slot Slot of the frame.
+			 */
+			static void resolve(int slot);
+
+			/**
+			 * @brief Gets a free query of the current slot.
+			 *
+			 * Gets a free query of the current slot, creating more if needed.
+			 *
+			 * @returns The index of the query in the slot.
+			 */
+			static size_t nextQuery();
+
+			static std::vector<ProfilerFrame> history;								/// Ring buffer of frames.
+			static int current_frame;												/// Frame being measured in the history.
+			static int current_slot;												/// Query slot being written.
+			static int frame_range;													/// GPU scope around the whole frame.
+			static std::chrono::steady_clock::time_point frame_start;				/// When the frame started.
+			static std::vector<GLuint> queries[PROFILER_FRAMES_IN_FLIGHT];			/// Timestamp queries of each slot.
+			static size_t used_queries[PROFILER_FRAMES_IN_FLIGHT];					/// Queries written in each slot.
+			static std::vector<GPURange> ranges[PROFILER_FRAMES_IN_FLIGHT];			/// GPU scopes of each slot.
+			static GLint64 slot_gpu_clocks[PROFILER_FRAMES_IN_FLIGHT];				/// GPU time at the start of each slot, 0 if not traced.
+			static double slot_cpu_clocks[PROFILER_FRAMES_IN_FLIGHT];				/// Trace time at the start of each slot.
+			static int slot_frames[PROFILER_FRAMES_IN_FLIGHT];						/// Frame in the history of each slot plus one, 0 if none.
+			static double latest_gpu_ms;											/// GPU time of the latest frame read back.
+			static std::mutex mutex;												/// Guards the CPU samples.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_PROFILER_H_
@@ -0,0 +1,47 @@
+/**
+ * @file ProfilerScope.cpp
+ * @brief ProfilerScope class implementation file.
+ * @version 1.0.0 (2023-02-20)
+ * @date 2023-02-20
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "ProfilerScope.h"
+
+#include "Classes/Profiler/Profiler.h"
+#include "Classes/TraceRecorder/TraceRecorder.h"
+
+namespace aladdin_3d {
+
+	ProfilerScope::ProfilerScope(const std::string& name, bool gpu) : name(name) {
+
+		// Start the GPU scope first, so it does not count the CPU timer.
+		if (gpu)
+			this->gpu_range = Profiler::beginGPU(name);
+
+		this->start = std::chrono::steady_clock::now();
+
+	}
+
+	ProfilerScope::~ProfilerScope() {
+
+		// Stop the CPU timer and add it up.
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - this->start;
+		Profiler::addCPU(this->name, elapsed.count());
+
+		// And to the trace, if one is being captured.
+		TraceRecorder::addEvent(this->name, "cpu", TraceRecorder::getTime(this->start), elapsed.count() * 1000.0);
+
+		// Then close the GPU scope.
+		Profiler::endGPU(this->gpu_range);
+
+	}
+
+} // namespace aladdin_3d
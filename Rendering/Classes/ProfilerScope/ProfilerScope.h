@@ -0,0 +1,67 @@
+/**
+ * @file ProfilerScope.h
+ * @brief ProfilerScope class header file.
+ * @version 1.0.0 (2023-02-20)
+ * @date 2023-02-20
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_PROFILERSCOPE_H_
+#define ALADDIN_3D_CLASS_PROFILERSCOPE_H_
+
+#include <chrono>
+#include <string>
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implements a scoped timer.
+	 *
+	 * Implements a timer that measures from its creation to its destruction and
+	 * adds the time to the Profiler under its name. It can also measure the GPU
+	 * time of the commands issued meanwhile, from the OpenGL thread only.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class ProfilerScope {
+
+		public:
+
+			/**
+			 * @brief Starts the timer.
+			 *
+			 * Starts the timer.
+			 *
+			 * @param name Name of the scope.
+			 * @param gpu Whether to also measure the GPU time.
+			 */
+			ProfilerScope(const std::string& name, bool gpu = false);
+
+			/**
+			 * @brief Stops the timer.
+			 *
+			 * Stops the timer and adds the time to the profiler.
+			 */
+			~ProfilerScope();
+
+			ProfilerScope(const ProfilerScope&) = delete;
+			ProfilerScope& operator=(const ProfilerScope&) = delete;
+
+		private:
+
+			std::string name;									/// Name of the scope.
+			std::chrono::steady_clock::time_point start;		/// When the scope started.
+			int gpu_range = -1;									/// GPU scope handle, -1 if not measured.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_PROFILERSCOPE_H_
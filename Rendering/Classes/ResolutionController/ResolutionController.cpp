@@ -0,0 +1,95 @@
+/**
+ * @file ResolutionController.cpp
+ * @brief ResolutionController class implementation file.
+ * @version 1.0.0 (2023-03-01)
+ * @date 2023-03-01
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "ResolutionController.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace aladdin_3d {
+
+	ResolutionController::ResolutionController(float target_ms, float min_scale, float max_scale) {
+
+		this->target_ms = target_ms;
+		this->min_scale = min_scale;
+		this->max_scale = max_scale;
+		this->reset(max_scale);
+
+	}
+
+	float ResolutionController::getScale() {
+
+		// Round it, but never past the limits.
+		float scale = std::sqrt(this->area);
+		scale = std::round(scale / RESOLUTION_STEP) * RESOLUTION_STEP;
+
+		return std::min(std::max(scale, this->min_scale), this->max_scale);
+
+	}
+
+	float ResolutionController::getTarget() {
+
+		return this->target_ms;
+
+	}
+
+	void ResolutionController::reset(float scale) {
+
+		scale = std::min(std::max(scale, this->min_scale), this->max_scale);
+		this->area = scale * scale;
+		this->integral = 0.0f;
+		this->previous = 0.0f;
+		this->started = false;
+
+	}
+
+	void ResolutionController::setTarget(float target_ms) {
+
+		this->target_ms = std::max(target_ms, 0.1f);
+
+	}
+
+	float ResolutionController::update(double gpu_ms) {
+
+		if (gpu_ms <= 0.0)
+			return this->getScale();
+
+		// Relative error, positive when there is time to spare.
+		float error = (float) (1.0 - gpu_ms / this->target_ms);
+
+		// Small errors are noise, leave the scale alone so it does not wobble.
+		if (std::abs(error) < RESOLUTION_DEADBAND)
+			error = 0.0f;
+
+		// Accumulate the error, limited so it does not keep growing while the scale
+		// is stuck at one of its limits.
+		this->integral = std::min(std::max(this->integral + error, -RESOLUTION_INTEGRAL_LIMIT), RESOLUTION_INTEGRAL_LIMIT);
+
+		float derivative = this->started ? error - this->previous : 0.0f;
+		this->previous = error;
+		this->started = true;
+
+		// The correction is relative, so the area moves by a fraction of itself.
+		float correction = RESOLUTION_KP * error + RESOLUTION_KI * this->integral + RESOLUTION_KD * derivative;
+		correction = std::min(std::max(correction, -0.5f), 0.5f);
+
+		this->area *= 1.0f + correction;
+		this->area = std::min(std::max(this->area, this->min_scale * this->min_scale), this->max_scale * this->max_scale);
+
+		return this->getScale();
+
+	}
+
+} // namespace aladdin_3d
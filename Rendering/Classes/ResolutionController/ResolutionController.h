@@ -0,0 +1,115 @@
+/**
+ * @file ResolutionController.h
+ * @brief ResolutionController class header file.
+ * @version 1.0.0 (2023-03-01)
+ * @date 2023-03-01
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_RESOLUTIONCONTROLLER_H_
+#define ALADDIN_3D_CLASS_RESOLUTIONCONTROLLER_H_
+
+#define RESOLUTION_KP 0.35f				/// Proportional gain, on the relative error of the frame time.
+#define RESOLUTION_KI 0.05f				/// Integral gain.
+#define RESOLUTION_KD 0.10f				/// Derivative gain.
+#define RESOLUTION_INTEGRAL_LIMIT 4.0f	/// Largest accumulated error, so it does not wind up at the limits.
+#define RESOLUTION_DEADBAND 0.05f		/// Relative error that is left alone, so the scale settles.
+#define RESOLUTION_STEP 0.05f			/// The scale is rounded to this, so the targets are not rebuilt every frame.
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implements a dynamic resolution controller.
+	 *
+	 * Implements a PID controller that keeps the GPU time of the frames close to
+	 * a budget by changing the scale the scene is rendered at. The GPU time is
+	 * taken as proportional to the pixels shaded, so the controller works on the
+	 * area and the scale along each side is its square root.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class ResolutionController {
+
+		public:
+
+			/**
+			 * @brief Constructs a controller.
+			 *
+			 * Constructs a controller that starts at full scale.
+			 *
+			 * @param target_ms Budget of each frame in the GPU, in milliseconds.
+			 * @param min_scale Smallest scale along each side.
+			 * @param max_scale Largest scale along each side.
+			 */
+			ResolutionController(float target_ms = 16.0f, float min_scale = 0.5f, float max_scale = 1.0f);
+
+			/**
+			 * @brief Gets the scale.
+			 *
+			 * Gets the current scale along each side, rounded to RESOLUTION_STEP.
+			 *
+			 * @returns The scale.
+			 */
+			float getScale();
+
+			/**
+			 * @brief Gets the budget.
+			 *
+			 * Gets the budget of each frame in the GPU.
+			 *
+			 * @returns The budget in milliseconds.
+			 */
+			float getTarget();
+
+			/**
+			 * @brief Resets the controller.
+			 *
+			 * Forgets the accumulated error and goes back to a scale.
+			 *
+			 * @param scale Scale to start from again.
+			 */
+			void reset(float scale = 1.0f);
+
+			/**
+			 * @brief Sets the budget.
+			 *
+			 * Sets the budget of each frame in the GPU.
+			 *
+			 * @param target_ms The budget in milliseconds.
+			 */
+			void setTarget(float target_ms);
+
+			/**
+			 * @brief Updates the scale.
+			 *
+			 * Feeds the controller with the GPU time of a frame and moves the scale.
+			 * Times that are not positive are ignored.
+			 *
+			 * @param gpu_ms GPU time of the frame, in milliseconds.
+			 *
+			 * @returns The new scale, rounded to RESOLUTION_STEP.
+			 */
+			float update(double gpu_ms);
+
+		private:
+
+			float target_ms;			/// Budget of each frame in the GPU.
+			float min_scale;			/// Smallest scale along each side.
+			float max_scale;			/// Largest scale along each side.
+			float area = 1.0f;			/// Fraction of the pixels rendered.
+			float integral = 0.0f;		/// Accumulated relative error.
+			float previous = 0.0f;		/// Relative error of the previous update.
+			bool started = false;		/// Whether there is a previous error.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_RESOLUTIONCONTROLLER_H_
@@ -0,0 +1,94 @@
+/**
+ * @file SampleCounter.cpp
+ * @brief SampleCounter class implementation file.
+ * @version 1.0.0 (2023-02-28)
+ * @date 2023-02-28
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "SampleCounter.h"
+
+namespace aladdin_3d {
+
+	SampleCounter::SampleCounter() {}
+
+	void SampleCounter::begin() {
+
+		// Create another query when the frame counts more passes than before.
+		size_t slot = this->frame % SAMPLE_COUNTER_LATENCY;
+		std::vector<GLuint>& queries = this->queries[slot];
+
+		if (this->used[slot] == queries.size()) {
+
+			GLuint query = 0;
+			glGenQueries(1, &query);
+			queries.push_back(query);
+
+		}
+
+		glBeginQuery(GL_SAMPLES_PASSED, queries[this->used[slot]]);
+
+	}
+
+	void SampleCounter::end() {
+
+		glEndQuery(GL_SAMPLES_PASSED);
+
+		this->used[this->frame % SAMPLE_COUNTER_LATENCY]++;
+
+	}
+
+	void SampleCounter::endFrame() {
+
+		this->frame++;
+
+		// Add up the passes of the oldest frame before reusing its queries. It is a
+		// few frames old, so the counts are normally there already.
+		size_t slot = this->frame % SAMPLE_COUNTER_LATENCY;
+
+		if (this->used[slot] > 0) {
+
+			this->count = 0;
+
+			for (size_t i = 0; i < this->used[slot]; i++) {
+
+				GLuint64 samples = 0;
+				glGetQueryObjectui64v(this->queries[slot][i], GL_QUERY_RESULT, &samples);
+				this->count += samples;
+
+			}
+
+			this->used[slot] = 0;
+
+		}
+
+	}
+
+	GLuint64 SampleCounter::getCount() {
+
+		return this->count;
+
+	}
+
+	void SampleCounter::remove() {
+
+		for (size_t i = 0; i < SAMPLE_COUNTER_LATENCY; i++) {
+
+			if (!this->queries[i].empty())
+				glDeleteQueries((GLsizei) this->queries[i].size(), this->queries[i].data());
+
+			this->queries[i].clear();
+			this->used[i] = 0;
+
+		}
+
+	}
+
+} // namespace aladdin_3d
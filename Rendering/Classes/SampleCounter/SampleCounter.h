@@ -0,0 +1,101 @@
+/**
+ * @file SampleCounter.h
+ * @brief SampleCounter class header file.
+ * @version 1.0.0 (2023-02-28)
+ * @date 2023-02-28
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_SAMPLECOUNTER_H_
+#define ALADDIN_3D_CLASS_SAMPLECOUNTER_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "GL/glew.h"
+
+#define SAMPLE_COUNTER_LATENCY 3	/// Frames a count is read after, so the CPU never waits for it.
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implements a counter of the shaded samples.
+	 *
+	 * Implements a counter of the samples that pass the depth test between begin()
+	 * and end(), with occlusion queries. A frame can count several passes, each one
+	 * with its own query, and their counts are added up. There are queries for a
+	 * few frames in flight, and those of a frame are read when its slot comes round
+	 * again.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class SampleCounter {
+
+		public:
+
+			/**
+			 * @brief Constructs a counter.
+			 *
+			 * Constructs a counter. The queries are created the first time they are
+			 * needed.
+			 */
+			SampleCounter();
+
+			/**
+			 * @brief Begins counting.
+			 *
+			 * Begins counting the samples of a pass of this frame. Only one counter
+			 * can be counting at a time.
+			 */
+			void begin();
+
+			/**
+			 * @brief Ends counting.
+			 *
+			 * Ends counting the samples of the pass.
+			 */
+			void end();
+
+			/**
+			 * @brief Finishes the frame.
+			 *
+			 * Finishes counting this frame and reads the count of the frame that
+			 * used the next slot before. Call it once per frame, after the last pass.
+			 */
+			void endFrame();
+
+			/**
+			 * @brief Gets the count.
+			 *
+			 * Gets the latest count that has been read, a few frames old.
+			 *
+			 * @returns The number of samples.
+			 */
+			GLuint64 getCount();
+
+			/**
+			 * @brief Removes the counter.
+			 *
+			 * Removes the queries from OpenGL.
+			 */
+			void remove();
+
+		private:
+
+			std::vector<GLuint> queries[SAMPLE_COUNTER_LATENCY];	/// Queries of each frame in flight.
+			size_t used[SAMPLE_COUNTER_LATENCY] = {};				/// Queries each frame has a count in.
+			size_t frame = 0;										/// Frames counted so far.
+			GLuint64 count = 0;								/// Latest count read.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_SAMPLECOUNTER_H_
@@ -0,0 +1,452 @@
+/**
+ * @file SceneGraph.cpp
+ * @brief SceneGraph class implementation file.
+ * @version 1.0.0 (2023-03-03)
+ * @date 2023-03-03
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "SceneGraph.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+namespace aladdin_3d {
+
+	// Each lane holds the same element of the matrices of four different nodes.
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+	typedef float32x4_t Lanes;
+
+	static inline Lanes lanesLoad(const float* source) { return vld1q_f32(source); }
+	static inline void lanesStore(float* target, Lanes a) { vst1q_f32(target, a); }
+	static inline Lanes lanesSet(float value) { return vdupq_n_f32(value); }
+	static inline Lanes lanesAdd(Lanes a, Lanes b) { return vaddq_f32(a, b); }
+	static inline Lanes lanesSub(Lanes a, Lanes b) { return vsubq_f32(a, b); }
+	static inline Lanes lanesMul(Lanes a, Lanes b) { return vmulq_f32(a, b); }
+	static inline Lanes lanesReciprocal(Lanes a) {
+		Lanes estimate = vrecpeq_f32(a);
+		estimate = vmulq_f32(estimate, vrecpsq_f32(a, estimate));
+		return vmulq_f32(estimate, vrecpsq_f32(a, estimate));
+	}
+
+#elif defined(__SSE2__)
+
+	typedef __m128 Lanes;
+
+	static inline Lanes lanesLoad(const float* source) { return _mm_loadu_ps(source); }
+	static inline void lanesStore(float* target, Lanes a) { _mm_storeu_ps(target, a); }
+	static inline Lanes lanesSet(float value) { return _mm_set1_ps(value); }
+	static inline Lanes lanesAdd(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+	static inline Lanes lanesSub(Lanes a, Lanes b) { return _mm_sub_ps(a, b); }
+	static inline Lanes lanesMul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+	static inline Lanes lanesReciprocal(Lanes a) { return _mm_div_ps(_mm_set1_ps(1.0f), a); }
+
+#else
+
+	struct Lanes { float v[4]; };
+
+	static inline Lanes lanesLoad(const float* source) { return Lanes{ { source[0], source[1], source[2], source[3] } }; }
+	static inline void lanesStore(float* target, Lanes a) { for (int i = 0; i < 4; i++) target[i] = a.v[i]; }
+	static inline Lanes lanesSet(float value) { return Lanes{ { value, value, value, value } }; }
+	static inline Lanes lanesAdd(Lanes a, Lanes b) { for (int i = 0; i < 4; i++) a.v[i] += b.v[i]; return a; }
+	static inline Lanes lanesSub(Lanes a, Lanes b) { for (int i = 0; i < 4; i++) a.v[i] -= b.v[i]; return a; }
+	static inline Lanes lanesMul(Lanes a, Lanes b) { for (int i = 0; i < 4; i++) a.v[i] *= b.v[i]; return a; }
+	static inline Lanes lanesReciprocal(Lanes a) { for (int i = 0; i < 4; i++) a.v[i] = 1.0f / a.v[i]; return a; }
+
+#endif
+
+	SceneGraph::SceneGraph() {}
+
+	SceneGraph::SceneGraph(const SceneGraph& other) {
+
+		*this = other;
+
+	}
+
+	SceneGraph& SceneGraph::operator=(const SceneGraph& other) {
+
+		if (this == &other)
+			return *this;
+
+		this->nodes = other.nodes;
+		this->worlds = other.worlds;
+		this->blocks = other.blocks;
+		this->dirty = other.dirty;
+		this->moved = other.moved;
+		this->stale = other.stale;
+		this->uniform = other.uniform;
+		this->view = other.view;
+		this->has_view = other.has_view;
+		this->similar_view = other.similar_view;
+		this->stride = other.stride;
+		this->updated = other.updated;
+
+		// The buffer stays with the other graph, so this one uploads everything
+		// to a new one.
+		this->buffer = 0;
+		this->buffer_nodes = 0;
+		this->first_changed = 0;
+		this->last_changed = this->nodes.size();
+
+		return *this;
+
+	}
+
+	int SceneGraph::addNode(const SceneNode& node) {
+
+		// Parents come first, so a single pass in order sees them updated.
+		if (node.parent >= (int) this->nodes.size()) {
+
+			std::cerr << "SceneGraph error - The parent of a node has to be added before it." << std::endl;
+			return -1;
+
+		}
+
+		this->nodes.push_back(node);
+		this->worlds.push_back(glm::mat4(1.0f));
+		this->dirty.push_back(1);
+		this->moved.push_back(0);
+		this->stale.push_back(1);
+		this->uniform.push_back(1);
+
+		return (int) this->nodes.size() - 1;
+
+	}
+
+	void SceneGraph::bindNode(Shader& shader, int index) {
+
+		if (this->buffer == 0)
+			return;
+
+		// Point the block of the shader to the binding, only the first time for each
+		// variant, then the binding to the node.
+		shader.bindUniformBlock("NodeMatrices", SCENE_GRAPH_BINDING);
+
+		glBindBufferRange(GL_UNIFORM_BUFFER, SCENE_GRAPH_BINDING, this->buffer, index * this->stride * sizeof(float),
+				SCENE_GRAPH_BLOCK_FLOATS * sizeof(float));
+
+	}
+
+	void SceneGraph::computeViewMatrices(const std::vector<int>& batch) {
+
+		// Every lane is multiplied by the same view, so its elements are spread once.
+		Lanes view_lanes[16];
+		const float* view_values = glm::value_ptr(this->view);
+
+		for (int i = 0; i < 16; i++)
+			view_lanes[i] = lanesSet(view_values[i]);
+
+		for (size_t first = 0; first < batch.size(); first += 4) {
+
+			size_t count = std::min((size_t) 4, batch.size() - first);
+
+			// Gather the world matrices of four nodes, element by element. Missing
+			// lanes repeat the last node and are not written back.
+			alignas(16) float worlds_soa[16][4];
+			bool uniform_scale = this->similar_view;
+
+			for (size_t lane = 0; lane < 4; lane++) {
+
+				int node = batch[first + std::min(lane, count - 1)];
+				const float* world = glm::value_ptr(this->worlds[node]);
+
+				for (int i = 0; i < 16; i++)
+					worlds_soa[i][lane] = world[i];
+
+				uniform_scale = uniform_scale && this->uniform[node];
+
+			}
+
+			// Model-view, column by column, as the view times the world.
+			Lanes model_view[16];
+
+			for (int column = 0; column < 4; column++) {
+
+				Lanes x = lanesLoad(worlds_soa[column * 4 + 0]);
+				Lanes y = lanesLoad(worlds_soa[column * 4 + 1]);
+				Lanes z = lanesLoad(worlds_soa[column * 4 + 2]);
+				Lanes w = lanesLoad(worlds_soa[column * 4 + 3]);
+
+				for (int row = 0; row < 4; row++) {
+
+					Lanes sum = lanesMul(view_lanes[row], x);
+					sum = lanesAdd(sum, lanesMul(view_lanes[4 + row], y));
+					sum = lanesAdd(sum, lanesMul(view_lanes[8 + row], z));
+					model_view[column * 4 + row] = lanesAdd(sum, lanesMul(view_lanes[12 + row], w));
+
+				}
+
+			}
+
+			// Normal matrix, the inverse transpose of the upper 3x3 only.
+			const Lanes* c0 = &model_view[0];
+			const Lanes* c1 = &model_view[4];
+			const Lanes* c2 = &model_view[8];
+			Lanes normal[9];
+
+			if (uniform_scale) {
+
+				// A rotation scaled by s has the rotation divided by s as its inverse
+				// transpose, which is the matrix divided by s squared.
+				Lanes length = lanesAdd(lanesAdd(lanesMul(c0[0], c0[0]), lanesMul(c0[1], c0[1])), lanesMul(c0[2], c0[2]));
+				Lanes inverse = lanesReciprocal(length);
+
+				for (int column = 0; column < 3; column++)
+					for (int row = 0; row < 3; row++)
+						normal[column * 3 + row] = lanesMul(model_view[column * 4 + row], inverse);
+
+			} else {
+
+				// The columns of the inverse transpose are the cross products of the
+				// other two columns, over the determinant.
+				Lanes cross[9];
+
+				for (int row = 0; row < 3; row++) {
+
+					int next = (row + 1) % 3;
+					int last = (row + 2) % 3;
+
+					cross[row] = lanesSub(lanesMul(c1[next], c2[last]), lanesMul(c1[last], c2[next]));
+					cross[3 + row] = lanesSub(lanesMul(c2[next], c0[last]), lanesMul(c2[last], c0[next]));
+					cross[6 + row] = lanesSub(lanesMul(c0[next], c1[last]), lanesMul(c0[last], c1[next]));
+
+				}
+
+				Lanes determinant = lanesAdd(lanesAdd(lanesMul(c0[0], cross[0]), lanesMul(c0[1], cross[1])), lanesMul(c0[2], cross[2]));
+				Lanes inverse = lanesReciprocal(determinant);
+
+				for (int i = 0; i < 9; i++)
+					normal[i] = lanesMul(cross[i], inverse);
+
+			}
+
+			// Scatter the lanes back to the blocks of the nodes. The model-view is
+			// only needed for the normals, the shaders build the position themselves.
+			alignas(16) float normal_out[9][4];
+
+			for (int i = 0; i < 9; i++)
+				lanesStore(normal_out[i], normal[i]);
+
+			for (size_t lane = 0; lane < count; lane++) {
+
+				int node = batch[first + lane];
+				float* block = &this->blocks[node * this->stride];
+
+				for (int column = 0; column < 3; column++) {
+
+					for (int row = 0; row < 3; row++)
+						block[column * 4 + row] = normal_out[column * 3 + row][lane];
+
+					block[column * 4 + 3] = 0.0f;
+
+				}
+
+				block[12] = 0.0f;
+				block[13] = 0.0f;
+				block[14] = 0.0f;
+				block[15] = 1.0f;
+
+				this->first_changed = std::min(this->first_changed, (size_t) node);
+				this->last_changed = std::max(this->last_changed, (size_t) node + 1);
+
+			}
+
+		}
+
+	}
+
+	const SceneNode& SceneGraph::getNode(int index) {
+
+		return this->nodes[index];
+
+	}
+
+	size_t SceneGraph::getNodeCount() {
+
+		return this->nodes.size();
+
+	}
+
+	glm::mat4 SceneGraph::getNormalMatrix(int index) {
+
+		return glm::make_mat4(&this->blocks[index * this->stride]);
+
+	}
+
+	size_t SceneGraph::getUpdatedCount(bool reset) {
+
+		size_t count = this->updated;
+		if (reset) this->updated = 0;
+
+		return count;
+
+	}
+
+	const glm::mat4& SceneGraph::getWorld(int index) {
+
+		return this->worlds[index];
+
+	}
+
+	void SceneGraph::remove() {
+
+		if (this->buffer != 0)
+			glDeleteBuffers(1, &this->buffer);
+
+		this->buffer = 0;
+		this->buffer_nodes = 0;
+
+	}
+
+	void SceneGraph::setTransform(int index, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale) {
+
+		SceneNode& node = this->nodes[index];
+
+		// Setting the same transform every frame leaves the node clean.
+		if (node.translation == translation && node.rotation == rotation && node.scale == scale)
+			return;
+
+		node.translation = translation;
+		node.rotation = rotation;
+		node.scale = scale;
+		this->dirty[index] = 1;
+
+	}
+
+	void SceneGraph::updateWorld() {
+
+		for (size_t i = 0; i < this->nodes.size(); i++) {
+
+			const SceneNode& node = this->nodes[i];
+
+			// A node moves with its parent, which has already been visited.
+			bool changed = this->dirty[i] || (node.parent >= 0 && this->moved[node.parent]);
+			this->moved[i] = changed;
+
+			if (!changed)
+				continue;
+
+			// Translation, then rotation, then scale, as in glTF.
+			glm::mat4 local = glm::translate(glm::mat4(1.0f), node.translation) * glm::mat4_cast(node.rotation);
+			local = glm::scale(local, node.scale);
+
+			this->worlds[i] = node.parent >= 0 ? this->worlds[node.parent] * local : local;
+			this->uniform[i] = node.scale.x == node.scale.y && node.scale.y == node.scale.z && (node.parent < 0 || this->uniform[node.parent]);
+			this->dirty[i] = 0;
+			this->stale[i] = 1;
+			this->updated++;
+
+		}
+
+	}
+
+	void SceneGraph::update(const glm::mat4& view) {
+
+		this->updateWorld();
+
+		// The blocks are aligned as the uniform buffer offsets have to be.
+		if (this->stride == 0) {
+
+			GLint alignment = 0;
+			glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+			size_t align_floats = std::max((size_t) alignment / sizeof(float), (size_t) 1);
+			this->stride = (SCENE_GRAPH_BLOCK_FLOATS + align_floats - 1) / align_floats * align_floats;
+
+		}
+
+		this->blocks.resize(this->nodes.size() * this->stride);
+
+		// A new view makes every normal matrix old.
+		bool new_view = !this->has_view || view != this->view;
+		this->view = view;
+		this->has_view = true;
+
+		// The uniform scale shortcut needs a view that keeps angles too.
+		if (new_view) {
+
+			glm::vec3 x = glm::vec3(view[0]);
+			glm::vec3 y = glm::vec3(view[1]);
+			glm::vec3 z = glm::vec3(view[2]);
+			float length = glm::dot(x, x);
+			float tolerance = 1e-4f * length;
+
+			this->similar_view = std::abs(glm::dot(y, y) - length) <= tolerance && std::abs(glm::dot(z, z) - length) <= tolerance &&
+					std::abs(glm::dot(x, y)) <= tolerance && std::abs(glm::dot(y, z)) <= tolerance && std::abs(glm::dot(z, x)) <= tolerance;
+
+		}
+
+		// Gather the nodes to compute.
+		std::vector<int> batch;
+
+		for (size_t i = 0; i < this->nodes.size(); i++) {
+
+			if (!this->stale[i] && !new_view)
+				continue;
+
+			batch.push_back((int) i);
+			this->stale[i] = 0;
+
+		}
+
+		if (!batch.empty())
+			this->computeViewMatrices(batch);
+
+		this->upload();
+
+	}
+
+	void SceneGraph::upload() {
+
+		// Make the buffer with every block, or again if there are more nodes now.
+		if (this->buffer == 0 || this->buffer_nodes != this->nodes.size()) {
+
+			if (this->buffer == 0)
+				glGenBuffers(1, &this->buffer);
+
+			glBindBuffer(GL_UNIFORM_BUFFER, this->buffer);
+			glBufferData(GL_UNIFORM_BUFFER, this->blocks.size() * sizeof(float), this->blocks.data(), GL_DYNAMIC_DRAW);
+			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+			this->buffer_nodes = this->nodes.size();
+			this->first_changed = this->nodes.size();
+			this->last_changed = 0;
+			return;
+
+		}
+
+		if (this->first_changed >= this->last_changed)
+			return;
+
+		// Only the range that changed, in one update.
+		size_t offset = this->first_changed * this->stride;
+		size_t size = (this->last_changed - this->first_changed) * this->stride;
+
+		glBindBuffer(GL_UNIFORM_BUFFER, this->buffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, offset * sizeof(float), size * sizeof(float), &this->blocks[offset]);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+		this->first_changed = this->nodes.size();
+		this->last_changed = 0;
+
+	}
+
+} // namespace aladdin_3d
@@ -0,0 +1,238 @@
+/**
+ * @file SceneGraph.h
+ * @brief SceneGraph class header file.
+ * @version 1.0.0 (2023-03-03)
+ * @date 2023-03-03
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_SCENEGRAPH_H_
+#define ALADDIN_3D_CLASS_SCENEGRAPH_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "GL/glew.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include "Classes/Shader/Shader.h"
+#include "Structs/SceneNode/SceneNode.h"
+
+#define SCENE_GRAPH_BINDING 2		/// Uniform buffer binding of the matrices of a node.
+#define SCENE_GRAPH_BLOCK_FLOATS 16	/// Floats in the block of a node, its normal matrix.
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implements a scene graph.
+	 *
+	 * Implements a hierarchy of nodes with local transforms. The nodes are kept in
+	 * flat arrays with every parent before its children, so one pass in order
+	 * updates the world matrices, and only the subtrees below a changed node are
+	 * recomputed. The normal matrices of the last view are cached the same way,
+	 * and only rebuilt for moved nodes or when the view changes. They are built
+	 * from the model-view four nodes at a time with SIMD, and kept in a uniform
+	 * buffer that one upload per update refreshes.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class SceneGraph {
+
+		public:
+
+			/**
+			 * @brief Constructs an empty graph.
+			 *
+			 * Constructs a graph with no nodes.
+			 */
+			SceneGraph();
+
+			/**
+			 * @brief Copies a graph.
+			 *
+			 * Copies the nodes and matrices of a graph. The copy gets its own
+			 * uniform buffer the first time it is updated.
+			 *
+			 * @param other The graph to copy.
+			 */
+			SceneGraph(const SceneGraph& other);
+
+			/**
+			 * @brief Copies a graph.
+			 *
+			 * Copies the nodes and matrices of a graph. The uniform buffer of this
+			 * graph has to be removed first, as the copy gets a new one.
+			 *
+			 * @param other The graph to copy.
+			 *
+			 * @returns This graph.
+			 */
+			SceneGraph& operator=(const SceneGraph& other);
+
+			/**
+			 * @brief Adds a node.
+			 *
+			 * Adds a node at the end of the graph. Its parent has to be in the graph
+			 * already, so parents always come before their children.
+			 *
+			 * @param node The node.
+			 *
+			 * @returns The index of the node, -1 if its parent is not in the graph.
+			 */
+			int addNode(const SceneNode& node);
+
+			/**
+			 * @brief Binds the matrices of a node.
+			 *
+			 * Binds the range of the uniform buffer with the normal matrix of a node
+			 * to the NodeMatrices block of a shader.
+			 *
+			 * @param shader The shader.
+			 * @param index Index of the node.
+			 */
+			void bindNode(Shader& shader, int index);
+
+			/**
+			 * @brief Gets a node.
+			 *
+			 * Gets a node with its local transform.
+			 *
+			 * @param index Index of the node.
+			 *
+			 * @returns The node.
+			 */
+			const SceneNode& getNode(int index);
+
+			/**
+			 * @brief Gets the number of nodes.
+			 *
+			 * Gets the number of nodes in the graph.
+			 *
+			 * @returns The number of nodes.
+			 */
+			size_t getNodeCount();
+
+			/**
+			 * @brief Gets the normal matrix of a node.
+			 *
+			 * Gets the inverse transpose of the upper 3x3 of the model-view matrix of
+			 * a node, for the view of the last update().
+			 *
+			 * @param index Index of the node.
+			 *
+			 * @returns The normal matrix.
+			 */
+			glm::mat4 getNormalMatrix(int index);
+
+			/**
+			 * @brief Gets the number of nodes recomputed.
+			 *
+			 * Gets how many world matrices the last updates recomputed since this
+			 * was last reset.
+			 *
+			 * @param reset Whether to start counting again.
+			 *
+			 * @returns The number of matrices.
+			 */
+			size_t getUpdatedCount(bool reset = false);
+
+			/**
+			 * @brief Gets the world matrix of a node.
+			 *
+			 * Gets the world matrix of a node as of the last update.
+			 *
+			 * @param index Index of the node.
+			 *
+			 * @returns The world matrix.
+			 */
+			const glm::mat4& getWorld(int index);
+
+			/**
+			 * @brief Deletes the uniform buffer.
+			 *
+			 * Deletes the uniform buffer of the graph. It is made again on the next
+			 * update.
+			 */
+			void remove();
+
+			/**
+			 * @brief Sets the local transform of a node.
+			 *
+			 * Sets the translation, rotation and scale of a node, marking it dirty
+			 * if they changed.
+			 *
+			 * @param index Index of the node.
+			 * @param translation Translation from the parent.
+			 * @param rotation Rotation.
+			 * @param scale Scale along each local axis.
+			 */
+			void setTransform(int index, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale);
+
+			/**
+			 * @brief Updates the world matrices.
+			 *
+			 * Recomputes the world matrices of the dirty nodes and everything below them.
+			 */
+			void updateWorld();
+
+			/**
+			 * @brief Updates every matrix.
+			 *
+			 * Updates the world matrices, then the normal matrices of the nodes that
+			 * moved, or of all of them if the view is a new one, and
+			 * uploads the ones that changed.
+			 *
+			 * @param view The view matrix.
+			 */
+			void update(const glm::mat4& view);
+
+		private:
+
+			/**
+			 * @brief Computes the view matrices of some nodes.
+			 *
+			 * Computes the normal matrices of the given nodes into their blocks,
+			 * from their model-view, four nodes at a time.
+			 *
+			 * @param batch Indices of the nodes.
+			 */
+			void computeViewMatrices(const std::vector<int>& batch);
+
+			/**
+			 * @brief Uploads the blocks.
+			 *
+			 * Uploads the blocks from the first to the last changed node in a single
+			 * buffer update, making the buffer if needed.
+			 */
+			void upload();
+
+			std::vector<SceneNode> nodes;			/// Local transforms, parents first.
+			std::vector<glm::mat4> worlds;			/// World matrix of each node.
+			std::vector<float> blocks;				/// Normal matrix of each node, one aligned block each.
+			std::vector<unsigned char> dirty;		/// Whether the local transform of each node changed.
+			std::vector<unsigned char> moved;		/// Whether the world matrix of each node changed in the last pass.
+			std::vector<unsigned char> stale;		/// Whether the view matrices of each node are out of date.
+			std::vector<unsigned char> uniform;		/// Whether the world matrix of each node has a uniform scale.
+			glm::mat4 view = glm::mat4(1.0f);		/// View the normal matrices were built for.
+			bool has_view = false;					/// Whether there has been a view yet.
+			bool similar_view = true;				/// Whether the view only rotates, moves and scales uniformly.
+			GLuint buffer = 0;						/// Uniform buffer with the blocks.
+			size_t buffer_nodes = 0;				/// Number of blocks the buffer was made for.
+			size_t stride = 0;						/// Floats from one block to the next.
+			size_t first_changed = 0;				/// First block changed since the last upload.
+			size_t last_changed = 0;				/// One past the last block changed since the last upload.
+			size_t updated = 0;						/// World matrices recomputed since the last reset.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_SCENEGRAPH_H_
@@ -3,10 +3,10 @@
  * @brief Shader class implementation file.
  * @version 1.0.0 (2022-10-21)
  * @date 2022-10-21
- * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
  *
  *
- * Copyright (c) Borja Garca Quiroga, All Rights Reserved.
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
  *
  * The information and material provided below was developed as partial
  * requirements for the MSc in Computer Science at Trinity College Dublin,
@@ -15,11 +15,19 @@
 
 #include "Shader.h"
 
+#include <cstdint>
+#include <cstdio>
 #include <string>
+#include <filesystem>
 #include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <memory>
 #include <sstream>
 #include <iostream>
 #include <exception>
+#include <vector>
 
 #include "GL/glew.h"
 #define GLM_ENABLE_EXPERIMENTAL
@@ -35,9 +43,11 @@ namespace aladdin_3d {
 
     Shader::Shader() {
     
-        this->programID = NULL;
+        this->programID = 0;
 
         this->light = new Light(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec4(0.0f, 0.0f, 0.0f, 0.0f));
+
+        this->variants = std::make_shared<std::map<std::string, ProgramVariant>>();
     
     }
     
@@ -71,84 +81,125 @@ namespace aladdin_3d {
 
         }
 
-        // Convert it to char.
-        const char* vertex_code_char = vertex_source_code.c_str();
-        const char* fragment_code_char = fragment_source_code.c_str();
+        // Paste the shared code in.
+        vertex_source_code = Shader::resolveIncludes(vertex_source_code, std::filesystem::path(vertex_filename).parent_path().string());
+        fragment_source_code = Shader::resolveIncludes(fragment_source_code, std::filesystem::path(fragment_filename).parent_path().string());
 
-        // Create and compile the vertex shader.
-        GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertex, 1, &vertex_code_char, NULL);
-        glCompileShader(vertex);
+        // Keep the sources to build the variants later on.
+        this->vertex_source = vertex_source_code;
+        this->fragment_source = fragment_source_code;
 
-        // Check for errors.
-        std::string error_msg = "";
-        if (!Shader::checkShader(vertex, "VERTEX", &error_msg)) {
+        // Start building the program without any defines. This is the default variant.
+        // It will not block until the program is first used or polled.
+        ProgramVariant variant = Shader::buildProgram(vertex_source_code, fragment_source_code);
+        this->programID = variant.program;
 
-            std::cerr << "Vertex shader error - Could not compile the shader: " << error_msg << std::endl;
-            exit(1);
+        // Copies of this shader share the variants built by any of them.
+        this->variants = std::make_shared<std::map<std::string, ProgramVariant>>();
+        (*this->variants)[""] = variant;
 
-        }
+    }
 
-        // Create and compile the fragment shader.
-        GLuint fragment = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragment, 1, &fragment_code_char, NULL);
-        glCompileShader(fragment);
+    unsigned int Shader::getProgramID() {
 
-        // Check for errors.
-        error_msg = "";
-        if (!Shader::checkShader(fragment, "FRAGMENT", &error_msg)) {
+        return this->programID;
 
-            std::cerr << "Fragment shader error - Could not compile the shader: " << error_msg << std::endl;
-            exit(1);
+    }
 
-        }
+    void Shader::activate() {
 
-        // Create the program and add the vertex and fragment shaders.
-        this->programID = glCreateProgram();
-        glAttachShader(this->programID, vertex);
-        glAttachShader(this->programID, fragment);
+        if (this->programID == 0)
+            throw std::runtime_error("Shader was not initialized.");
 
-        // Link this program and check for program errors.
-        glLinkProgram(this->programID);
-        error_msg = "";
-        if (!Shader::checkShader(this->programID, "PROGRAM", &error_msg)) {
+        // Wait for the program if it is still being built.
+        auto variant = this->variants->find(this->variant_key);
 
-            std::cerr << "Shader program error - Could not link the shaders: " << error_msg << std::endl;
-            exit(1);
+        if (variant != this->variants->end() && !variant->second.ready)
+            Shader::finishProgram(&variant->second);
 
-        }
+        glUseProgram(this->programID);
 
-        // Clean the shaders.
-        // They are in the compiled program now, so clean them.
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
+    }
 
-        /*
-        // Validate the program.
-        glValidateProgram(this->programID);
-        error_msg = "";
-        if (!Shader::checkShader(this->programID, "VALIDATE", &error_msg)) {
+    int Shader::finishes_left = SHADER_FINISHES_PER_FRAME;
 
-            std::cerr << "Shader program error - Could not validate the program: " << error_msg << std::endl;
-            exit(1);
+    void Shader::bindUniformBlock(const std::string& name, unsigned int binding) {
 
-        }
-         */
+        auto variant = this->variants->find(this->variant_key);
+
+        if (variant == this->variants->end())
+            return;
+
+        // Nothing to do if the program already points the block there.
+        std::map<std::string, unsigned int>& bindings = variant->second.block_bindings;
+        auto bound = bindings.find(name);
+
+        if (bound != bindings.end() && bound->second == binding)
+            return;
+
+        // Look the block up once. Programs without it are remembered too.
+        GLuint block = glGetUniformBlockIndex(variant->second.program, name.c_str());
+
+        if (block != GL_INVALID_INDEX)
+            glUniformBlockBinding(variant->second.program, block, binding);
+
+        bindings[name] = binding;
 
     }
 
-    unsigned int Shader::getProgramID() {
+    void Shader::enableParallelCompile() {
 
-        return this->programID;
+        // Let the driver use as many compiler threads as it wants.
+        if (GLEW_KHR_parallel_shader_compile)
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
 
     }
 
-    void Shader::activate() {
+    void Shader::startFrame() {
 
-        if (this->programID == -1)
-            throw std::runtime_error("Shader was not initialized.");
+        Shader::finishes_left = SHADER_FINISHES_PER_FRAME;
 
-        glUseProgram(this->programID);
+    }
+
+    bool Shader::isPending() {
+
+        auto variant = this->variants->find(this->variant_key);
+
+        return variant == this->variants->end() || !variant->second.ready;
+
+    }
+
+    bool Shader::isReady() {
+
+        auto variant = this->variants->find(this->variant_key);
+
+        if (variant == this->variants->end())
+            return false;
+
+        if (variant->second.ready)
+            return true;
+
+        // Without the extension there is no way to ask without blocking, so finish a few per frame.
+        if (GLEW_KHR_parallel_shader_compile) {
+
+            GLint completed = GL_FALSE;
+            glGetProgramiv(variant->second.program, GL_COMPLETION_STATUS_KHR, &completed);
+
+            if (!completed)
+                return false;
+
+        } else {
+
+            if (Shader::finishes_left <= 0)
+                return false;
+
+            Shader::finishes_left--;
+
+        }
+
+        Shader::finishProgram(&variant->second);
+
+        return true;
 
     }
 
@@ -217,7 +268,333 @@ namespace aladdin_3d {
 
     void Shader::remove() {
 
-        glDeleteProgram(this->programID);
+        // Delete every variant that was built, and the shaders of the unfinished ones.
+        for (auto const& variant : *this->variants) {
+
+            if (!variant.second.ready) {
+
+                glDeleteShader(variant.second.vertex);
+                glDeleteShader(variant.second.fragment);
+
+            }
+
+            glDeleteProgram(variant.second.program);
+
+        }
+
+        this->variants->clear();
+
+    }
+
+    void Shader::selectVariant(const std::map<std::string, std::string>& defines) {
+
+        // Build the key from the defines. The map keeps them sorted, so the same set
+        // always yields the same key.
+        std::string key = "";
+        for (auto const& define : defines)
+            key.append(define.first).append("=").append(define.second).append(";");
+
+        this->variant_key = key;
+
+        // Use the variant if it was already built.
+        auto variant = this->variants->find(key);
+
+        if (variant != this->variants->end()) {
+
+            this->programID = variant->second.program;
+            return;
+
+        }
+
+        // Otherwise start building it now and keep it for the next time.
+        std::string vertex_source_code = Shader::injectDefines(this->vertex_source, defines);
+        std::string fragment_source_code = Shader::injectDefines(this->fragment_source, defines);
+
+        ProgramVariant new_variant = Shader::buildProgram(vertex_source_code, fragment_source_code);
+        this->programID = new_variant.program;
+        (*this->variants)[key] = new_variant;
+
+    }
+
+    Shader::ProgramVariant Shader::buildProgram(const std::string& vertex_source_code, const std::string& fragment_source_code) {
+
+        ProgramVariant variant;
+
+        // A program linked on a previous launch with the same sources and driver can be
+        // loaded straight from the cache, skipping the whole compile and link.
+        variant.cache_path = Shader::getBinaryCachePath(vertex_source_code, fragment_source_code);
+
+        if (!variant.cache_path.empty()) {
+
+            variant.program = Shader::loadProgramBinary(variant.cache_path);
+
+            if (variant.program != 0) {
+
+                variant.ready = true;
+                return variant;
+
+            }
+
+        }
+
+        // Otherwise submit the sources. The result is checked and cached when finished.
+        Shader::submitProgram(vertex_source_code, fragment_source_code, &variant);
+
+        return variant;
+
+    }
+
+    void Shader::submitProgram(const std::string& vertex_source_code, const std::string& fragment_source_code, ProgramVariant* variant) {
+
+        // Convert it to char.
+        const char* vertex_code_char = vertex_source_code.c_str();
+        const char* fragment_code_char = fragment_source_code.c_str();
+
+        // Create and compile the vertex shader.
+        variant->vertex = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(variant->vertex, 1, &vertex_code_char, NULL);
+        glCompileShader(variant->vertex);
+
+        // Create and compile the fragment shader.
+        variant->fragment = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(variant->fragment, 1, &fragment_code_char, NULL);
+        glCompileShader(variant->fragment);
+
+        // Create the program and add the vertex and fragment shaders.
+        variant->program = glCreateProgram();
+        glAttachShader(variant->program, variant->vertex);
+        glAttachShader(variant->program, variant->fragment);
+
+        // Ask the driver to keep the binary around so it can be cached.
+        glProgramParameteri(variant->program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+        // Link this program. Errors are not checked here, as that would wait for the driver.
+        glLinkProgram(variant->program);
+
+        variant->ready = false;
+
+    }
+
+    void Shader::finishProgram(ProgramVariant* variant) {
+
+        // Check for errors.
+        std::string error_msg = "";
+        if (!Shader::checkShader(variant->vertex, "VERTEX", &error_msg)) {
+
+            std::cerr << "Vertex shader error - Could not compile the shader: " << error_msg << std::endl;
+            exit(1);
+
+        }
+
+        // Check for errors.
+        error_msg = "";
+        if (!Shader::checkShader(variant->fragment, "FRAGMENT", &error_msg)) {
+
+            std::cerr << "Fragment shader error - Could not compile the shader: " << error_msg << std::endl;
+            exit(1);
+
+        }
+
+        // Check for program errors.
+        error_msg = "";
+        if (!Shader::checkShader(variant->program, "PROGRAM", &error_msg)) {
+
+            std::cerr << "Shader program error - Could not link the shaders: " << error_msg << std::endl;
+            exit(1);
+
+        }
+
+        // Clean the shaders.
+        // They are in the compiled program now, so clean them.
+        glDeleteShader(variant->vertex);
+        glDeleteShader(variant->fragment);
+
+        /*
+        // Validate the program.
+        glValidateProgram(variant->program);
+        error_msg = "";
+        if (!Shader::checkShader(variant->program, "VALIDATE", &error_msg)) {
+
+            std::cerr << "Shader program error - Could not validate the program: " << error_msg << std::endl;
+            exit(1);
+
+        }
+         */
+
+        // Store it for the next launch.
+        if (!variant->cache_path.empty())
+            Shader::saveProgramBinary(variant->program, variant->cache_path);
+
+        variant->vertex = 0;
+        variant->fragment = 0;
+        variant->ready = true;
+
+    }
+
+    std::string Shader::getBinaryCachePath(const std::string& vertex_source_code, const std::string& fragment_source_code) {
+
+        // Some drivers do not support any binary format at all.
+        GLint num_formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
+
+        if (num_formats <= 0)
+            return "";
+
+        // The binary is only valid for the exact same sources on the exact same driver.
+        std::string key = vertex_source_code;
+        key.append(1, '\0').append(fragment_source_code);
+        key.append(1, '\0').append((const char*) glGetString(GL_VENDOR));
+        key.append(1, '\0').append((const char*) glGetString(GL_RENDERER));
+        key.append(1, '\0').append((const char*) glGetString(GL_VERSION));
+
+        // FNV-1a hash of the whole key.
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < key.size(); i++) {
+
+            hash ^= (unsigned char) key[i];
+            hash *= 1099511628211ULL;
+
+        }
+
+        // Build the filename from the hash.
+        std::stringstream path;
+        path << SHADER_BINARY_CACHE_DIR << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+
+        return path.str();
+
+    }
+
+    unsigned int Shader::loadProgramBinary(const std::string& cache_path) {
+
+        // Open the cached file, if any.
+        std::ifstream file_stream(cache_path, std::ios::binary);
+
+        if (!file_stream)
+            return 0;
+
+        // Read the binary format and the binary itself.
+        GLenum format = 0;
+        file_stream.read((char*) &format, sizeof(format));
+
+        if (!file_stream)
+            return 0;
+
+        std::vector<char> binary((std::istreambuf_iterator<char>(file_stream)), std::istreambuf_iterator<char>());
+
+        if (binary.empty())
+            return 0;
+
+        // Hand it to the driver.
+        GLuint program = glCreateProgram();
+        glProgramBinary(program, format, binary.data(), (GLsizei) binary.size());
+
+        // The driver is free to reject it (e.g. after an update), so check it got linked.
+        GLint success = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+
+        if (!success) {
+
+            std::cerr << "Shader warning - Discarding stale program binary " << cache_path << std::endl;
+            glDeleteProgram(program);
+            std::remove(cache_path.c_str());
+            return 0;
+
+        }
+
+        return program;
+
+    }
+
+    void Shader::saveProgramBinary(unsigned int program, const std::string& cache_path) {
+
+        // Get the binary from the driver.
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+        if (length <= 0)
+            return;
+
+        GLenum format = 0;
+        std::vector<char> binary(length);
+        glGetProgramBinary(program, length, NULL, &format, binary.data());
+
+        // Make sure the cache directory exists.
+        std::error_code error;
+        std::filesystem::create_directories(SHADER_BINARY_CACHE_DIR, error);
+
+        // Store the format followed by the binary.
+        std::ofstream file_stream(cache_path, std::ios::binary | std::ios::trunc);
+
+        if (!file_stream) {
+
+            std::cerr << "Shader warning - Could not write the program binary " << cache_path << std::endl;
+            return;
+
+        }
+
+        file_stream.write((const char*) &format, sizeof(format));
+        file_stream.write(binary.data(), binary.size());
+
+    }
+
+    std::string Shader::injectDefines(const std::string& source_code, const std::map<std::string, std::string>& defines) {
+
+        // Build the define lines.
+        std::string define_lines = "";
+        for (auto const& define : defines)
+            define_lines.append("#define ").append(define.first).append(" ").append(define.second).append("\n");
+
+        // The #version directive must stay the first line, so insert them right after it.
+        size_t version = source_code.find("#version");
+
+        if (version == std::string::npos)
+            return define_lines + source_code;
+
+        size_t line_end = source_code.find('\n', version);
+
+        if (line_end == std::string::npos)
+            return source_code + "\n" + define_lines;
+
+        std::string result = source_code;
+        result.insert(line_end + 1, define_lines);
+
+        return result;
+
+    }
+
+    std::string Shader::resolveIncludes(const std::string& source_code, const std::string& directory) {
+
+        std::istringstream stream(source_code);
+        std::string result = "";
+        std::string line;
+
+        while (std::getline(stream, line)) {
+
+            // Keep every line but the includes.
+            size_t start = line.find_first_not_of(" \t");
+            size_t open = line.find('"');
+            size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+
+            if (start == std::string::npos || line.compare(start, 8, "#include") != 0 || close == std::string::npos) {
+
+                result.append(line).append("\n");
+                continue;
+
+            }
+
+            // Read the included file, and its own includes.
+            std::filesystem::path path = std::filesystem::path(directory) / line.substr(open + 1, close - open - 1);
+            std::string included = "";
+            readFileContents(path.string().c_str(), &included);
+
+            if (included.empty())
+                std::cerr << "Shader error - Could not read the included file: " << path.string() << std::endl;
+
+            result.append(Shader::resolveIncludes(included, path.parent_path().string()));
+
+        }
+
+        return result;
 
     }
 
@@ -3,10 +3,10 @@
  * @brief Shader class header file.
  * @version 1.0.0 (2022-10-21)
  * @date 2022-10-21
- * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
  *
  *
- * Copyright (c) Borja Garca Quiroga, All Rights Reserved.
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
  * 
  * The information and material provided below was developed as partial
  * requirements for the MSc in Computer Science at Trinity College Dublin,
@@ -16,10 +16,15 @@
 #ifndef ALADDIN_3D_SHADER_H_
 #define ALADDIN_3D_SHADER_H_
 
+#include <map>
+#include <memory>
 #include <string>
 
 #include "glm/glm.hpp"
 
+#define SHADER_BINARY_CACHE_DIR "ShaderCache"   /// Where the linked program binaries are stored.
+#define SHADER_FINISHES_PER_FRAME 1             /// Programs finished per frame without GL_KHR_parallel_shader_compile.
+
 #include "Classes/Camera/Camera.h"
 #include "Classes/Light/Light.h"
 #include "Classes/Texture/Texture.h"
@@ -32,7 +37,7 @@ namespace aladdin_3d {
      * Implementation of a Shader class to handle loading, activation and
      * errors in vertex and fragment shaders.
      *
-     * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+     * @author Borja García Quiroga <garcaqub@tcd.ie>
      */
 	class Shader {
 
@@ -67,10 +72,62 @@ namespace aladdin_3d {
         /**
          * @brief Activate this shader program.
          * 
-         * Activate this shader program and start using it.
+         * Activate this shader program and start using it. If the selected variant is
+         * still being built, this waits for it.
          */
         void activate();
 
+        /**
+         * @brief Let the driver compile shaders in parallel.
+         *
+         * Let the driver use its own compiler threads if GL_KHR_parallel_shader_compile
+         * is available. Call it once after initializing GLEW.
+         */
+        static void enableParallelCompile();
+
+        /**
+         * @brief Starts a new frame.
+         *
+         * Lets isReady finish up to SHADER_FINISHES_PER_FRAME more programs when the
+         * driver cannot compile them in parallel. Call it once at the start of each frame.
+         */
+        static void startFrame();
+
+        /**
+         * @brief Points a uniform block at a binding point.
+         *
+         * Points a uniform block of the selected variant at a binding point. The block
+         * is only looked up and bound the first time for each variant, as the binding
+         * is kept by the program, so this can be called for every draw.
+         *
+         * @param name The name of the uniform block.
+         * @param binding The binding point.
+         */
+        void bindUniformBlock(const std::string& name, unsigned int binding);
+
+        /**
+         * @brief Checks if the selected variant is still being built.
+         *
+         * Checks if the selected variant has not been finished yet by isReady. Unlike
+         * isReady, it never waits for the driver, so it can be asked at any time.
+         *
+         * @returns True if the program is not ready yet.
+         */
+        bool isPending();
+
+        /**
+         * @brief Checks if the selected variant is ready to be used.
+         *
+         * Checks if the selected variant has finished compiling and linking. With
+         * GL_KHR_parallel_shader_compile this never blocks. Without it, as on macOS,
+         * there is no way to ask, so the program is finished on the spot, blocking until
+         * the driver is done; only SHADER_FINISHES_PER_FRAME programs are finished each
+         * frame and the rest report they are not ready until a later frame.
+         *
+         * @returns True if the program can be used without waiting.
+         */
+        bool isReady();
+
         /**
          * @brief Pass a given bool to the shaders.
          * 
@@ -131,12 +188,38 @@ namespace aladdin_3d {
         /**
          * @brief Remove the shader from OpenGL.
          * 
-         * Remove the shader from OpenGL.
+         * Remove the shader and all its variants from OpenGL.
          */
         void remove();
 
+        /**
+         * @brief Select the variant built with the given defines.
+         *
+         * Select the variant of this shader built with the given defines, which are
+         * injected right after the #version directive. Variants are compiled the first
+         * time they are selected and cached by their defines. Uniforms have to be passed
+         * after selecting the variant, as each one is a separate program.
+         *
+         * @param defines The defines as name and value pairs. Empty for the default variant.
+         */
+        void selectVariant(const std::map<std::string, std::string>& defines);
+
     private:
 
+        /**
+         * @brief A program built from the shader sources with a given set of defines.
+         */
+        struct ProgramVariant {
+
+            unsigned int program = 0;       /// OpenGL ID of the program.
+            unsigned int vertex = 0;        /// Vertex shader, kept until the program is finished.
+            unsigned int fragment = 0;      /// Fragment shader, kept until the program is finished.
+            std::string cache_path = "";    /// Where the program binary is cached.
+            bool ready = false;             /// Whether the program was checked and can be used.
+            std::map<std::string, unsigned int> block_bindings;  /// Uniform blocks already pointed at their binding.
+
+        };
+
         /**
          * @brief Check for errors in the program or shader.
          * 
@@ -150,6 +233,101 @@ namespace aladdin_3d {
          */
         static bool checkShader(unsigned int shader, std::string type, std::string* log_str);
 
+        /**
+         * @brief Builds a program from its sources.
+         *
+         * Builds a program from its sources, going through the program binary cache.
+         * Programs that are not cached are submitted to the driver without waiting.
+         *
+         * @param vertex_source_code The vertex shader source code.
+         * @param fragment_source_code The fragment shader source code.
+         *
+         * @returns The program, which may still be compiling.
+         */
+        static ProgramVariant buildProgram(const std::string& vertex_source_code, const std::string& fragment_source_code);
+
+        /**
+         * @brief Submits a program to the driver.
+         *
+         * Compiles the vertex and fragment shaders and links them into a new program,
+         * without checking the results so the driver does not have to finish them yet.
+         *
+         * @param vertex_source_code The vertex shader source code.
+         * @param fragment_source_code The fragment shader source code.
+         * @param variant Output variant that will hold the program and its shaders.
+         */
+        static void submitProgram(const std::string& vertex_source_code, const std::string& fragment_source_code, ProgramVariant* variant);
+
+        /**
+         * @brief Finishes a submitted program.
+         *
+         * Checks the compile and link results of a submitted program, frees its shaders
+         * and stores its binary in the cache. Blocks until the driver is done.
+         *
+         * @param variant The variant to finish.
+         */
+        static void finishProgram(ProgramVariant* variant);
+
+        /**
+         * @brief Gets the path of the cached program binary.
+         *
+         * Gets the path of the cached binary for these sources. The name is a hash of the
+         * sources and the driver vendor, renderer and version.
+         *
+         * @param vertex_source_code The vertex shader source code.
+         * @param fragment_source_code The fragment shader source code.
+         *
+         * @returns The path of the binary, or an empty string if the driver has no binary formats.
+         */
+        static std::string getBinaryCachePath(const std::string& vertex_source_code, const std::string& fragment_source_code);
+
+        /**
+         * @brief Loads the program from a cached binary.
+         *
+         * Loads the program from a cached binary. Stale binaries rejected by the driver are
+         * deleted.
+         *
+         * @param cache_path The path of the cached binary.
+         *
+         * @returns The OpenGL ID of the program, or 0 if it has to be compiled.
+         */
+        static unsigned int loadProgramBinary(const std::string& cache_path);
+
+        /**
+         * @brief Stores the program binary in the cache.
+         *
+         * Stores the linked program binary in the cache.
+         *
+         * @param program The OpenGL ID of the program.
+         * @param cache_path The path of the cached binary.
+         */
+        static void saveProgramBinary(unsigned int program, const std::string& cache_path);
+
+        /**
+         * @brief Injects defines into a shader source.
+         *
+         * Injects the defines right after the #version directive of the shader source.
+         *
+         * @param source_code The shader source code.
+         * @param defines The defines as name and value pairs.
+         *
+         * @returns The source code with the defines.
+         */
+        static std::string injectDefines(const std::string& source_code, const std::map<std::string, std::string>& defines);
+
+        /**
+         * @brief Resolves the includes of a shader source.
+         *
+         * Replaces every #include "file" line with the contents of that file, relative to
+         * the directory of the including one, so the shaders can share code.
+         *
+         * @param source_code The shader source code.
+         * @param directory Directory of the file the source was read from.
+         *
+         * @returns The source code with the included files.
+         */
+        static std::string resolveIncludes(const std::string& source_code, const std::string& directory);
+
         /**
          * @brief Gets the content of a file as a string.
          *
@@ -163,7 +341,13 @@ namespace aladdin_3d {
         static void readFileContents(const char* filename, std::string *file_contents);
 
         Light* light; /// The light that will be used in the shader.
-        unsigned int programID = -1; /// OpenGL ID for this shader program.
+        unsigned int programID = 0; /// OpenGL ID for the selected variant of this shader program, 0 for none.
+        std::string vertex_source;   /// Vertex shader source code, without defines.
+        std::string fragment_source; /// Fragment shader source code, without defines.
+        std::string variant_key = "";  /// Key of the selected variant.
+        std::shared_ptr<std::map<std::string, ProgramVariant>> variants; /// Programs built so far by their defines.
+
+        static int finishes_left;    /// Programs that can still be finished this frame without the extension.
 
     };
 
@@ -0,0 +1,182 @@
+/**
+ * @file ShadowMap.cpp
+ * @brief ShadowMap class implementation file.
+ * @version 1.0.0 (2023-02-26)
+ * @date 2023-02-26
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "ShadowMap.h"
+
+#include <vector>
+
+#include "glm/gtc/type_ptr.hpp"
+
+namespace aladdin_3d {
+
+	ShadowMap::ShadowMap() {}
+
+	ShadowMap::ShadowMap(int size) {
+
+		// Depth only targets, the cache and the map that is sampled.
+		this->cache = FBO(size, size, std::vector<GLenum>());
+		this->map = FBO(size, size, std::vector<GLenum>());
+
+		// Compare in the sampler, and filter the results of the 4 nearest texels.
+		glBindTexture(GL_TEXTURE_2D, this->map.getDepthTexture());
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+	}
+
+	bool ShadowMap::beginDynamic(uint64_t signature) {
+
+		// Nothing to do if neither the cache nor the dynamic casters changed.
+		if (this->map_valid && signature == this->dynamic_signature)
+			return false;
+
+		this->dynamic_signature = signature;
+		this->map_valid = true;
+		this->dynamic_updates++;
+
+		// Remember where to go back to.
+		glGetIntegerv(GL_VIEWPORT, this->viewport);
+		glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &this->framebuffer);
+
+		// Start from the static casters.
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, this->cache.getID());
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, this->map.getID());
+		glBlitFramebuffer(0, 0, this->cache.getWidth(), this->cache.getHeight(), 0, 0, this->map.getWidth(), this->map.getHeight(), GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+		this->map.bind();
+
+		// Offset the depth to avoid shadow acne.
+		glEnable(GL_POLYGON_OFFSET_FILL);
+		glPolygonOffset(2.0f, 4.0f);
+
+		return true;
+
+	}
+
+	bool ShadowMap::beginStatic(uint64_t signature) {
+
+		// Nothing to do if the light and the static casters did not change.
+		if (this->cache_valid && signature == this->static_signature)
+			return false;
+
+		this->static_signature = signature;
+		this->cache_valid = true;
+		this->map_valid = false;
+		this->static_updates++;
+
+		// Remember where to go back to.
+		glGetIntegerv(GL_VIEWPORT, this->viewport);
+		glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &this->framebuffer);
+
+		// Start from nothing.
+		this->cache.bind();
+		glClear(GL_DEPTH_BUFFER_BIT);
+
+		// Offset the depth to avoid shadow acne.
+		glEnable(GL_POLYGON_OFFSET_FILL);
+		glPolygonOffset(2.0f, 4.0f);
+
+		return true;
+
+	}
+
+	void ShadowMap::bind(Shader& shader, Camera& camera) {
+
+		// From view space of the camera to the [0, 1] coordinates of the map.
+		glm::mat4 bias = glm::mat4(glm::vec4(0.5f, 0.0f, 0.0f, 0.0f), glm::vec4(0.0f, 0.5f, 0.0f, 0.0f),
+								   glm::vec4(0.0f, 0.0f, 0.5f, 0.0f), glm::vec4(0.5f, 0.5f, 0.5f, 1.0f));
+		glm::mat4 shadow_matrix = bias * this->light_matrix * glm::inverse(camera.getView());
+
+		glActiveTexture(GL_TEXTURE0 + SHADOW_MAP_UNIT);
+		glBindTexture(GL_TEXTURE_2D, this->map.getDepthTexture());
+		glActiveTexture(GL_TEXTURE0);
+
+		shader.passInt("shadowMap", SHADOW_MAP_UNIT);
+		glUniformMatrix4fv(glGetUniformLocation(shader.getProgramID(), "shadowMatrix"), 1, GL_FALSE, glm::value_ptr(shadow_matrix));
+
+	}
+
+	void ShadowMap::end() {
+
+		// Go back to where it was.
+		glDisable(GL_POLYGON_OFFSET_FILL);
+		glBindFramebuffer(GL_FRAMEBUFFER, this->framebuffer);
+		glViewport(this->viewport[0], this->viewport[1], this->viewport[2], this->viewport[3]);
+
+	}
+
+	size_t ShadowMap::getDynamicUpdates() {
+
+		return this->dynamic_updates;
+
+	}
+
+	Camera ShadowMap::getLightCamera() {
+
+		Camera camera(this->light_position, glm::normalize(this->light_target - this->light_position), SHADOW_FOV, SHADOW_NEAR, SHADOW_FAR, 1, 1);
+		camera.update();
+
+		return camera;
+
+	}
+
+	size_t ShadowMap::getStaticUpdates() {
+
+		return this->static_updates;
+
+	}
+
+	void ShadowMap::remove() {
+
+		this->map.remove();
+		this->cache.remove();
+		this->cache_valid = this->map_valid = false;
+
+	}
+
+	void ShadowMap::setLight(glm::vec3 position, glm::vec3 target) {
+
+		if (this->light_valid && position == this->light_position && target == this->light_target)
+			return;
+
+		this->light_position = position;
+		this->light_target = target;
+		this->light_valid = true;
+
+		// Look from the light, redrawing everything.
+		this->light_matrix = this->getLightCamera().getCameraMatrix();
+		this->cache_valid = false;
+
+	}
+
+	uint64_t ShadowMap::hash(const void* data, size_t size, uint64_t seed) {
+
+		const unsigned char* bytes = (const unsigned char*) data;
+
+		for (size_t i = 0; i < size; i++) {
+
+			seed ^= bytes[i];
+			seed *= 1099511628211ull;
+
+		}
+
+		return seed;
+
+	}
+
+} // namespace aladdin_3d
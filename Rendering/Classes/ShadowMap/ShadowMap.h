@@ -0,0 +1,192 @@
+/**
+ * @file ShadowMap.h
+ * @brief ShadowMap class header file.
+ * @version 1.0.0 (2023-02-26)
+ * @date 2023-02-26
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_SHADOWMAP_H_
+#define ALADDIN_3D_CLASS_SHADOWMAP_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "GL/glew.h"
+#include "glm/glm.hpp"
+
+#include "Classes/Camera/Camera.h"
+#include "Classes/FBO/FBO.h"
+#include "Classes/Shader/Shader.h"
+
+#define SHADOW_MAP_SIZE 2048		/// Width and height of the shadow map.
+#define SHADOW_MAP_UNIT 10			/// Texture unit of the shadow map.
+#define SHADOW_FOV 40.0f			/// Field of view of the light, enough for the normalized objects.
+#define SHADOW_NEAR 1.0f			/// Near plane of the light.
+#define SHADOW_FAR 10.0f			/// Far plane of the light.
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implements a cached shadow map.
+	 *
+	 * Implements a shadow map for a spot light in two layers. The static casters
+	 * are rendered into a cache that is only redrawn when its signature changes.
+	 * The map that is sampled is that cache plus the dynamic casters, which are
+	 * only redrawn when their own signature changes. A caller describes each layer
+	 * with a hash of whatever places its casters, such as the object or the angle.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class ShadowMap {
+
+		public:
+
+			/**
+			 * @brief Constructs an empty shadow map.
+			 *
+			 * Constructs a shadow map with nothing in OpenGL yet.
+			 */
+			ShadowMap();
+
+			/**
+			 * @brief Constructs a shadow map.
+			 *
+			 * Constructs a shadow map and its static cache.
+			 *
+			 * @param size Width and height in pixels.
+			 */
+			ShadowMap(int size);
+
+			/**
+			 * @brief Starts the dynamic layer.
+			 *
+			 * Starts redrawing the dynamic casters if their signature or the static
+			 * cache changed, copying the cache into the map first. Call end() after
+			 * drawing them.
+			 *
+			 * @param signature Hash of the dynamic casters, 0 if there are none.
+			 *
+			 * @returns Whether the dynamic casters have to be drawn.
+			 */
+			bool beginDynamic(uint64_t signature);
+
+			/**
+			 * @brief Starts the static layer.
+			 *
+			 * Starts redrawing the static cache if its signature or the light
+			 * changed. Call end() after drawing the static casters.
+			 *
+			 * @param signature Hash of the static casters, 0 if there are none.
+			 *
+			 * @returns Whether the static casters have to be drawn.
+			 */
+			bool beginStatic(uint64_t signature);
+
+			/**
+			 * @brief Binds the shadow map to a shader.
+			 *
+			 * Binds the shadow map to the active shader, with the matrix that takes
+			 * view space positions of the camera into it.
+			 *
+			 * @param shader The shader, already activated.
+			 * @param camera The camera the shader draws with.
+			 */
+			void bind(Shader& shader, Camera& camera);
+
+			/**
+			 * @brief Ends a layer.
+			 *
+			 * Ends drawing the casters of a layer, going back to the framebuffer and
+			 * viewport there were before.
+			 */
+			void end();
+
+			/**
+			 * @brief Gets the number of dynamic updates.
+			 *
+			 * Gets how many times the dynamic layer has been redrawn.
+			 *
+			 * @returns The number of updates.
+			 */
+			size_t getDynamicUpdates();
+
+			/**
+			 * @brief Gets the light camera.
+			 *
+			 * Gets a camera to draw the casters from the light.
+			 *
+			 * @returns The camera of the light.
+			 */
+			Camera getLightCamera();
+
+			/**
+			 * @brief Gets the number of static updates.
+			 *
+			 * Gets how many times the static cache has been redrawn.
+			 *
+			 * @returns The number of updates.
+			 */
+			size_t getStaticUpdates();
+
+			/**
+			 * @brief Removes the shadow map.
+			 *
+			 * Removes the map and the cache from OpenGL.
+			 */
+			void remove();
+
+			/**
+			 * @brief Sets the light.
+			 *
+			 * Sets where the light is and where it looks at. Both layers are redrawn
+			 * if it moved.
+			 *
+			 * @param position Position of the light.
+			 * @param target Point the light looks at.
+			 */
+			void setLight(glm::vec3 position, glm::vec3 target);
+
+			/**
+			 * @brief Hashes some data.
+			 *
+			 * Hashes some data with FNV-1a, chaining from a previous hash, to build
+			 * the signatures.
+			 *
+			 * @param data The data.
+			 * @param size Its size in bytes.
+			 * @param seed Previous hash to chain from.
+			 *
+			 * @returns The hash.
+			 */
+			static uint64_t hash(const void* data, size_t size, uint64_t seed = 14695981039346656037ull);
+
+		private:
+
+			FBO map;								/// Map sampled by the shaders.
+			FBO cache;								/// Depth of the static casters.
+			glm::mat4 light_matrix = glm::mat4(1.0f);	/// Projection and view of the light.
+			glm::vec3 light_position = glm::vec3(0.0f);	/// Position of the light.
+			glm::vec3 light_target = glm::vec3(0.0f);	/// Where the light looks at.
+			bool light_valid = false;				/// Whether the light has been set.
+			uint64_t static_signature = 0;			/// Signature of the cached static casters.
+			uint64_t dynamic_signature = 0;			/// Signature of the dynamic casters in the map.
+			bool cache_valid = false;				/// Whether the cache is up to date with the light.
+			bool map_valid = false;					/// Whether the map is up to date with the cache.
+			size_t static_updates = 0;				/// Times the cache has been redrawn.
+			size_t dynamic_updates = 0;				/// Times the dynamic layer has been redrawn.
+			GLint viewport[4] = { 0, 0, 0, 0 };		/// Viewport to go back to.
+			GLint framebuffer = 0;					/// Framebuffer to go back to.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_SHADOWMAP_H_
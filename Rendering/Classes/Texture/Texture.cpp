@@ -3,10 +3,10 @@
  * @brief Texture class implementation file.
  * @version 1.0.0 (2022-10-21)
  * @date 2022-10-21
- * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
  *
  *
- * Copyright (c) Borja Garca Quiroga, All Rights Reserved.
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
  *
  * The information and material provided below was developed as partial
  * requirements for the MSc in Computer Science at Trinity College Dublin,
@@ -17,31 +17,71 @@
 
 #include "Texture.h"
 
-#include <assert.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <thread>
 
 #include "GL/glew.h"
 #include "stb/stb_image.h"
 
+#include "Classes/MipmapGenerator/MipmapGenerator.h"
+#include "Classes/ProfilerScope/ProfilerScope.h"
+#include "Classes/TextureCache/TextureCache.h"
+#include "Classes/TextureContainer/TextureContainer.h"
+#include "Classes/TextureStreamer/TextureStreamer.h"
+#include "Classes/ThreadPool/ThreadPool.h"
+
 namespace aladdin_3d {
 
-	Texture::Texture(const char* image, const char* name, GLuint slot) {
+	std::vector<std::shared_ptr<TextureImage>> Texture::pending;
+	std::vector<GLenum> Texture::supported_formats;
+
+	Texture::Texture(const char* image, const char* name, GLuint slot, bool flip, bool srgb) {
 
-		// Generate a texture in OpenGL and store the parameters in the attributes.
-		glGenTextures(1, &this->ID);
+		// Store the parameters in the attributes.
 		this->name = std::string(name);
 		this->slot = slot;
 
-		// This function has to be used because OpenGL loads texture the opposite way
-		// than this library, so images appear upside down.
-		stbi_set_flip_vertically_on_load(true);
+		// Share the image if another texture already loaded it.
+		std::string key = TextureCache::makeKey(image, flip, srgb);
+		this->image = TextureCache::find(key);
+
+		if (this->image != nullptr)
+			return;
+
+		// Find the container formats the driver can sample, before any worker
+		// needs them.
+		if (Texture::supported_formats.empty())
+			Texture::querySupportedFormats();
+
+		// Otherwise create it. The OpenGL texture is freed with the last handle.
+		this->image = std::shared_ptr<TextureImage>(new TextureImage(), [](TextureImage* image) {
+
+			if (image->fence != 0)
+				glDeleteSync(image->fence);
+			if (image->pbo != 0)
+				glDeleteBuffers(1, &image->pbo);
+
+			glDeleteTextures(1, &image->ID);
+			delete image;
+
+		});
 
-		// Read the texture image and its information.
-		unsigned char* image_bytes = stbi_load(image, &this->texture_width,
-				&this->texture_height, &this->texture_channels, 0);
+		this->image->path = std::string(image);
+		this->image->flip = flip;
+		this->image->srgb = srgb;
+		TextureCache::insert(key, this->image);
+
+		// Generate a texture in OpenGL.
+		glGenTextures(1, &this->image->ID);
 
 		// Set the slot for the texture.
 		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTexture(GL_TEXTURE_2D, this->ID);
+		glBindTexture(GL_TEXTURE_2D, this->image->ID);
 
 		// Configure the magnifying algorithm, minifying algorithm and repetition.
 		// This tells OpenGL how to apply intrpolation.
@@ -50,34 +90,381 @@ namespace aladdin_3d {
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-		// Get the color model for the image.
-		GLenum color_model = GL_RGBA;
+		// Use a white pixel until the image arrives.
+		unsigned char placeholder[4] = { 255, 255, 255, 255 };
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholder);
+		glGenerateMipmap(GL_TEXTURE_2D);
+
+		// Unbinds the OpenGL Texture.
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		// Decode the image in the background. The pending list keeps the image
+		// alive until the worker is done with it.
+		Texture::pending.push_back(this->image);
+		TextureImage* decoding = this->image.get();
+		ThreadPool::getShared().submit([decoding]() { Texture::decode(decoding); });
+
+	}
+
+	void Texture::querySupportedFormats() {
 
-		if (this->texture_channels == 4)
-			color_model = GL_RGBA;
-		else if (this->texture_channels == 3)
-			color_model = GL_RGB;
-		else if (this->texture_channels == 1)
-			color_model = GL_RED;
+		// Plain RGBA is always there.
+		Texture::supported_formats = { GL_RGBA8, GL_SRGB8_ALPHA8, GL_COMPRESSED_RG_RGTC2 };
+
+		if (GLEW_EXT_texture_compression_s3tc) {
+
+			Texture::supported_formats.insert(Texture::supported_formats.end(), {
+				GL_COMPRESSED_RGB_S3TC_DXT1_EXT, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+			});
+
+			if (GLEW_EXT_texture_sRGB)
+				Texture::supported_formats.insert(Texture::supported_formats.end(), {
+					GL_COMPRESSED_SRGB_S3TC_DXT1_EXT, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+				});
+
+		}
+
+		if (GLEW_ARB_texture_compression_bptc)
+			Texture::supported_formats.insert(Texture::supported_formats.end(), {
+				GL_COMPRESSED_RGBA_BPTC_UNORM, GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM
+			});
+
+		if (GLEW_ARB_ES3_compatibility)
+			Texture::supported_formats.insert(Texture::supported_formats.end(), {
+				GL_COMPRESSED_RGB8_ETC2, GL_COMPRESSED_RGBA8_ETC2_EAC
+			});
+
+	}
+
+	void Texture::decode(TextureImage* image) {
+
+		ProfilerScope scope("Texture decode");
+
+		// Use the image itself if it is a container, or a container transcoded
+		// next to it with the same flip and color space, or its mip chain from a
+		// previous launch.
+		std::filesystem::path path(image->path);
+		std::string extension = path.extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+		bool is_container = extension == ".dds" || extension == ".ktx2";
+		std::vector<std::filesystem::path> candidates;
+
+		if (is_container)
+			candidates.push_back(path);
 		else
-			assert(false);
+			candidates = { Texture::getTranscodedPath(image->path, image->flip, image->srgb, ".ktx2"),
+					Texture::getTranscodedPath(image->path, image->flip, image->srgb, ".dds"),
+					std::filesystem::path(Texture::getMipCachePath(image)) };
 
-		// Load the image to OpenGL.
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, this->texture_width, this->texture_height,
-				0, color_model, GL_UNSIGNED_BYTE, image_bytes);
-		glGenerateMipmap(GL_TEXTURE_2D);
+		for (size_t i = 0; i < candidates.size(); i++) {
+
+			std::error_code error;
+
+			if (!std::filesystem::exists(candidates[i], error))
+				continue;
+
+			GLenum format = 0;
+			std::vector<TextureLevel> levels;
+
+			{
+				ProfilerScope read_scope("Texture container read");
+
+				if (!TextureContainer::read(candidates[i].string(), &format, &levels))
+					continue;
+			}
 
-		// Clean the memory.
+			// Skip formats this driver cannot sample.
+			if (std::find(Texture::supported_formats.begin(), Texture::supported_formats.end(), format) == Texture::supported_formats.end())
+				continue;
+
+			// Publish the levels to the main thread. The streamer can read them again from here.
+			image->format = format;
+			image->levels = std::move(levels);
+			image->source = candidates[i].string();
+			image->width = image->levels[0].width;
+			image->height = image->levels[0].height;
+			image->channels = 4;
+			image->state.store(TEXTURE_IMAGE_DECODED, std::memory_order_release);
+			return;
+
+		}
+
+		// Containers stb_image cannot read.
+		if (is_container) {
+
+			image->state.store(TEXTURE_IMAGE_FAILED, std::memory_order_release);
+			return;
+
+		}
+
+		// This function has to be used because OpenGL loads texture the opposite way
+		// than this library, so images appear upside down. The flag is per thread.
+		stbi_set_flip_vertically_on_load_thread(image->flip);
+
+		// Read the texture image and its information, always as RGBA.
+		int width = 0, height = 0, channels = 0;
+		unsigned char* image_bytes = nullptr;
+
+		{
+			ProfilerScope read_scope("Texture image read");
+			image_bytes = stbi_load(image->path.c_str(), &width, &height, &channels, 4);
+		}
+
+		if (image_bytes == nullptr) {
+
+			image->state.store(TEXTURE_IMAGE_FAILED, std::memory_order_release);
+			return;
+
+		}
+
+		TextureLevel base;
+		base.width = width;
+		base.height = height;
+		base.data.assign(image_bytes, image_bytes + (size_t) width * height * 4);
 		stbi_image_free(image_bytes);
 
-		// Unbinds the OpenGL Texture.
-		glBindTexture(GL_TEXTURE_2D, 0);
+		// Build the mip chain and keep it for the next launches.
+		std::vector<TextureLevel> levels;
+
+		{
+			ProfilerScope mipmap_scope("Texture mipmaps");
+			levels = MipmapGenerator::generate(base, TEXTURE_MIPMAP_FILTER, image->srgb);
+		}
+
+		std::string cache_path = Texture::getMipCachePath(image);
+
+		if (!cache_path.empty()) {
+
+			ProfilerScope write_scope("Texture cache write");
+
+			std::error_code error;
+			std::filesystem::create_directories(TEXTURE_MIP_CACHE_DIR, error);
+
+			if (TextureContainer::writeDDS(cache_path, GL_RGBA8, levels))
+				image->source = cache_path;
+			else
+				std::cerr << "Texture warning - Could not write the mip chain " << cache_path << std::endl;
+
+		}
+
+		// Publish the levels to the main thread.
+		image->format = GL_RGBA8;
+		image->levels = std::move(levels);
+		image->width = width;
+		image->height = height;
+		image->channels = channels;
+		image->state.store(TEXTURE_IMAGE_DECODED, std::memory_order_release);
+
+	}
+
+	std::string Texture::getTranscodedPath(const std::string& path, bool flip, bool srgb, const std::string& extension) {
+
+		// Tag the name the same way the cache keys are.
+		std::string tags = std::string(flip ? ".flip" : ".noflip") + (srgb ? ".srgb" : ".linear");
+
+		return std::filesystem::path(path).replace_extension(tags + extension).string();
+
+	}
+
+	std::string Texture::getMipCachePath(const TextureImage* image) {
+
+		// The image has to exist to be cached.
+		std::error_code error;
+		auto modified = std::filesystem::last_write_time(image->path, error);
+		auto size = std::filesystem::file_size(image->path, error);
+
+		if (error)
+			return "";
+
+		// Hash the path, the file version and every parameter of the mip chain.
+		std::string key = image->path + "|" + std::to_string(modified.time_since_epoch().count()) + "|" +
+				std::to_string(size) + "|" + std::to_string(image->flip) + std::to_string(image->srgb) +
+				std::to_string(TEXTURE_MIPMAP_FILTER);
+
+		uint64_t hash = 14695981039346656037ull;
+
+		for (unsigned char c : key) {
+
+			hash ^= c;
+			hash *= 1099511628211ull;
+
+		}
+
+		char name[17];
+		snprintf(name, sizeof(name), "%016llx", (unsigned long long) hash);
+
+		return std::string(TEXTURE_MIP_CACHE_DIR) + "/" + name + ".dds";
+
+	}
+
+	void Texture::processUploads() {
+
+		size_t budget = TEXTURE_UPLOAD_BUDGET;
+
+		for (size_t i = 0; i < Texture::pending.size(); ) {
+
+			TextureImage& image = *Texture::pending[i];
+			int state = image.state.load(std::memory_order_acquire);
+
+			// Images every texture let go of while loading are just dropped, which
+			// frees them. The worker has to be done with them first.
+			if (Texture::pending[i].use_count() == 1 && state != TEXTURE_IMAGE_DECODING) {
+
+				Texture::pending.erase(Texture::pending.begin() + i);
+				continue;
+
+			}
+
+			if (state == TEXTURE_IMAGE_FAILED) {
+
+				std::cerr << "Texture error - Could not read the image: " << image.path << std::endl;
+				Texture::pending.erase(Texture::pending.begin() + i);
+				continue;
+
+			}
+
+			if (state == TEXTURE_IMAGE_DECODED) {
+
+				// Leave it for the next frame if it does not fit, unless nothing
+				// has been uploaded yet so big images still go through.
+				// Only the small levels are uploaded, the rest are streamed in later.
+				int first = TextureStreamer::getStartLevel(image);
+				size_t size = 0;
+
+				for (size_t l = first; l < image.levels.size(); l++)
+					size += image.levels[l].data.size();
+
+				if (size > budget && budget != TEXTURE_UPLOAD_BUDGET) {
+
+					i++;
+					continue;
+
+				}
+
+				budget -= std::min(size, budget);
+
+				// Copy the levels, one after the other, into a pixel buffer.
+				glGenBuffers(1, &image.pbo);
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, image.pbo);
+				glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+
+				unsigned char* mapped = (unsigned char*) glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size,
+						GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+				if (mapped != nullptr) {
+
+					for (size_t l = first, offset = 0; l < image.levels.size(); offset += image.levels[l].data.size(), l++)
+						memcpy(mapped + offset, image.levels[l].data.data(), image.levels[l].data.size());
+
+				}
+
+				// If the buffer could not be mapped, or its contents were lost, upload
+				// straight from memory instead.
+				if (mapped == nullptr || glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_FALSE) {
+
+					std::cerr << "Texture warning - Could not map a pixel buffer, uploading directly: " << image.path << std::endl;
+					glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+					glDeleteBuffers(1, &image.pbo);
+					image.pbo = 0;
+
+				}
+
+				// Start the copy from the pixel buffer into the texture. Rows are
+				// tightly packed, whatever the number of channels.
+				glBindTexture(GL_TEXTURE_2D, image.ID);
+				glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+				// Upload the small end of the mip chain, from the pixel buffer if there is one.
+				size_t offset = 0;
+
+				for (size_t l = first; l < image.levels.size(); l++) {
+
+					TextureLevel& level = image.levels[l];
+					const void* source = image.pbo != 0 ? (const void*) offset : (const void*) level.data.data();
+
+					if (TextureContainer::isCompressed(image.format))
+						glCompressedTexImage2D(GL_TEXTURE_2D, l, image.format, level.width, level.height,
+								0, level.data.size(), source);
+					else
+						glTexImage2D(GL_TEXTURE_2D, l, image.format, level.width, level.height,
+								0, GL_RGBA, GL_UNSIGNED_BYTE, source);
+
+					offset += level.data.size();
+
+				}
+
+				// Clamp the sampler to the uploaded levels.
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, first);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.levels.size() - 1);
+				image.resident_base = first;
+				TextureStreamer::add(Texture::pending[i]);
+
+				glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+				glBindTexture(GL_TEXTURE_2D, 0);
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+				// Direct uploads are done as soon as the calls return.
+				if (image.pbo == 0) {
+
+					image.state.store(TEXTURE_IMAGE_READY, std::memory_order_relaxed);
+					Texture::pending.erase(Texture::pending.begin() + i);
+					continue;
+
+				}
+
+				// Know when the GPU is done with the buffer.
+				image.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+				image.state.store(TEXTURE_IMAGE_UPLOADING, std::memory_order_relaxed);
+				i++;
+				continue;
+
+			}
+
+			if (state == TEXTURE_IMAGE_UPLOADING) {
+
+				// Free the pixel buffer once the copy is done.
+				GLenum result = glClientWaitSync(image.fence, 0, 0);
+
+				if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+
+					glDeleteSync(image.fence);
+					glDeleteBuffers(1, &image.pbo);
+					image.fence = 0;
+					image.pbo = 0;
+					image.state.store(TEXTURE_IMAGE_READY, std::memory_order_relaxed);
+					Texture::pending.erase(Texture::pending.begin() + i);
+					continue;
+
+				}
+
+			}
+
+			i++;
+
+		}
+
+	}
+
+	bool Texture::hasPendingUploads() {
+
+		return !Texture::pending.empty();
+
+	}
+
+	void Texture::releasePending() {
+
+		// The workers hold raw pointers, so wait for them first.
+		for (size_t i = 0; i < Texture::pending.size(); i++)
+			while (Texture::pending[i]->state.load(std::memory_order_acquire) == TEXTURE_IMAGE_DECODING)
+				std::this_thread::yield();
+
+		Texture::pending.clear();
 
 	}
 
 	GLuint Texture::getID() {
 
-		return this->ID;
+		return this->image != nullptr ? this->image->ID : 0;
 
 	}
 
@@ -89,19 +476,19 @@ namespace aladdin_3d {
 
 	int Texture::getWidth() {
 
-		return this->texture_width;
+		return this->image != nullptr ? this->image->width : 0;
 
 	}
 
 	int Texture::getHeight() {
 
-		return this->texture_height;
+		return this->image != nullptr ? this->image->height : 0;
 
 	}
 
 	int Texture::getChannels() {
 
-		return this->texture_channels;
+		return this->image != nullptr ? this->image->channels : 0;
 
 	}
 
@@ -115,13 +502,28 @@ namespace aladdin_3d {
 
 		// Activate the texture and bind it.
 		glActiveTexture(GL_TEXTURE0 + this->slot);
-		glBindTexture(GL_TEXTURE_2D, this->ID);
+		glBindTexture(GL_TEXTURE_2D, this->getID());
+
+	}
+
+	void Texture::requestSize(float pixels) {
+
+		// Only uploaded images are streamed.
+		if (this->isReady())
+			TextureStreamer::request(*this->image, pixels);
+
+	}
+
+	bool Texture::isReady() {
+
+		return this->image != nullptr && this->image->state.load(std::memory_order_relaxed) == TEXTURE_IMAGE_READY;
 
 	}
 
 	void Texture::remove() {
 
-		glDeleteTextures(1, &this->ID);
+		// Let go of the image. It is freed once no other texture uses it.
+		this->image = nullptr;
 
 	}
 
@@ -3,10 +3,10 @@
  * @brief Texture class header file.
  * @version 1.0.0 (2022-10-21)
  * @date 2022-10-21
- * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
  *
  *
- * Copyright (c) Borja Garca Quiroga, All Rights Reserved.
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
  *
  * The information and material provided below was developed as partial
  * requirements for the MSc in Computer Science at Trinity College Dublin,
@@ -16,19 +16,34 @@
 #ifndef ALADDIN_3D_CLASS_TEXTURE_H_
 #define ALADDIN_3D_CLASS_TEXTURE_H_
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "GL/glew.h"
 
+#include "Classes/MipmapGenerator/MipmapGenerator.h"
+#include "Structs/TextureImage/TextureImage.h"
+
+#define TEXTURE_UPLOAD_BUDGET (16 * 1024 * 1024)	/// Bytes copied into pixel buffers per frame.
+#define TEXTURE_MIPMAP_FILTER MIPMAP_FILTER_KAISER	/// Filter used to build the mip chains.
+#define TEXTURE_MIP_CACHE_DIR "MipCache"			/// Where the built mip chains are stored.
+
 namespace aladdin_3d {
 
 	/**
 	 * @brief Implements a texture class to handle object textures.
 	 * 
 	 * Implements a texture object to handle textures and their content to use
-	 * with the objects.
+	 * with the objects. Images are decoded in the thread pool and uploaded
+	 * through pixel buffers, meanwhile the texture holds a 1x1 white placeholder.
+	 * Copies of a texture share the same image. DDS and KTX2 files, either given
+	 * directly or found next to the image, are uploaded with their mip chain.
+	 * Other images get theirs built by the MipmapGenerator, and stored in
+	 * TEXTURE_MIP_CACHE_DIR for the next launches. Only the small levels are
+	 * uploaded at first, the TextureStreamer brings the rest when needed.
 	 * 
-	 * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
 	 */
 	class Texture {
 	
@@ -37,13 +52,17 @@ namespace aladdin_3d {
 			/**
 			 * @brief Creates a texture from an image.
 			 * 
-			 * Creates a textures and passes it to OpenGL.
+			 * Creates a textures and passes it to OpenGL. The image is decoded in
+			 * the background and uploaded by processUploads(). If another texture
+			 * already uses the same image with the same parameters, it is shared.
 			 * 
 			 * @param image Image containing the texture.
 			 * @param type Texture type.
 			 * @param slot Texture slot.
+			 * @param flip Whether to flip the image vertically.
+			 * @param srgb Whether the colors are sRGB encoded, so mips are filtered in linear space.
 			 */
-			Texture(const char* image, const char* type, GLuint slot);
+			Texture(const char* image, const char* type, GLuint slot, bool flip = true, bool srgb = true);
 
 			/**
 			 * @brief Get the ID of the texture.
@@ -99,6 +118,67 @@ namespace aladdin_3d {
 			 */
 			std::string getName();
 
+			/**
+			 * @brief Checks if the image is loaded.
+			 *
+			 * Checks if the image has been uploaded to the texture.
+			 *
+			 * @returns Whether the texture holds the image.
+			 */
+			bool isReady();
+
+			/**
+			 * @brief Requests the detail needed on screen.
+			 *
+			 * Tells the streamer how big the texture is drawn this frame, so the
+			 * levels needed are uploaded.
+			 *
+			 * @param pixels Size in pixels the texture covers on screen.
+			 */
+			void requestSize(float pixels);
+
+			/**
+			 * @brief Uploads the decoded images.
+			 *
+			 * Moves the decoded images into pixel buffers and starts their upload,
+			 * up to TEXTURE_UPLOAD_BUDGET bytes, and finishes the uploads the GPU is
+			 * done with. Call it once per frame from the OpenGL thread.
+			 */
+			static void processUploads();
+
+			/**
+			 * @brief Checks if there are uploads pending.
+			 *
+			 * Checks if any image is still being decoded or uploaded.
+			 *
+			 * @returns Whether there are uploads pending.
+			 */
+			static bool hasPendingUploads();
+
+			/**
+			 * @brief Drops the pending uploads.
+			 *
+			 * Waits for the workers to finish decoding and drops every upload
+			 * still pending. Call it before destroying the context.
+			 */
+			static void releasePending();
+
+			/**
+			 * @brief Gets the path of a transcoded image.
+			 *
+			 * Gets where the container transcoded from an image is written, next to
+			 * it. The name says whether the rows were flipped and whether the mips
+			 * were filtered as sRGB, so an image is only used the way it was built.
+			 *
+			 * @param path Path to the image.
+			 * @param flip Whether the rows are in OpenGL order.
+			 * @param srgb Whether the mips were filtered as sRGB.
+			 * @param extension Extension of the container, ".dds" or ".ktx2".
+			 *
+			 * @returns The path of the container.
+			 */
+			static std::string getTranscodedPath(const std::string& path, bool flip, bool srgb, const std::string& extension);
+
 			/**
 			 * @brief Binds the texture.
 			 * 
@@ -109,7 +189,8 @@ namespace aladdin_3d {
 			/**
 			 * @brief Removes the texture from OpenGL.
 			 *
-			 *  Removes the texture from OpenGL.
+			 * Lets go of the image. The OpenGL texture is removed once no other
+			 * texture uses it.
 			 */
 			void remove();
 
@@ -122,12 +203,40 @@ namespace aladdin_3d {
 
 		private:
 
-			GLuint ID;					/// Texture OpenGL ID.
-			GLuint slot;				/// Stores the texture slot number.
-			int texture_width = 0;		/// Width of the texture in pixels.
-			int texture_height = 0;		/// Height of the texture in pixels.
-			int texture_channels = 0;	/// Number of channels of the texture.
-			std::string name;			/// Texture name.
+			/**
+			 * @brief Decodes an image.
+			 *
+			 * Decodes the file of an image into its pixels. Runs in a worker.
+			 *
+			 * @param image Image to decode.
+			 */
+			static void decode(TextureImage* image);
+
+			/**
+			 * @brief Gets the mip cache path of an image.
+			 *
+			 * Gets where the mip chain of an image is cached, from a hash of its
+			 * path, its version and the mip chain parameters.
+			 *
+			 * @param image The image.
+			 *
+			 * @returns The path, or an empty string if the image does not exist.
+			 */
+			static std::string getMipCachePath(const TextureImage* image);
+
+			/**
+			 * @brief Finds the supported container formats.
+			 *
+			 * Finds the container formats the driver can sample.
+			 */
+			static void querySupportedFormats();
+
+			std::shared_ptr<TextureImage> image;	/// Image shared by all the copies.
+			GLuint slot;							/// Stores the texture slot number.
+			std::string name;						/// Texture name.
+
+			static std::vector<std::shared_ptr<TextureImage>> pending;	/// Images still being loaded.
+			static std::vector<GLenum> supported_formats;				/// Container formats the driver can sample.
 
 	};
 
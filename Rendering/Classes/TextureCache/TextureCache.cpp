@@ -0,0 +1,85 @@
+/**
+ * @file TextureCache.cpp
+ * @brief TextureCache class implementation file.
+ * @version 1.0.0 (2023-02-08)
+ * @date 2023-02-08
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "TextureCache.h"
+
+#include <filesystem>
+
+namespace aladdin_3d {
+
+	std::map<std::string, std::weak_ptr<TextureImage>> TextureCache::images;
+
+	std::string TextureCache::makeKey(const std::string& path, bool flip, bool srgb) {
+
+		// Resolve the path, so "a/../b.png" and "b.png" are the same image.
+		std::error_code error;
+		std::filesystem::path resolved = std::filesystem::weakly_canonical(path, error);
+
+		if (error)
+			resolved = std::filesystem::path(path).lexically_normal();
+
+		// Append the decode parameters.
+		return resolved.string() + (flip ? "|flip" : "|noflip") + (srgb ? "|srgb" : "|linear");
+
+	}
+
+	std::shared_ptr<TextureImage> TextureCache::find(const std::string& key) {
+
+		auto found = TextureCache::images.find(key);
+
+		if (found == TextureCache::images.end())
+			return nullptr;
+
+		// Forget images nobody uses anymore.
+		std::shared_ptr<TextureImage> image = found->second.lock();
+
+		if (image == nullptr)
+			TextureCache::images.erase(found);
+
+		return image;
+
+	}
+
+	void TextureCache::insert(const std::string& key, const std::shared_ptr<TextureImage>& image) {
+
+		TextureCache::images[key] = image;
+
+	}
+
+	size_t TextureCache::getSize() {
+
+		size_t size = 0;
+
+		for (auto it = TextureCache::images.begin(); it != TextureCache::images.end(); ) {
+
+			// Drop the expired entries while counting.
+			if (it->second.expired()) {
+
+				it = TextureCache::images.erase(it);
+
+			} else {
+
+				size++;
+				it++;
+
+			}
+
+		}
+
+		return size;
+
+	}
+
+} // namespace aladdin_3d
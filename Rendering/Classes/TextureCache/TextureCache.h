@@ -0,0 +1,92 @@
+/**
+ * @file TextureCache.h
+ * @brief TextureCache class header file.
+ * @version 1.0.0 (2023-02-08)
+ * @date 2023-02-08
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_TEXTURECACHE_H_
+#define ALADDIN_3D_CLASS_TEXTURECACHE_H_
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "Structs/TextureImage/TextureImage.h"
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implements a registry of the loaded texture images.
+	 *
+	 * Implements a registry of the loaded texture images, keyed by their
+	 * resolved path and decode parameters. It only keeps weak references, so an
+	 * image is freed as soon as the last texture using it goes away.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class TextureCache {
+
+		public:
+
+			/**
+			 * @brief Builds the key of an image.
+			 *
+			 * Builds the key of an image from its path, resolved so different
+			 * spellings of the same file match, and its decode parameters.
+			 *
+			 * @param path Path to the image file.
+			 * @param flip Whether the image is flipped vertically when decoded.
+			 * @param srgb Whether the colors are sRGB encoded.
+			 *
+			 * @returns The key of the image.
+			 */
+			static std::string makeKey(const std::string& path, bool flip, bool srgb);
+
+			/**
+			 * @brief Finds an image.
+			 *
+			 * Finds a loaded image that is still in use.
+			 *
+			 * @param key Key of the image.
+			 *
+			 * @returns The image, or nullptr if it is not loaded.
+			 */
+			static std::shared_ptr<TextureImage> find(const std::string& key);
+
+			/**
+			 * @brief Registers an image.
+			 *
+			 * Registers a newly loaded image so later textures can share it.
+			 *
+			 * @param key Key of the image.
+			 * @param image The image.
+			 */
+			static void insert(const std::string& key, const std::shared_ptr<TextureImage>& image);
+
+			/**
+			 * @brief Gets the number of images in use.
+			 *
+			 * Gets the number of registered images that are still in use.
+			 *
+			 * @returns The number of images in use.
+			 */
+			static size_t getSize();
+
+		private:
+
+			static std::map<std::string, std::weak_ptr<TextureImage>> images;	/// Registered images.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_TEXTURECACHE_H_
@@ -0,0 +1,353 @@
+/**
+ * @file TextureContainer.cpp
+ * @brief TextureContainer class implementation file.
+ * @version 1.0.0 (2023-02-11)
+ * @date 2023-02-11
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "TextureContainer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "GL/glew.h"
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief A known texture format.
+	 *
+	 * Relates the OpenGL internal format with its codes in each container.
+	 */
+	struct ContainerFormat {
+
+		GLenum gl;				// OpenGL internal format.
+		uint32_t dxgi;			// DXGI format used in DX10 DDS headers.
+		uint32_t vulkan;		// Vulkan format used in KTX2 headers.
+		const char* fourcc;		// Legacy DDS FourCC, if there is one.
+		size_t block_bytes;		// Bytes per 4x4 block, 0 if not compressed.
+
+	};
+
+	/**
+	 * The formats that can be read and written.
+	 */
+	static const ContainerFormat container_formats[] = {
+
+		{ GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,			71, 133, "DXT1", 8 },
+		{ GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT,	72, 134, nullptr, 8 },
+		{ GL_COMPRESSED_RGB_S3TC_DXT1_EXT,			0,	131, nullptr, 8 },
+		{ GL_COMPRESSED_SRGB_S3TC_DXT1_EXT,			0,	132, nullptr, 8 },
+		{ GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,			77, 137, "DXT5", 16 },
+		{ GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT,	78, 138, nullptr, 16 },
+		{ GL_COMPRESSED_RG_RGTC2,					83, 141, "ATI2", 16 },
+		{ GL_COMPRESSED_RGBA_BPTC_UNORM,			98, 145, nullptr, 16 },
+		{ GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM,		99, 146, nullptr, 16 },
+		{ GL_COMPRESSED_RGB8_ETC2,					0,	147, nullptr, 8 },
+		{ GL_COMPRESSED_RGBA8_ETC2_EAC,				0,	151, nullptr, 16 },
+		{ GL_RGBA8,									28, 37, nullptr, 0 },
+		{ GL_SRGB8_ALPHA8,							29, 43, nullptr, 0 }
+
+	};
+
+	/**
+	 * @brief Finds a format by one of its codes.
+	 *
+	 * Finds a format by one of its codes.
+	 *
+	 * @param matches Returns whether a format is the one looked for.
+	 *
+	 * @returns The format, or nullptr if it is unknown.
+	 */
+	template <typename Predicate>
+	static const ContainerFormat* findFormat(Predicate matches) {
+
+		for (const ContainerFormat& format : container_formats)
+			if (matches(format))
+				return &format;
+
+		return nullptr;
+
+	}
+
+	/**
+	 * @brief Reads a little endian integer.
+	 *
+	 * Reads a little endian integer from a byte array.
+	 *
+	 * @param bytes Byte array.
+	 * @param offset Offset of the integer.
+	 *
+	 * @returns The integer.
+	 */
+	template <typename T>
+	static T readLittleEndian(const std::vector<unsigned char>& bytes, size_t offset) {
+
+		T value = 0;
+
+		for (size_t i = 0; i < sizeof(T); i++)
+			value |= (T) bytes[offset + i] << (8 * i);
+
+		return value;
+
+	}
+
+	/**
+	 * @brief Writes a little endian 32 bit integer.
+	 *
+	 * Appends a little endian 32 bit integer to a byte array.
+	 *
+	 * @param bytes Byte array.
+	 * @param value The integer.
+	 */
+	static void writeLittleEndian(std::vector<unsigned char>* bytes, uint32_t value) {
+
+		for (size_t i = 0; i < 4; i++)
+			bytes->push_back((value >> (8 * i)) & 0xFF);
+
+	}
+
+	bool TextureContainer::read(const std::string& path, GLenum* format, std::vector<TextureLevel>* levels) {
+
+		// Read the whole file.
+		std::ifstream file_stream(path, std::ios::binary);
+
+		if (!file_stream)
+			return false;
+
+		std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file_stream)), std::istreambuf_iterator<char>());
+
+		// Tell the containers apart by their magic numbers.
+		static const unsigned char ktx2_magic[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+		if (bytes.size() >= 4 && std::memcmp(bytes.data(), "DDS ", 4) == 0)
+			return TextureContainer::readDDS(bytes, format, levels);
+
+		if (bytes.size() >= 12 && std::memcmp(bytes.data(), ktx2_magic, 12) == 0)
+			return TextureContainer::readKTX2(bytes, format, levels);
+
+		return false;
+
+	}
+
+	bool TextureContainer::readDDS(const std::vector<unsigned char>& bytes, GLenum* format, std::vector<TextureLevel>* levels) {
+
+		// The magic number plus the header take 128 bytes.
+		if (bytes.size() < 128)
+			return false;
+
+		int height = readLittleEndian<uint32_t>(bytes, 12);
+		int width = readLittleEndian<uint32_t>(bytes, 16);
+		int level_count = std::max<uint32_t>(readLittleEndian<uint32_t>(bytes, 28), 1);
+		std::string fourcc(bytes.begin() + 84, bytes.begin() + 88);
+		size_t offset = 128;
+
+		// Find the format, in the DX10 header if there is one.
+		const ContainerFormat* found = nullptr;
+
+		if (fourcc == "DX10") {
+
+			if (bytes.size() < 148)
+				return false;
+
+			uint32_t dxgi = readLittleEndian<uint32_t>(bytes, 128);
+			found = findFormat([dxgi](const ContainerFormat& f) { return f.dxgi != 0 && f.dxgi == dxgi; });
+			offset = 148;
+
+		} else {
+
+			// Some writers use BC5U instead of ATI2.
+			if (fourcc == "BC5U")
+				fourcc = "ATI2";
+
+			found = findFormat([&fourcc](const ContainerFormat& f) { return f.fourcc != nullptr && fourcc == f.fourcc; });
+
+		}
+
+		if (found == nullptr || width <= 0 || height <= 0)
+			return false;
+
+		// The levels follow each other, the largest first.
+		levels->clear();
+
+		for (int i = 0; i < level_count; i++) {
+
+			TextureLevel level;
+			level.width = std::max(width >> i, 1);
+			level.height = std::max(height >> i, 1);
+			size_t size = TextureContainer::getLevelSize(found->gl, level.width, level.height);
+
+			if (offset + size > bytes.size())
+				return false;
+
+			level.data.assign(bytes.begin() + offset, bytes.begin() + offset + size);
+			levels->push_back(std::move(level));
+			offset += size;
+
+		}
+
+		*format = found->gl;
+
+		return true;
+
+	}
+
+	bool TextureContainer::readKTX2(const std::vector<unsigned char>& bytes, GLenum* format, std::vector<TextureLevel>* levels) {
+
+		// The identifier, the header and the index take 80 bytes.
+		if (bytes.size() < 80)
+			return false;
+
+		uint32_t vulkan = readLittleEndian<uint32_t>(bytes, 12);
+		int width = readLittleEndian<uint32_t>(bytes, 20);
+		int height = readLittleEndian<uint32_t>(bytes, 24);
+		uint32_t depth = readLittleEndian<uint32_t>(bytes, 28);
+		uint32_t layer_count = readLittleEndian<uint32_t>(bytes, 32);
+		uint32_t face_count = readLittleEndian<uint32_t>(bytes, 36);
+		int level_count = std::max<uint32_t>(readLittleEndian<uint32_t>(bytes, 40), 1);
+		uint32_t supercompression = readLittleEndian<uint32_t>(bytes, 44);
+
+		// Only plain 2D textures are supported.
+		if (depth > 1 || layer_count > 1 || face_count != 1 || supercompression != 0)
+			return false;
+
+		const ContainerFormat* found = findFormat([vulkan](const ContainerFormat& f) { return f.vulkan == vulkan; });
+
+		if (found == nullptr || width <= 0 || height <= 0 || bytes.size() < 80 + 24 * (size_t) level_count)
+			return false;
+
+		// Each level has its own entry in the level index, right after the header.
+		levels->clear();
+
+		for (int i = 0; i < level_count; i++) {
+
+			size_t offset = readLittleEndian<uint64_t>(bytes, 80 + 24 * i);
+			size_t length = readLittleEndian<uint64_t>(bytes, 80 + 24 * i + 8);
+
+			TextureLevel level;
+			level.width = std::max(width >> i, 1);
+			level.height = std::max(height >> i, 1);
+
+			if (length != TextureContainer::getLevelSize(found->gl, level.width, level.height) || offset + length > bytes.size())
+				return false;
+
+			level.data.assign(bytes.begin() + offset, bytes.begin() + offset + length);
+			levels->push_back(std::move(level));
+
+		}
+
+		*format = found->gl;
+
+		return true;
+
+	}
+
+	bool TextureContainer::writeDDS(const std::string& path, GLenum format, const std::vector<TextureLevel>& levels) {
+
+		const ContainerFormat* found = findFormat([format](const ContainerFormat& f) { return f.gl == format; });
+
+		if (found == nullptr || (found->fourcc == nullptr && found->dxgi == 0) || levels.empty())
+			return false;
+
+		// Magic number and header.
+		std::vector<unsigned char> bytes = { 'D', 'D', 'S', ' ' };
+		bool compressed = found->block_bytes != 0;
+
+		writeLittleEndian(&bytes, 124);														// Header size.
+		writeLittleEndian(&bytes, 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | (compressed ? 0x80000 : 0x8));	// Caps, height, width, pixel format, mip count and linear size or pitch.
+		writeLittleEndian(&bytes, levels[0].height);
+		writeLittleEndian(&bytes, levels[0].width);
+		writeLittleEndian(&bytes, compressed ? (uint32_t) levels[0].data.size() : levels[0].width * 4);
+		writeLittleEndian(&bytes, 0);														// Depth.
+		writeLittleEndian(&bytes, (uint32_t) levels.size());
+
+		for (int i = 0; i < 11; i++)
+			writeLittleEndian(&bytes, 0);													// Reserved.
+
+		// Pixel format, the FourCC tells where the format is.
+		writeLittleEndian(&bytes, 32);
+		writeLittleEndian(&bytes, 0x4);
+		const char* fourcc = found->fourcc != nullptr ? found->fourcc : "DX10";
+		bytes.insert(bytes.end(), fourcc, fourcc + 4);
+
+		for (int i = 0; i < 5; i++)
+			writeLittleEndian(&bytes, 0);													// Bit count and masks.
+
+		writeLittleEndian(&bytes, 0x1000 | 0x400000 | 0x8);									// Texture, mipmap and complex.
+
+		for (int i = 0; i < 4; i++)
+			writeLittleEndian(&bytes, 0);													// More caps and reserved.
+
+		// The DX10 header.
+		if (found->fourcc == nullptr) {
+
+			writeLittleEndian(&bytes, found->dxgi);
+			writeLittleEndian(&bytes, 3);													// Texture 2D.
+			writeLittleEndian(&bytes, 0);
+			writeLittleEndian(&bytes, 1);													// Array size.
+			writeLittleEndian(&bytes, 0);
+
+		}
+
+		// Then the levels.
+		for (size_t i = 0; i < levels.size(); i++)
+			bytes.insert(bytes.end(), levels[i].data.begin(), levels[i].data.end());
+
+		// Write them into a temporary file and move it in place, so readers never
+		// see half a file.
+		std::string temporary_path = path + ".tmp";
+		std::ofstream file_stream(temporary_path, std::ios::binary | std::ios::trunc);
+
+		if (!file_stream)
+			return false;
+
+		file_stream.write((const char*) bytes.data(), bytes.size());
+		file_stream.close();
+
+		if (!file_stream || std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+
+			std::remove(temporary_path.c_str());
+			return false;
+
+		}
+
+		return true;
+
+	}
+
+	bool TextureContainer::isCompressed(GLenum format) {
+
+		const ContainerFormat* found = findFormat([format](const ContainerFormat& f) { return f.gl == format; });
+
+		return found != nullptr && found->block_bytes != 0;
+
+	}
+
+	size_t TextureContainer::getLevelSize(GLenum format, int width, int height) {
+
+		const ContainerFormat* found = findFormat([format](const ContainerFormat& f) { return f.gl == format; });
+
+		if (found == nullptr)
+			return 0;
+
+		// Compressed levels are made of whole 4x4 blocks.
+		if (found->block_bytes != 0)
+			return (size_t) ((width + 3) / 4) * ((height + 3) / 4) * found->block_bytes;
+
+		return (size_t) width * height * 4;
+
+	}
+
+} // namespace aladdin_3d
@@ -0,0 +1,125 @@
+/**
+ * @file TextureContainer.h
+ * @brief TextureContainer class header file.
+ * @version 1.0.0 (2023-02-11)
+ * @date 2023-02-11
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_TEXTURECONTAINER_H_
+#define ALADDIN_3D_CLASS_TEXTURECONTAINER_H_
+
+#include <string>
+#include <vector>
+
+#include "GL/glew.h"
+
+#include "Structs/TextureLevel/TextureLevel.h"
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implements the reading and writing of texture container files.
+	 *
+	 * Implements the reading of DDS and KTX2 files and the writing of DDS files,
+	 * with their whole mip chain. Formats are identified by their OpenGL
+	 * internal format: BC1, BC3, BC5, BC7, ETC2 and plain RGBA8.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class TextureContainer {
+
+		public:
+
+			/**
+			 * @brief Reads a container file.
+			 *
+			 * Reads a DDS or KTX2 file, told apart by their magic numbers. Only
+			 * 2D textures without supercompression are supported.
+			 *
+			 * @param path Path to the file.
+			 * @param format Where the OpenGL internal format is stored.
+			 * @param levels Where the levels are stored, the largest first.
+			 *
+			 * @returns Whether the file could be read.
+			 */
+			static bool read(const std::string& path, GLenum* format, std::vector<TextureLevel>* levels);
+
+			/**
+			 * @brief Writes a DDS file.
+			 *
+			 * Writes the levels in a DDS file. BC1, BC3 and BC5 use the legacy
+			 * FourCC header, every other format the DX10 one.
+			 *
+			 * @param path Path to the file.
+			 * @param format OpenGL internal format of the levels.
+			 * @param levels Levels to write, the largest first.
+			 *
+			 * @returns Whether the file could be written.
+			 */
+			static bool writeDDS(const std::string& path, GLenum format, const std::vector<TextureLevel>& levels);
+
+			/**
+			 * @brief Checks if a format is block compressed.
+			 *
+			 * Checks if an OpenGL internal format is block compressed.
+			 *
+			 * @param format OpenGL internal format.
+			 *
+			 * @returns Whether the format is block compressed.
+			 */
+			static bool isCompressed(GLenum format);
+
+			/**
+			 * @brief Gets the size of a level.
+			 *
+			 * Gets the size in bytes of a level of the given format and size.
+			 *
+			 * @param format OpenGL internal format.
+			 * @param width Width of the level in pixels.
+			 * @param height Height of the level in pixels.
+			 *
+			 * @returns The size of the level in bytes, or 0 for unknown formats.
+			 */
+			static size_t getLevelSize(GLenum format, int width, int height);
+
+		private:
+
+			/**
+			 * @brief Reads the contents of a DDS file.
+			 *
+			 * Reads the contents of a DDS file.
+			 *
+			 * @param bytes Contents of the file.
+			 * @param format Where the OpenGL internal format is stored.
+			 * @param levels Where the levels are stored.
+			 *
+			 * @returns Whether the contents could be read.
+			 */
+			static bool readDDS(const std::vector<unsigned char>& bytes, GLenum* format, std::vector<TextureLevel>* levels);
+
+			/**
+			 * @brief Reads the contents of a KTX2 file.
+			 *
+			 * Reads the contents of a KTX2 file.
+			 *
+			 * @param bytes Contents of the file.
+			 * @param format Where the OpenGL internal format is stored.
+			 * @param levels Where the levels are stored.
+			 *
+			 * @returns Whether the contents could be read.
+			 */
+			static bool readKTX2(const std::vector<unsigned char>& bytes, GLenum* format, std::vector<TextureLevel>* levels);
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_TEXTURECONTAINER_H_
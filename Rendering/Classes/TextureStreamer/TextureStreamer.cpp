@@ -0,0 +1,386 @@
+/**
+ * @file TextureStreamer.cpp
+ * @brief TextureStreamer class implementation file.
+ * @version 1.0.0 (2023-02-17)
+ * @date 2023-02-17
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include "GL/glew.h"
+
+#include "Classes/Texture/Texture.h"
+#include "Classes/TextureContainer/TextureContainer.h"
+#include "Classes/ThreadPool/ThreadPool.h"
+
+namespace aladdin_3d {
+
+	std::vector<std::weak_ptr<TextureImage>> TextureStreamer::images;
+	std::vector<std::shared_ptr<TextureImage>> TextureStreamer::reloads;
+	size_t TextureStreamer::resident_bytes = 0;
+
+	int TextureStreamer::getStartLevel(const TextureImage& image) {
+
+		int level = 0;
+
+		while (level + 1 < (int) image.levels.size() &&
+				std::max(image.levels[level].width, image.levels[level].height) > TEXTURE_STREAMING_START_SIZE)
+			level++;
+
+		return level;
+
+	}
+
+	void TextureStreamer::add(const std::shared_ptr<TextureImage>& image) {
+
+		// Nothing is requested until it is drawn.
+		image->wanted_base = (int) image->levels.size() - 1;
+		TextureStreamer::images.push_back(image);
+
+		// The uploaded levels are in OpenGL now.
+		for (size_t l = image->resident_base; l < image->levels.size(); l++)
+			TextureStreamer::releaseLevel(*image, (int) l);
+
+	}
+
+	void TextureStreamer::request(TextureImage& image, float pixels) {
+
+		if (image.levels.empty())
+			return;
+
+		// One level less for every halving of the size on screen.
+		int size = std::max(image.levels[0].width, image.levels[0].height);
+		int level = (int) std::floor(std::log2(size / std::max(pixels, 1.0f)));
+		level = std::min(std::max(level, 0), (int) image.levels.size() - 1);
+
+		image.wanted_base = std::min(image.wanted_base, level);
+
+	}
+
+	void TextureStreamer::update() {
+
+		// Take the levels read again by the workers that are done. Only the ones
+		// not in OpenGL are kept.
+		for (size_t i = 0; i < TextureStreamer::reloads.size(); ) {
+
+			TextureImage& image = *TextureStreamer::reloads[i];
+
+			if (image.reloading.load(std::memory_order_acquire)) {
+
+				i++;
+				continue;
+
+			}
+
+			if (image.reloaded.size() == image.levels.size()) {
+
+				for (int l = 0; l < image.resident_base; l++)
+					if (image.levels[l].data.empty())
+						image.levels[l].data = std::move(image.reloaded[l].data);
+
+			} else {
+
+				// Keep what is left from now on, the missing levels are lost.
+				std::cerr << "TextureStreamer error - Could not read the levels again: " << image.source << std::endl;
+				image.source = "";
+
+			}
+
+			image.reloaded.clear();
+			TextureStreamer::reloads.erase(TextureStreamer::reloads.begin() + i);
+
+		}
+
+		// Get the live images and the memory they use.
+		std::vector<std::shared_ptr<TextureImage>> live;
+		size_t total = 0;
+
+		for (size_t i = 0; i < TextureStreamer::images.size(); ) {
+
+			std::shared_ptr<TextureImage> image = TextureStreamer::images[i].lock();
+
+			if (image == nullptr) {
+
+				TextureStreamer::images.erase(TextureStreamer::images.begin() + i);
+				continue;
+
+			}
+
+			// Let the sampler use the levels the GPU is done copying.
+			if (image->streaming_level >= 0) {
+
+				GLenum result = glClientWaitSync(image->fence, 0, 0);
+
+				if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+
+					glDeleteSync(image->fence);
+					glDeleteBuffers(1, &image->pbo);
+					image->fence = 0;
+					image->pbo = 0;
+					TextureStreamer::setResidentBase(*image, image->streaming_level);
+					image->streaming_level = -1;
+
+				}
+
+			}
+
+			// Levels being copied already take their memory.
+			int first = image->streaming_level >= 0 ? image->streaming_level : image->resident_base;
+			total += TextureStreamer::getLevelsSize(*image, first, (int) image->levels.size());
+			live.push_back(image);
+			i++;
+
+		}
+
+		// Serve the images that miss the most levels first. Images still being
+		// copied, by the loader or by an earlier update, or read again, wait for
+		// it to finish. Levels lost for good are not requested anymore.
+		std::vector<std::shared_ptr<TextureImage>> wanting;
+
+		for (size_t i = 0; i < live.size(); i++) {
+
+			TextureImage& image = *live[i];
+
+			if (image.wanted_base >= image.resident_base || !TextureStreamer::isIdle(image) ||
+					image.reloading.load(std::memory_order_relaxed))
+				continue;
+
+			if (image.levels[image.resident_base - 1].data.empty() && image.source.empty())
+				continue;
+
+			wanting.push_back(live[i]);
+
+		}
+
+		std::sort(wanting.begin(), wanting.end(), [](const std::shared_ptr<TextureImage>& a, const std::shared_ptr<TextureImage>& b) {
+			return a->resident_base - a->wanted_base > b->resident_base - b->wanted_base;
+		});
+
+		// Upload one level per image and frame, within the upload budget.
+		size_t upload_budget = TEXTURE_UPLOAD_BUDGET;
+
+		for (size_t i = 0; i < wanting.size(); i++) {
+
+			TextureImage& image = *wanting[i];
+			int next = image.resident_base - 1;
+			size_t cost = TextureStreamer::getLevelsSize(image, next, next + 1);
+
+			// Big levels still go through if nothing was uploaded yet.
+			if (cost > upload_budget && upload_budget != TEXTURE_UPLOAD_BUDGET)
+				break;
+
+			// Levels whose pixels were released are read again first.
+			if (image.levels[next].data.empty()) {
+
+				TextureStreamer::reload(wanting[i]);
+				continue;
+
+			}
+
+			// Make room dropping the levels of the images that need them the least.
+			while (total + cost > TEXTURE_STREAMING_BUDGET) {
+
+				TextureImage* victim = nullptr;
+
+				for (size_t j = 0; j < live.size(); j++)
+					if (live[j]->resident_base < live[j]->wanted_base && TextureStreamer::isIdle(*live[j]) &&
+							(victim == nullptr || live[j]->wanted_base - live[j]->resident_base > victim->wanted_base - victim->resident_base))
+						victim = live[j].get();
+
+				if (victim == nullptr)
+					break;
+
+				total -= TextureStreamer::getLevelsSize(*victim, victim->resident_base, victim->resident_base + 1);
+				TextureStreamer::evictLevel(*victim);
+
+			}
+
+			if (total + cost > TEXTURE_STREAMING_BUDGET)
+				continue;
+
+			total += cost;
+			TextureStreamer::uploadLevel(image, next);
+			upload_budget -= std::min(cost, upload_budget);
+
+		}
+
+		// Requests only last one frame.
+		for (size_t i = 0; i < live.size(); i++)
+			live[i]->wanted_base = (int) live[i]->levels.size() - 1;
+
+		TextureStreamer::resident_bytes = total;
+
+	}
+
+	size_t TextureStreamer::getResidentBytes() {
+
+		return TextureStreamer::resident_bytes;
+
+	}
+
+	void TextureStreamer::release() {
+
+		// The workers hold raw pointers, so wait for them first.
+		for (size_t i = 0; i < TextureStreamer::reloads.size(); i++)
+			while (TextureStreamer::reloads[i]->reloading.load(std::memory_order_acquire))
+				std::this_thread::yield();
+
+		TextureStreamer::reloads.clear();
+
+	}
+
+	void TextureStreamer::evictLevel(TextureImage& image) {
+
+		int level = image.resident_base;
+		TextureStreamer::setResidentBase(image, level + 1);
+
+		// Define the level again with no pixels, so OpenGL frees its memory. The
+		// sampler does not reach it, so the texture stays complete.
+		glBindTexture(GL_TEXTURE_2D, image.ID);
+
+		if (TextureContainer::isCompressed(image.format))
+			glCompressedTexImage2D(GL_TEXTURE_2D, level, image.format, 0, 0, 0, 0, nullptr);
+		else
+			glTexImage2D(GL_TEXTURE_2D, level, image.format, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+	}
+
+	size_t TextureStreamer::getLevelsSize(const TextureImage& image, int first, int last) {
+
+		// The pixels may have been released, so it goes by the size of the levels.
+		size_t size = 0;
+
+		for (int l = first; l < last; l++)
+			size += TextureContainer::getLevelSize(image.format, image.levels[l].width, image.levels[l].height);
+
+		return size;
+
+	}
+
+	bool TextureStreamer::isIdle(const TextureImage& image) {
+
+		return image.state.load(std::memory_order_relaxed) == TEXTURE_IMAGE_READY && image.streaming_level < 0;
+
+	}
+
+	void TextureStreamer::releaseLevel(TextureImage& image, int level) {
+
+		// Without a source the pixels are the only copy left.
+		if (image.source.empty())
+			return;
+
+		std::vector<unsigned char>().swap(image.levels[level].data);
+
+	}
+
+	void TextureStreamer::reload(const std::shared_ptr<TextureImage>& image) {
+
+		// The list keeps the image alive until the worker is done with it.
+		image->reloading.store(true, std::memory_order_relaxed);
+		TextureStreamer::reloads.push_back(image);
+		TextureImage* reloading = image.get();
+
+		ThreadPool::getShared().submit([reloading]() {
+
+			GLenum format = 0;
+			std::vector<TextureLevel> levels;
+
+			// Only a file like the one first read is taken.
+			if (TextureContainer::read(reloading->source, &format, &levels) && format == reloading->format &&
+					levels.size() == reloading->levels.size())
+				reloading->reloaded = std::move(levels);
+
+			reloading->reloading.store(false, std::memory_order_release);
+
+		});
+
+	}
+
+	void TextureStreamer::setResidentBase(TextureImage& image, int base) {
+
+		// Only the sampled range changes here, the levels above it are freed
+		// by evictLevel.
+		glBindTexture(GL_TEXTURE_2D, image.ID);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, base);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (int) image.levels.size() - 1);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		image.resident_base = base;
+
+	}
+
+	void TextureStreamer::uploadLevel(TextureImage& image, int level) {
+
+		TextureLevel& data = image.levels[level];
+
+		// Copy the level into a pixel buffer.
+		glGenBuffers(1, &image.pbo);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, image.pbo);
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, data.data.size(), nullptr, GL_STREAM_DRAW);
+
+		unsigned char* mapped = (unsigned char*) glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, data.data.size(),
+				GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+		if (mapped != nullptr)
+			memcpy(mapped, data.data.data(), data.data.size());
+
+		// If the buffer could not be mapped, or its contents were lost, upload
+		// straight from memory instead.
+		if (mapped == nullptr || glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_FALSE) {
+
+			std::cerr << "TextureStreamer warning - Could not map a pixel buffer, uploading directly: " << image.path << std::endl;
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			glDeleteBuffers(1, &image.pbo);
+			image.pbo = 0;
+
+		}
+
+		// Start the copy into the texture.
+		const void* source = image.pbo != 0 ? nullptr : (const void*) data.data.data();
+
+		glBindTexture(GL_TEXTURE_2D, image.ID);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+		if (TextureContainer::isCompressed(image.format))
+			glCompressedTexImage2D(GL_TEXTURE_2D, level, image.format, data.width, data.height, 0, data.data.size(), source);
+		else
+			glTexImage2D(GL_TEXTURE_2D, level, image.format, data.width, data.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, source);
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		// OpenGL has its own copy of the pixels now.
+		TextureStreamer::releaseLevel(image, level);
+
+		// Direct uploads are done as soon as the calls return.
+		if (image.pbo == 0) {
+
+			TextureStreamer::setResidentBase(image, level);
+			return;
+
+		}
+
+		// Move the sampler once the GPU is done with the buffer.
+		image.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		image.streaming_level = level;
+
+	}
+
+} // namespace aladdin_3d
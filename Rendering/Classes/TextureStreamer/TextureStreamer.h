@@ -0,0 +1,193 @@
+/**
+ * @file TextureStreamer.h
+ * @brief TextureStreamer class header file.
+ * @version 1.0.0 (2023-02-17)
+ * @date 2023-02-17
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_TEXTURESTREAMER_H_
+#define ALADDIN_3D_CLASS_TEXTURESTREAMER_H_
+
+#include <memory>
+#include <vector>
+
+#include "Structs/TextureImage/TextureImage.h"
+
+#define TEXTURE_STREAMING_BUDGET (256 * 1024 * 1024)	/// Bytes of mip levels kept in video memory.
+#define TEXTURE_STREAMING_START_SIZE 64					/// Largest side of the first level uploaded.
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implements the streaming of texture mip levels.
+	 *
+	 * Implements the streaming of texture mip levels. Textures start with only
+	 * their small levels in video memory, and the larger ones are uploaded when
+	 * the geometries using them cover enough of the screen. Levels are copied
+	 * through pixel buffers, and the sampler only moves on to them once a fence
+	 * says the copy is done. The levels sampled are clamped with
+	 * GL_TEXTURE_BASE_LEVEL and GL_TEXTURE_MAX_LEVEL, and when the budget is
+	 * full the textures that do not need their largest levels drop them,
+	 * defining them again with no pixels so OpenGL frees their memory. Once a
+	 * level is in OpenGL its pixels are released from memory too, and read
+	 * again from the container of the image by a worker if it is dropped and
+	 * requested later.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class TextureStreamer {
+
+		public:
+
+			/**
+			 * @brief Gets the first level to upload.
+			 *
+			 * Gets the first level of an image to upload when it is loaded.
+			 *
+			 * @param image The image, with its levels.
+			 *
+			 * @returns The first level whose sides fit TEXTURE_STREAMING_START_SIZE.
+			 */
+			static int getStartLevel(const TextureImage& image);
+
+			/**
+			 * @brief Starts streaming an image.
+			 *
+			 * Starts streaming an image whose start levels have been uploaded, and
+			 * releases their pixels.
+			 *
+			 * @param image The image.
+			 */
+			static void add(const std::shared_ptr<TextureImage>& image);
+
+			/**
+			 * @brief Requests the detail of an image.
+			 *
+			 * Requests the level of an image needed to cover a size on screen.
+			 *
+			 * @param image The image.
+			 * @param pixels Size in pixels the image covers on screen.
+			 */
+			static void request(TextureImage& image, float pixels);
+
+			/**
+			 * @brief Updates the resident levels.
+			 *
+			 * Finishes the level copies the GPU is done with, and starts copying or
+			 * stops sampling levels according to the requests since the last
+			 * update. Call it once per frame from the OpenGL thread.
+			 */
+			static void update();
+
+			/**
+			 * @brief Releases the images being read again.
+			 *
+			 * Waits for the workers reading levels again and lets go of their
+			 * images, so they are freed while the context still exists.
+			 */
+			static void release();
+
+			/**
+			 * @brief Gets the used video memory.
+			 *
+			 * Gets the bytes of the levels currently sampled or being copied.
+			 *
+			 * @returns The bytes in video memory.
+			 */
+			static size_t getResidentBytes();
+
+		private:
+
+			/**
+			 * @brief Drops the largest level of an image.
+			 *
+			 * Stops sampling the largest level of an image and frees it in OpenGL.
+			 *
+			 * @param image The image.
+			 */
+			static void evictLevel(TextureImage& image);
+
+			/**
+			 * @brief Gets the size of some levels.
+			 *
+			 * Gets the size in bytes of a range of levels of an image in OpenGL.
+			 *
+			 * @param image The image.
+			 * @param first First level.
+			 * @param last Level after the last one.
+			 *
+			 * @returns The size in bytes.
+			 */
+			static size_t getLevelsSize(const TextureImage& image, int first, int last);
+
+			/**
+			 * @brief Checks if an image can be streamed.
+			 *
+			 * Checks if an image is loaded and no level of it is being copied.
+			 *
+			 * @param image The image.
+			 *
+			 * @returns Whether its levels can change.
+			 */
+			static bool isIdle(const TextureImage& image);
+
+			/**
+			 * @brief Releases the pixels of a level.
+			 *
+			 * Releases the pixels of a level from memory, if they can be read
+			 * again from the source of the image.
+			 *
+			 * @param image The image.
+			 * @param level The level.
+			 */
+			static void releaseLevel(TextureImage& image, int level);
+
+			/**
+			 * @brief Reads the levels of an image again.
+			 *
+			 * Reads the levels of an image again from its source in a worker. The
+			 * next update takes the ones that are missing.
+			 *
+			 * @param image The image.
+			 */
+			static void reload(const std::shared_ptr<TextureImage>& image);
+
+			/**
+			 * @brief Changes the sampled levels of an image.
+			 *
+			 * Clamps the sampler of an image to the levels from the given one on,
+			 * which have to be defined.
+			 *
+			 * @param image The image.
+			 * @param base New largest sampled level.
+			 */
+			static void setResidentBase(TextureImage& image, int base);
+
+			/**
+			 * @brief Starts copying a level.
+			 *
+			 * Copies a level of an image into a pixel buffer and starts its upload
+			 * into the texture. The sampler is moved to it once the copy is done.
+			 *
+			 * @param image The image.
+			 * @param level The level.
+			 */
+			static void uploadLevel(TextureImage& image, int level);
+
+			static std::vector<std::weak_ptr<TextureImage>> images;	/// Images being streamed.
+			static std::vector<std::shared_ptr<TextureImage>> reloads;	/// Images being read again, kept alive for the workers.
+			static size_t resident_bytes;								/// Bytes in video memory at the last update.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_TEXTURESTREAMER_H_
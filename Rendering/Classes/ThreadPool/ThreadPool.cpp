@@ -0,0 +1,165 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief ThreadPool class implementation file.
+ * @version 1.0.0 (2023-02-06)
+ * @date 2023-02-06
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <string>
+
+#include "Classes/TraceRecorder/TraceRecorder.h"
+
+namespace aladdin_3d {
+
+	ThreadPool::ThreadPool(size_t threads) {
+
+		// Leave the main thread its own core.
+		if (threads == 0) {
+
+			unsigned int hardware = std::thread::hardware_concurrency();
+			threads = hardware > 1 ? hardware - 1 : 1;
+
+		}
+
+		// Start the workers, each one runs jobs until the pool stops.
+		for (size_t i = 0; i < threads; i++) {
+
+			this->workers.emplace_back([this, i]() {
+
+				TraceRecorder::setThreadName("Worker " + std::to_string(i + 1));
+
+				while (true) {
+
+					std::function<void()> job;
+
+					// Wait for a job or for the pool to stop.
+					{
+						std::unique_lock<std::mutex> lock(this->mutex);
+						this->condition.wait(lock, [this]() { return this->stopping || !this->jobs.empty(); });
+
+						if (this->stopping && this->jobs.empty())
+							return;
+
+						job = std::move(this->jobs.front());
+						this->jobs.pop();
+					}
+
+					job();
+
+				}
+
+			});
+
+		}
+
+	}
+
+	ThreadPool::~ThreadPool() {
+
+		// Tell the workers to stop once the queue is empty.
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->stopping = true;
+		}
+
+		this->condition.notify_all();
+
+		// Wait for them.
+		for (size_t i = 0; i < this->workers.size(); i++)
+			this->workers[i].join();
+
+	}
+
+	ThreadPool& ThreadPool::getShared() {
+
+		static ThreadPool shared;
+		return shared;
+
+	}
+
+	size_t ThreadPool::getSize() {
+
+		return this->workers.size();
+
+	}
+
+	void ThreadPool::runChunks(Range& range) {
+
+		// Take chunks until all of them were taken.
+		for (size_t chunk = range.next++; chunk < range.chunks; chunk = range.next++) {
+
+			size_t start = chunk * range.chunk_size;
+			size_t end = std::min(start + range.chunk_size, range.count);
+			std::exception_ptr error;
+
+			try {
+				(*range.job)(start, end);
+			} catch (...) {
+				error = std::current_exception();
+			}
+
+			// Tell the caller, which may be waiting for this one.
+			{
+				std::lock_guard<std::mutex> lock(range.mutex);
+
+				if (error && !range.error)
+					range.error = error;
+
+				range.finished++;
+			}
+
+			range.condition.notify_all();
+
+		}
+
+	}
+
+	void ThreadPool::parallelFor(size_t count, const std::function<void(size_t, size_t)>& job) {
+
+		if (count == 0)
+			return;
+
+		// One chunk per worker plus one for the calling thread.
+		auto range = std::make_shared<Range>();
+		range->job = &job;
+		range->count = count;
+		range->chunks = std::min(count, this->workers.size() + 1);
+		range->chunk_size = (count + range->chunks - 1) / range->chunks;
+		range->chunks = (count + range->chunk_size - 1) / range->chunk_size;
+
+		// Ask the workers for help. Helpers that start after every chunk was taken
+		// return straight away, so they never touch the job once this returns.
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+
+			for (size_t i = 1; i < range->chunks; i++)
+				this->jobs.push([range]() { ThreadPool::runChunks(*range); });
+		}
+
+		this->condition.notify_all();
+
+		// Work on the chunks here too, then wait only for the ones the workers took.
+		// No other job is run here, so the caller never stalls on unrelated work, and
+		// calling this from a worker cannot deadlock as every chunk is always taken.
+		ThreadPool::runChunks(*range);
+
+		std::unique_lock<std::mutex> lock(range->mutex);
+		range->condition.wait(lock, [&range]() { return range->finished == range->chunks; });
+
+		if (range->error)
+			std::rethrow_exception(range->error);
+
+	}
+
+} // namespace aladdin_3d
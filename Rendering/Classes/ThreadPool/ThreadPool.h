@@ -0,0 +1,163 @@
+/**
+ * @file ThreadPool.h
+ * @brief ThreadPool class header file.
+ * @version 1.0.0 (2023-02-06)
+ * @date 2023-02-06
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_THREADPOOL_H_
+#define ALADDIN_3D_CLASS_THREADPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implements a pool of worker threads.
+	 *
+	 * Implements a fixed pool of worker threads that run the jobs submitted to
+	 * it in order. Jobs must not touch OpenGL, as the context only lives in the
+	 * main thread.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class ThreadPool {
+
+		public:
+
+			/**
+			 * @brief Creates the pool.
+			 *
+			 * Creates the pool and starts its workers. If no number of threads is
+			 * given, one less than the hardware threads are used.
+			 *
+			 * @param threads Number of worker threads.
+			 */
+			ThreadPool(size_t threads = 0);
+
+			/**
+			 * @brief Stops the pool.
+			 *
+			 * Stops the pool after finishing the queued jobs and joins the workers.
+			 */
+			~ThreadPool();
+
+			/**
+			 * @brief Gets the shared pool.
+			 *
+			 * Gets the pool shared by the whole program, creating it on first use.
+			 *
+			 * @returns The shared pool.
+			 */
+			static ThreadPool& getShared();
+
+			/**
+			 * @brief Gets the number of workers.
+			 *
+			 * Gets the number of worker threads in the pool.
+			 *
+			 * @returns The number of worker threads.
+			 */
+			size_t getSize();
+
+			/**
+			 * @brief Submits a job.
+			 *
+			 * Submits a job to the pool and returns a future for its result.
+			 *
+			 * @param job Callable to run in a worker.
+			 *
+			 * @returns A future holding the result of the job.
+			 */
+			template <typename F>
+			std::future<std::invoke_result_t<F>> submit(F&& job) {
+
+				// Wrap the job so the result can be waited for.
+				using Result = std::invoke_result_t<F>;
+				auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(job));
+				std::future<Result> result = task->get_future();
+
+				// Queue it and wake a worker.
+				{
+					std::lock_guard<std::mutex> lock(this->mutex);
+					this->jobs.push([task]() { (*task)(); });
+				}
+
+				this->condition.notify_one();
+
+				return result;
+
+			}
+
+			/**
+			 * @brief Runs a job for every index in a range.
+			 *
+			 * Splits the range [0, count) in chunks, runs them in the pool and waits
+			 * for all of them. The calling thread works on the chunks no worker has
+			 * taken yet, but never on other jobs, so it only waits for this range.
+			 *
+			 * @param count Number of indices.
+			 * @param job Callable receiving the first and last (exclusive) index of a chunk.
+			 */
+			void parallelFor(size_t count, const std::function<void(size_t, size_t)>& job);
+
+		private:
+
+			/**
+			 * @brief A range being run by parallelFor.
+			 *
+			 * The chunks of a parallelFor call and how many of them were taken and
+			 * finished, shared by the caller and the workers that help with it.
+			 */
+			struct Range {
+
+				const std::function<void(size_t, size_t)>* job = nullptr;	/// Job run on each chunk.
+				size_t count = 0;											/// Number of indices.
+				size_t chunk_size = 0;										/// Indices per chunk.
+				size_t chunks = 0;											/// Number of chunks.
+				std::atomic<size_t> next{ 0 };								/// Next chunk to take.
+				size_t finished = 0;										/// Chunks finished, guarded by the mutex.
+				std::exception_ptr error;									/// First exception thrown by a chunk.
+				std::mutex mutex;											/// Guards the finished chunks and the error.
+				std::condition_variable condition;							/// Wakes the caller when a chunk is finished.
+
+			};
+
+			/**
+			 * @brief Runs chunks of a range.
+			 *
+			 * Takes and runs chunks of a range until there are none left.
+			 *
+			 * @param range The range.
+			 */
+			static void runChunks(Range& range);
+
+			std::vector<std::thread> workers;			/// Worker threads.
+			std::queue<std::function<void()>> jobs;		/// Jobs waiting to be run.
+			std::mutex mutex;							/// Guards the job queue.
+			std::condition_variable condition;			/// Wakes the workers.
+			bool stopping = false;						/// Set when the pool is being destroyed.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_THREADPOOL_H_
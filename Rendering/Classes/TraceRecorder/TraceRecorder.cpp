@@ -0,0 +1,169 @@
+/**
+ * @file TraceRecorder.cpp
+ * @brief TraceRecorder class implementation file.
+ * @version 1.0.0 (2023-02-22)
+ * @date 2023-02-22
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "TraceRecorder.h"
+
+#include <fstream>
+#include <iostream>
+
+#include "json/json.h"
+
+namespace aladdin_3d {
+
+	std::atomic<bool> TraceRecorder::recording(false);
+	std::string TraceRecorder::path;
+	std::vector<TraceEvent> TraceRecorder::events;
+	std::map<int, std::string> TraceRecorder::thread_names = { { TRACE_GPU_THREAD, "GPU" } };
+	std::mutex TraceRecorder::mutex;
+	const std::chrono::steady_clock::time_point TraceRecorder::epoch = std::chrono::steady_clock::now();
+
+	void TraceRecorder::start(const std::string& path) {
+
+		std::lock_guard<std::mutex> lock(TraceRecorder::mutex);
+
+		TraceRecorder::path = path;
+		TraceRecorder::events.clear();
+		TraceRecorder::recording = true;
+
+		std::cout << "Trace capture started." << std::endl;
+
+	}
+
+	void TraceRecorder::stop() {
+
+		std::lock_guard<std::mutex> lock(TraceRecorder::mutex);
+
+		if (!TraceRecorder::recording)
+			return;
+
+		TraceRecorder::recording = false;
+
+		// Complete events for every span of time.
+		nlohmann::json trace_events = nlohmann::json::array();
+
+		for (size_t i = 0; i < TraceRecorder::events.size(); i++) {
+
+			const TraceEvent& event = TraceRecorder::events[i];
+
+			trace_events.push_back({
+				{ "name", event.name },
+				{ "cat", event.category },
+				{ "ph", "X" },
+				{ "ts", event.start_us },
+				{ "dur", event.duration_us },
+				{ "pid", 1 },
+				{ "tid", event.thread }
+			});
+
+		}
+
+		// Metadata events to name the threads.
+		for (auto it = TraceRecorder::thread_names.begin(); it != TraceRecorder::thread_names.end(); it++) {
+
+			trace_events.push_back({
+				{ "name", "thread_name" },
+				{ "ph", "M" },
+				{ "pid", 1 },
+				{ "tid", it->first },
+				{ "args", { { "name", it->second } } }
+			});
+
+		}
+
+		nlohmann::json trace = { { "traceEvents", trace_events }, { "displayTimeUnit", "ms" } };
+
+		// Write the file.
+		std::ofstream file_stream(TraceRecorder::path, std::ios::trunc);
+
+		if (!file_stream) {
+
+			std::cerr << "Trace error - Could not write the trace " << TraceRecorder::path << std::endl;
+			return;
+
+		}
+
+		file_stream << trace.dump();
+		TraceRecorder::events.clear();
+
+		std::cout << "Trace written to " << TraceRecorder::path << std::endl;
+
+	}
+
+	void TraceRecorder::toggle() {
+
+		if (TraceRecorder::recording)
+			TraceRecorder::stop();
+		else
+			TraceRecorder::start(TRACE_DEFAULT_FILE);
+
+	}
+
+	bool TraceRecorder::isRecording() {
+
+		return TraceRecorder::recording;
+
+	}
+
+	double TraceRecorder::getTime(std::chrono::steady_clock::time_point time) {
+
+		return std::chrono::duration<double, std::micro>(time - TraceRecorder::epoch).count();
+
+	}
+
+	void TraceRecorder::addEvent(const std::string& name, const std::string& category, double start_us, double duration_us) {
+
+		if (TraceRecorder::recording)
+			TraceRecorder::addEvent(name, category, start_us, duration_us, TraceRecorder::getThreadID());
+
+	}
+
+	void TraceRecorder::addEvent(const std::string& name, const std::string& category, double start_us, double duration_us, int thread) {
+
+		if (!TraceRecorder::recording)
+			return;
+
+		std::lock_guard<std::mutex> lock(TraceRecorder::mutex);
+
+		TraceEvent event;
+		event.name = name;
+		event.category = category;
+		event.start_us = start_us;
+		event.duration_us = duration_us;
+		event.thread = thread;
+
+		TraceRecorder::events.push_back(std::move(event));
+
+	}
+
+	void TraceRecorder::setThreadName(const std::string& name) {
+
+		int thread = TraceRecorder::getThreadID();
+
+		std::lock_guard<std::mutex> lock(TraceRecorder::mutex);
+		TraceRecorder::thread_names[thread] = name;
+
+	}
+
+	int TraceRecorder::getThreadID() {
+
+		// Number the threads as they first show up.
+		static std::atomic<int> next_id(1);
+		thread_local int id = next_id++;
+
+		return id;
+
+	}
+
+} // namespace aladdin_3d
@@ -0,0 +1,147 @@
+/**
+ * @file TraceRecorder.h
+ * @brief TraceRecorder class header file.
+ * @version 1.0.0 (2023-02-22)
+ * @date 2023-02-22
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_TRACERECORDER_H_
+#define ALADDIN_3D_CLASS_TRACERECORDER_H_
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Structs/TraceEvent/TraceEvent.h"
+
+#define TRACE_DEFAULT_FILE "trace.json"	/// File written when the capture is toggled with the hotkey.
+#define TRACE_GPU_THREAD 1000			/// Thread the GPU events are shown in.
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implements the recording of Chrome trace files.
+	 *
+	 * Implements the capture of timed events from every thread and their export
+	 * in the Chrome trace event JSON format, which chrome://tracing and Perfetto
+	 * can open. The events come from the ProfilerScope timers.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class TraceRecorder {
+
+		public:
+
+			/**
+			 * @brief Starts a capture.
+			 *
+			 * Starts capturing events, to be written in a file when it stops.
+			 *
+			 * @param path File to write the trace in.
+			 */
+			static void start(const std::string& path);
+
+			/**
+			 * @brief Stops the capture.
+			 *
+			 * Stops capturing events and writes them in the file.
+			 */
+			static void stop();
+
+			/**
+			 * @brief Toggles the capture.
+			 *
+			 * Stops the capture if there is one, or starts one into
+			 * TRACE_DEFAULT_FILE otherwise.
+			 */
+			static void toggle();
+
+			/**
+			 * @brief Checks if a capture is running.
+			 *
+			 * Checks if a capture is running.
+			 *
+			 * @returns Whether events are being captured.
+			 */
+			static bool isRecording();
+
+			/**
+			 * @brief Converts a time point.
+			 *
+			 * Converts a time point into the microseconds since the program
+			 * started, the time base of the trace.
+			 *
+			 * @param time The time point.
+			 *
+			 * @returns The microseconds since the program started.
+			 */
+			static double getTime(std::chrono::steady_clock::time_point time);
+
+			/**
+			 * @brief Adds an event.
+			 *
+			 * Adds an event of the calling thread, if a capture is running.
+			 *
+			 * @param name Name of the event.
+			 * @param category Category of the event.
+			 * @param start_us Start in microseconds, from getTime().
+			 * @param duration_us Duration in microseconds.
+			 */
+			static void addEvent(const std::string& name, const std::string& category, double start_us, double duration_us);
+
+			/**
+			 * @brief Adds an event in a given thread.
+			 *
+			 * Adds an event shown in a given thread, if a capture is running.
+			 *
+			 * @param name Name of the event.
+			 * @param category Category of the event.
+			 * @param start_us Start in microseconds, from getTime().
+			 * @param duration_us Duration in microseconds.
+			 * @param thread Thread to show it in.
+			 */
+			static void addEvent(const std::string& name, const std::string& category, double start_us, double duration_us, int thread);
+
+			/**
+			 * @brief Names the calling thread.
+			 *
+			 * Names the calling thread in the traces.
+			 *
+			 * @param name Name of the thread.
+			 */
+			static void setThreadName(const std::string& name);
+
+		private:
+
+			/**
+			 * @brief Gets the ID of the calling thread.
+			 *
+			 * Gets the small number that identifies the calling thread.
+			 *
+			 * @returns The ID of the thread.
+			 */
+			static int getThreadID();
+
+			static std::atomic<bool> recording;						/// Whether events are being captured.
+			static std::string path;								/// File the trace is written in.
+			static std::vector<TraceEvent> events;					/// Captured events.
+			static std::map<int, std::string> thread_names;			/// Names of the threads.
+			static std::mutex mutex;								/// Guards everything above.
+			static const std::chrono::steady_clock::time_point epoch;	/// When the program started.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_TRACERECORDER_H_
@@ -0,0 +1,226 @@
+/**
+ * @file Transcoder.cpp
+ * @brief Transcoder class implementation file.
+ * @version 1.0.0 (2023-02-11)
+ * @date 2023-02-11
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#include "Transcoder.h"
+
+#include <algorithm>
+#include <future>
+#include <iostream>
+
+#include "stb/stb_image.h"
+
+#include "Classes/BlockCompressor/BlockCompressor.h"
+#include "Classes/GltfParser/GltfParser.h"
+#include "Classes/Loader/Loader.h"
+#include "Classes/MipmapGenerator/MipmapGenerator.h"
+#include "Classes/Texture/Texture.h"
+#include "Classes/TextureContainer/TextureContainer.h"
+#include "Classes/ThreadPool/ThreadPool.h"
+
+namespace aladdin_3d {
+
+	int Transcoder::run(const std::string& directory, const std::string& format_name, const std::string& color_space, bool flip) {
+
+		// Get the format.
+		GLenum format = 0;
+
+		if (format_name == "bc1")
+			format = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+		else if (format_name == "bc3")
+			format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		else if (format_name == "bc5")
+			format = GL_COMPRESSED_RG_RGTC2;
+		else if (format_name != "auto") {
+
+			std::cerr << "Transcoder error - Unknown format " << format_name << ", use bc1, bc3, bc5 or auto." << std::endl;
+			return 1;
+
+		}
+
+		if (color_space != "srgb" && color_space != "linear" && color_space != "auto") {
+
+			std::cerr << "Transcoder error - Unknown color space " << color_space << ", use srgb, linear or auto." << std::endl;
+			return 1;
+
+		}
+
+		// Find the images.
+		std::vector<std::filesystem::path> inputs;
+		std::error_code error;
+
+		for (auto it = std::filesystem::recursive_directory_iterator(directory, error); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+
+			std::string extension = it->path().extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+			if (extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp")
+				inputs.push_back(it->path());
+
+		}
+
+		if (error) {
+
+			std::cerr << "Transcoder error - Could not read the directory " << directory << ": " << error.message() << std::endl;
+			return 1;
+
+		}
+
+		// Only the images materials use for color are sRGB, unless told otherwise.
+		std::set<std::filesystem::path> color_images;
+
+		if (color_space == "auto")
+			color_images = Transcoder::findColorImages(directory);
+
+		// Transcode them in the pool.
+		std::vector<std::future<bool>> results;
+
+		for (size_t i = 0; i < inputs.size(); i++) {
+
+			std::filesystem::path input = inputs[i];
+			bool srgb = color_space == "srgb" || color_images.count(std::filesystem::weakly_canonical(input, error)) > 0;
+
+			results.push_back(ThreadPool::getShared().submit([input, format, flip, srgb]() { return Transcoder::transcodeFile(input, format, flip, srgb); }));
+
+		}
+
+		int failed = 0;
+
+		for (size_t i = 0; i < results.size(); i++)
+			if (!results[i].get())
+				failed++;
+
+		std::cout << "Transcoded " << inputs.size() - failed << " of " << inputs.size() << " images." << std::endl;
+
+		return failed == 0 ? 0 : 1;
+
+	}
+
+	std::set<std::filesystem::path> Transcoder::findColorImages(const std::string& directory) {
+
+		std::set<std::filesystem::path> color_images;
+		std::error_code error;
+
+		for (auto it = std::filesystem::recursive_directory_iterator(directory, error); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+
+			std::string extension = it->path().extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+			if (extension != ".gltf")
+				continue;
+
+			// Read the materials of the file.
+			GltfDocument document;
+
+			try {
+
+				if (!GltfParser::parse(Loader::readFileContents(it->path().string().c_str()), document))
+					continue;
+
+			} catch (...) {
+
+				std::cerr << "Transcoder warning - Could not read " << it->path().string() << std::endl;
+				continue;
+
+			}
+
+			// Get the images of their base color textures.
+			for (size_t i = 0; i < document.materials.size(); i++) {
+
+				int texture_index = document.materials[i].base_color_texture;
+
+				if (texture_index < 0 || (size_t) texture_index >= document.texture_sources.size())
+					continue;
+
+				int image_index = document.texture_sources[texture_index];
+
+				if (image_index < 0)
+					image_index = texture_index;
+
+				if ((size_t) image_index >= document.images.size() || document.images[image_index].empty())
+					continue;
+
+				std::error_code path_error;
+				color_images.insert(std::filesystem::weakly_canonical(it->path().parent_path() / document.images[image_index], path_error));
+
+			}
+
+		}
+
+		return color_images;
+
+	}
+
+	bool Transcoder::transcodeFile(const std::filesystem::path& input, GLenum format, bool flip, bool srgb) {
+
+		// Skip the images that are already up to date.
+		std::filesystem::path output = Texture::getTranscodedPath(input.string(), flip, srgb, ".dds");
+		std::error_code error;
+
+		if (std::filesystem::exists(output, error) &&
+				std::filesystem::last_write_time(output, error) >= std::filesystem::last_write_time(input, error))
+			return true;
+
+		// Decode the image the same way Texture does.
+		stbi_set_flip_vertically_on_load_thread(flip);
+
+		int width = 0, height = 0, channels = 0;
+		unsigned char* image_bytes = stbi_load(input.string().c_str(), &width, &height, &channels, 4);
+
+		if (image_bytes == nullptr) {
+
+			std::cerr << "Transcoder error - Could not read the image " << input.string() << std::endl;
+			return false;
+
+		}
+
+		TextureLevel base;
+		base.width = width;
+		base.height = height;
+		base.data.assign(image_bytes, image_bytes + (size_t) width * height * 4);
+		stbi_image_free(image_bytes);
+
+		// Pick the format for the image if none was given.
+		if (format == 0) {
+
+			bool has_alpha = false;
+
+			for (size_t i = 3; i < base.data.size() && !has_alpha; i += 4)
+				has_alpha = base.data[i] != 255;
+
+			format = has_alpha ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+
+		}
+
+		// Build the mip chain and compress every level.
+		std::vector<TextureLevel> levels = MipmapGenerator::generate(base, TEXTURE_MIPMAP_FILTER, srgb);
+
+		for (size_t i = 0; i < levels.size(); i++)
+			levels[i] = BlockCompressor::compress(levels[i], format);
+
+		// Write it.
+		if (!TextureContainer::writeDDS(output.string(), format, levels)) {
+
+			std::cerr << "Transcoder error - Could not write " << output.string() << std::endl;
+			return false;
+
+		}
+
+		std::cout << input.string() << " -> " << output.string() << std::endl;
+
+		return true;
+
+	}
+
+} // namespace aladdin_3d
@@ -0,0 +1,92 @@
+/**
+ * @file Transcoder.h
+ * @brief Transcoder class header file.
+ * @version 1.0.0 (2023-02-11)
+ * @date 2023-02-11
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_CLASS_TRANSCODER_H_
+#define ALADDIN_3D_CLASS_TRANSCODER_H_
+
+#include <filesystem>
+#include <set>
+#include <string>
+
+#include "GL/glew.h"
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Implements the offline texture transcoder.
+	 *
+	 * Implements the conversion of the images stb_image can read into DDS files
+	 * with a compressed mip chain, written next to them so Texture picks them up.
+	 * The file names say whether the rows were flipped and whether the mips were
+	 * filtered as sRGB, so Texture only uses them when it asks for the same.
+	 *
+	 * @author Borja García Quiroga <garcaqub@tcd.ie>
+	 */
+	class Transcoder {
+
+		public:
+
+			/**
+			 * @brief Transcodes a directory.
+			 *
+			 * Transcodes every image in a directory and its subdirectories, in
+			 * parallel. Images whose DDS file is newer are skipped.
+			 *
+			 * @param directory Directory to transcode.
+			 * @param format_name One of "bc1", "bc3", "bc5" or "auto", which picks
+			 * BC3 for images with alpha and BC1 otherwise.
+			 * @param color_space One of "srgb", "linear" or "auto", which treats as
+			 * sRGB only the base color textures of the glTF files in the directory.
+			 * @param flip Whether to store the rows in OpenGL order, as Texture does
+			 * by default.
+			 *
+			 * @returns The exit code, 0 if every image was transcoded.
+			 */
+			static int run(const std::string& directory, const std::string& format_name, const std::string& color_space, bool flip);
+
+		private:
+
+			/**
+			 * @brief Finds the color images of a directory.
+			 *
+			 * Finds the images used as base color textures by the materials of the
+			 * glTF files in a directory and its subdirectories. The other slots,
+			 * such as normal or roughness maps, hold linear data.
+			 *
+			 * @param directory Directory to search.
+			 *
+			 * @returns The canonical paths of the color images.
+			 */
+			static std::set<std::filesystem::path> findColorImages(const std::string& directory);
+
+			/**
+			 * @brief Transcodes an image.
+			 *
+			 * Transcodes an image into a DDS file next to it.
+			 *
+			 * @param input Path to the image.
+			 * @param format OpenGL internal format to use, or 0 to pick it.
+			 * @param flip Whether to store the rows in OpenGL order.
+			 * @param srgb Whether to filter the mips as sRGB.
+			 *
+			 * @returns Whether the image was transcoded.
+			 */
+			static bool transcodeFile(const std::filesystem::path& input, GLenum format, bool flip, bool srgb);
+
+	};
+
+} // namespace aladdin_3d
+
+#endif // !ALADDIN_3D_CLASS_TRANSCODER_H_
@@ -51,6 +51,17 @@ namespace aladdin_3d {
 
 	}
 
+	void VAO::link_instance_attribute(VBO& vbo, GLuint layout, GLuint num_components, GLenum type,
+		GLsizeiptr step, void* offset) {
+
+		// Link it as any other attribute.
+		this->link_attribute(vbo, layout, num_components, type, step, offset);
+
+		// Then make it advance once per instance.
+		glVertexAttribDivisor(layout, 1);
+
+	}
+
 	void VAO::remove() {
 
 		// Deletes the VAO from the GL pipe.
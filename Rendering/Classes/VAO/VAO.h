@@ -63,6 +63,22 @@ namespace aladdin_3d {
 		void link_attribute(VBO& vbo, GLuint layout, GLuint num_components, GLenum type,
 			GLsizeiptr step, void* offset);
 
+		/**
+		 * @brief Links a per-instance VBO attribute to the VAO.
+		 *
+		 * Links a VBO attribute that advances once per instance instead of once
+		 * per vertex, for instanced draws.
+		 *
+		 * @param vbo The VBO to link the attribute to.
+		 * @param layout The layout identifier that will be used in the shader.
+		 * @param num_components The number of components that are in the list.
+		 * @param type The type of data that we will be passing.
+		 * @param step The amount of bytes we have to skip to find the next item.
+		 * @param offset The amount of data we have to skip to find the first item.
+		 */
+		void link_instance_attribute(VBO& vbo, GLuint layout, GLuint num_components, GLenum type,
+			GLsizeiptr step, void* offset);
+
 		/**
 		 * @brief Remove the VAO.
 		 *
@@ -23,6 +23,8 @@
 
 namespace aladdin_3d {
 
+	VBO::VBO() {}
+
 	VBO::VBO(const std::vector<Vertex> &vertices) {
 
 		// Generate the buffer.
@@ -34,6 +36,13 @@ namespace aladdin_3d {
 
 	}
 
+	VBO::VBO(const void* data, GLsizeiptr size) {
+
+		// Generate the buffer and link the data.
+		this->setData(data, size);
+
+	}
+
 	void VBO::bind() {
 
 		// Bind the VBO.
@@ -41,10 +50,37 @@ namespace aladdin_3d {
 
 	}
 
+	GLuint VBO::getID() {
+
+		return this->ID;
+
+	}
+
 	void VBO::remove() {
 
 		// Delete the buffer in OpenGL.
 		glDeleteBuffers(1, &this->ID);
+		this->ID = 0;
+
+	}
+
+	void VBO::setData(const void* data, GLsizeiptr size) {
+
+		// Generate the buffer the first time.
+		if (this->ID == 0)
+			glGenBuffers(1, &this->ID);
+
+		// Replace the whole store, so the driver does not wait for draws still using it.
+		glBindBuffer(GL_ARRAY_BUFFER, this->ID);
+		glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+
+	}
+
+	void VBO::updateData(const void* data, GLsizeiptr size) {
+
+		// Keep the store, so anything pointing at the buffer still does.
+		glBindBuffer(GL_ARRAY_BUFFER, this->ID);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
 
 	}
 
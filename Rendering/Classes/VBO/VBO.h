@@ -36,6 +36,13 @@ namespace aladdin_3d {
 
 	public:
 
+		/**
+		 * @brief Constructs an empty Vertex Buffer Object.
+		 *
+		 * Constructs a Vertex Buffer Object with no buffer in OpenGL yet.
+		 */
+		VBO();
+
 		/**
 		 * @brief Constructs a Vertex Buffer Object.
 		 *
@@ -45,6 +52,17 @@ namespace aladdin_3d {
 		 */
 		VBO(const std::vector<Vertex> &vertices);
 
+		/**
+		 * @brief Constructs a Vertex Buffer Object from raw data.
+		 *
+		 * Constructs a Vertex Buffer Object and fills it with any data, such as
+		 * per-instance attributes.
+		 *
+		 * @param data The data to copy.
+		 * @param size The size of the data in bytes.
+		 */
+		VBO(const void* data, GLsizeiptr size);
+
 		/**
 		 * @brief Binds the VBO.
 		 *
@@ -52,6 +70,15 @@ namespace aladdin_3d {
 		 */
 		void bind();
 
+		/**
+		 * @brief Gets the ID of the VBO.
+		 *
+		 * Gets the OpenGL ID of the VBO, 0 if there is no buffer yet.
+		 *
+		 * @returns The ID.
+		 */
+		GLuint getID();
+
 		/**
 		 * @brief Removes the VBO.
 		 *
@@ -59,6 +86,27 @@ namespace aladdin_3d {
 		 */
 		void remove();
 
+		/**
+		 * @brief Replaces the data of the VBO.
+		 *
+		 * Replaces the data of the VBO, creating the buffer if there is none.
+		 *
+		 * @param data The data to copy.
+		 * @param size The size of the data in bytes.
+		 */
+		void setData(const void* data, GLsizeiptr size);
+
+		/**
+		 * @brief Updates the data of the VBO.
+		 *
+		 * Overwrites the start of the buffer, which has to be at least as big as
+		 * the data, keeping its store.
+		 *
+		 * @param data The data to copy.
+		 * @param size The size of the data in bytes.
+		 */
+		void updateData(const void* data, GLsizeiptr size);
+
 		/**
 		 * @brief Unbinds the VBO.
 		 *
@@ -68,7 +116,7 @@ namespace aladdin_3d {
 
 	private:
 
-		GLuint ID; // GL ID of the VBO.
+		GLuint ID = 0; // GL ID of the VBO.
 
 	};
 
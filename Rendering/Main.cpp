@@ -20,7 +20,9 @@
 #include <algorithm>
 #include <chrono>
 #include <iostream>
+#include <map>
 #include <random>
+#include <string>
 #include <vector>
 
 #include "GL/glew.h"
@@ -29,9 +31,17 @@
 #include <imgui/imgui_impl_glfw_gl3.h>
 
 #include "Classes/Camera/Camera.h"
+#include "Classes/FramePacer/FramePacer.h"
+#include "Classes/FullscreenPass/FullscreenPass.h"
 #include "Classes/Light/Light.h"
 #include "Classes/Object/Object.h"
+#include "Classes/Profiler/Profiler.h"
+#include "Classes/ProfilerScope/ProfilerScope.h"
 #include "Classes/Shader/Shader.h"
+#include "Classes/Texture/Texture.h"
+#include "Classes/TextureStreamer/TextureStreamer.h"
+#include "Classes/TraceRecorder/TraceRecorder.h"
+#include "Classes/Transcoder/Transcoder.h"
 #include "Structs/BoundingBox/BoundingBox.h"
 
 void clean() {
@@ -40,10 +50,73 @@ void clean() {
 	for (size_t i = 0; i < shaders.size(); i++)
 		shaders[i].remove();
 
+	fallback_shader.remove();
+	gbuffer_shader.remove();
+	shadow_shader.remove();
+	prepass_shader.remove();
+	upsample_shader.remove();
+
+	// Delete the sample queries.
+	shaded_samples.remove();
+
+	// Delete the shadow map and the environment.
+	shadow_map.remove();
+	environment.remove();
+
+	// Delete the render targets.
+	gbuffer.remove();
+	for (aladdin_3d::FBO& target : reduced_targets)
+		target.remove();
+	scene_target.remove();
+	aladdin_3d::FullscreenPass::remove();
+
+	// Delete the instance buffer.
+	sweep.remove();
+
+	// Delete the light buffers.
+	light_clusters.remove();
+
+	// Let go of the objects and pending uploads, so the textures and matrix
+	// buffers are freed while the context still exists.
+	for (size_t i = 0; i < draw_objects.size(); i++)
+		draw_objects[i].getSceneGraph().remove();
+
+	draw_objects.clear();
+	objects.clear();
+	aladdin_3d::Texture::releasePending();
+	aladdin_3d::TextureStreamer::release();
+
+	// Delete the timer queries.
+	aladdin_3d::Profiler::remove();
+
+	// Write the trace that is still being captured.
+	aladdin_3d::TraceRecorder::stop();
+
 }
 
 void display() {
     
+    // Start measuring the frame.
+    aladdin_3d::Profiler::beginFrame();
+
+    // Let the shaders finish a compile, the fallback first so there is always something to draw.
+    // The passes below only ask for the helper shaders they use, so give the rest their turn
+    // here, or the idle check would wait for them forever.
+    aladdin_3d::Shader::startFrame();
+    fallback_shader.isReady();
+    gbuffer_shader.isReady();
+    shadow_shader.isReady();
+    prepass_shader.isReady();
+    upsample_shader.isReady();
+    
+    // Upload the textures decoded in the background and stream their levels.
+    {
+        aladdin_3d::ProfilerScope scope("Texture uploads", true);
+        aladdin_3d::Texture::processUploads();
+        aladdin_3d::TextureStreamer::update();
+        environment.processUpload();
+    }
+    
     // Init ImGUI for rendering.
     ImGui_ImplGlfwGL3_NewFrame();
     
@@ -57,6 +130,15 @@ void display() {
     ImGui::RadioButton("Van", &current_object, 1);
     ImGui::RadioButton("Bunny", &current_object, 2);
     ImGui::RadioButton("Teapot", &current_object, 3);
+    ImGui::RadioButton("Sphere", &current_object, 4);
+
+    // Nodes whose world matrix was computed again last frame.
+    size_t updated_nodes = 0;
+
+    for (size_t i = 0; i < draw_objects.size(); i++)
+        updated_nodes += draw_objects[i].getSceneGraph().getUpdatedCount(true);
+
+    ImGui::Text("Nodes updated: %zu", updated_nodes);
         
     ImGui::Text("Blinn-Phong");
     
@@ -83,6 +165,41 @@ void display() {
     ImGui::SliderFloat("F0", &cook_F0, 0.0f, 10.0);
     ImGui::SliderFloat("RoughnessC", &cook_roughness, 0.0, 2.0);
     ImGui::SliderFloat("K", &cook_k, 0.0f, 20.0f);
+    ImGui::RadioButton("Schlick", &cook_fresnel, 0);
+    ImGui::SameLine();
+    ImGui::RadioButton("Exact Fresnel", &cook_fresnel, 1);
+    ImGui::RadioButton("Beckmann", &cook_distribution, 0);
+    ImGui::SameLine();
+    ImGui::RadioButton("GGX", &cook_distribution, 1);
+    
+    ImGui::Text("Parameter sweep");
+    
+    ImGui::Checkbox("Sweep Oren-Nayar or Cook-Torrance", &sweep_enabled);
+    ImGui::SliderInt("Columns", &sweep_columns, 1, 32);
+    ImGui::SliderInt("Rows", &sweep_rows, 1, 32);
+    ImGui::SliderFloat2("Roughness rangeO", sweep_oren_roughness, 0.0f, 20.0f);
+    ImGui::SliderFloat2("Albedo range", sweep_oren_albedo, 0.0f, 5.0f);
+    ImGui::SliderFloat2("Roughness rangeC", sweep_cook_roughness, 0.0f, 2.0f);
+    ImGui::SliderFloat2("F0 range", sweep_cook_F0, 0.0f, 10.0f);
+    
+    ImGui::Text("Point lights");
+    
+    // Scatter a new rig when the count changes.
+    if (ImGui::SliderInt("Point lights", &point_light_count, 0, CLUSTER_MAX_LIGHTS))
+        light_clusters.setLights(aladdin_3d::LightClusters::buildRig(point_light_count, 7));
+    
+    ImGui::Text("Cluster light indices: %zu", point_light_count > 0 ? light_clusters.getIndexCount() : (size_t) 0);
+    
+    ImGui::Text("Shadows");
+    
+    ImGui::Checkbox("Shadows", &shadows_enabled);
+    ImGui::SameLine();
+    ImGui::Checkbox("Rotate", &turntable_enabled);
+    ImGui::Text("Shadow passes: %zu static, %zu dynamic", shadow_map.getStaticUpdates(), shadow_map.getDynamicUpdates());
+    
+    ImGui::Text("Environment: %s", environment.isReady() ? "ready" : (environment.isFiltering() ? "filtering" : "none"));
+    
+    ImGui::SliderFloat("Environment intensity", &environment_intensity, 0.0f, 4.0f);
     
     // Pass these values to the shaders.
     ImGui::Text("Shader");
@@ -92,56 +209,206 @@ void display() {
     ImGui::RadioButton("Toon", &current_shader, 1);
     ImGui::RadioButton("Oren-Nayar", &current_shader, 2);
     ImGui::RadioButton("Cook-Torrance", &current_shader, 3);
+    ImGui::Checkbox("Deferred comparison", &deferred_enabled);
+    ImGui::Checkbox("Depth pre-pass", &prepass_enabled);
+
+    for (int i = 0; i < (int) shaders.size(); i++)
+        ImGui::Combo((std::string(shader_names[i]) + " rate").c_str(), &shader_rates[i], "Full\0Half\0Quarter\0");
+
+    ImGui::Text("Shaded samples: %llu", (unsigned long long) shaded_samples.getCount());
+    ImGui::RadioButton("Grid", &deferred_layout, 0);
+    ImGui::SameLine();
+    ImGui::RadioButton("Split view", &deferred_layout, 1);
+    ImGui::SliderFloat2("Split point", split_point, 0.0f, 1.0f);
+
+    ImGui::Text("Resolution");
+
+    // Start the controller from the scale that was set by hand.
+    if (ImGui::Checkbox("Dynamic resolution", &dynamic_resolution) && dynamic_resolution)
+        resolution_controller.reset(render_scale);
+
+    ImGui::SliderFloat("Frame budget (ms)", &frame_budget, 4.0f, 50.0f);
+
+    if (!dynamic_resolution)
+        ImGui::SliderFloat("Render scale", &render_scale, 0.5f, 1.0f);
+
+    ImGui::Text("Render size: %d x %d (%.0f%%)", render_width, render_height, render_scale * 100.0f);
+
+    ImGui::Text("Frame pacing");
+
+    ImGui::RadioButton("No vsync", &swap_mode, SWAP_OFF);
+    ImGui::SameLine();
+    ImGui::RadioButton("Vsync", &swap_mode, SWAP_VSYNC);
+    ImGui::SameLine();
+    ImGui::RadioButton("Adaptive", &swap_mode, SWAP_ADAPTIVE);
+    ImGui::Checkbox("Limit frame rate", &frame_limit_enabled);
+    ImGui::SliderInt("Frames per second", &frame_limit, 15, 240);
+    ImGui::Checkbox("Idle while nothing changes", &idle_enabled);
+
+    ImGui::Text("Texture memory: %.1f / %.1f MB", aladdin_3d::TextureStreamer::getResidentBytes() / 1048576.0,
+            TEXTURE_STREAMING_BUDGET / 1048576.0);
 
     ImGui::End();
+
+    // Show the frame times.
+    aladdin_3d::Profiler::drawPanel();
     
+    // Defines shared by every shader, depending on the mode. Only the single shader
+    // views of Oren-Nayar and Cook-Torrance are swept, and only the comparison is deferred.
+    bool sweeping = sweep_enabled && (current_shader == 2 || current_shader == 3);
+    bool deferred = deferred_enabled && current_shader == -1;
+    bool comparison = current_shader == -1 && !(deferred && gbuffer_shader.isReady());
+
+    // Shaders at a reduced rate in the forward views shade the G-buffer of their
+    // object, so they use the deferred variant too.
+    std::vector<bool> reduced(shaders.size(), false);
+
+    for (int i = 0; i < (int) shaders.size(); i++)
+        reduced[i] = shader_rates[i] > 0 && !sweeping && (comparison || i == current_shader) &&
+                gbuffer_shader.isReady() && upsample_shader.isReady();
+
+    std::map<std::string, std::string> mode_defines;
+    if (sweeping) mode_defines["INSTANCED"] = "1";
+    // Until the G-buffer shader is ready the comparison is drawn forward, so only the
+    // deferred path itself gets the deferred variants.
+    if (deferred && !comparison) mode_defines["DEFERRED"] = "1";
+    if (point_light_count > 0) mode_defines["CLUSTERED"] = "1";
+    bool shadows = shadows_enabled && !sweeping && shadow_shader.isReady();
+    if (shadows) mode_defines["SHADOWS"] = "1";
+
     // Blinn-Phong.
-    shaders[0].activate();
-    shaders[0].passFloat("shininess", blinn_shininess);
-    shaders[0].passFloat("lightPower", blinn_lightPower);
-    shaders[0].passFloat("minAmbientLight", blinn_minAmbientLight);
-    
-    // Toon.
-    shaders[1].activate();
-    shaders[1].passFloat("margin", toon_margin);
-    shaders[1].passInt("steps", toon_steps);
-    shaders[1].passFloat("lightPower", toon_lightPower);
-    shaders[1].passFloat("minAmbientLight", toon_minAmbientLight);
-
-    // Oren-Nayar.
-    shaders[2].activate();
-    shaders[2].passFloat("shininess", oren_shininess);
-    shaders[2].passFloat("albedo", oren_albedo);
-    shaders[2].passFloat("roughness", oren_roughness);
-    shaders[2].passFloat("lightColorRatio", oren_ambientColRatio);
-    
-    // Cook-Torrance
-    shaders[3].activate();
-    shaders[3].passFloat("F0", cook_F0);
-    shaders[3].passFloat("roughness", cook_roughness);
-    shaders[3].passFloat("k", cook_k);
+    std::map<std::string, std::string> blinn_defines = mode_defines;
+    if (reduced[0]) blinn_defines["DEFERRED"] = "1";
+    shaders[0].selectVariant(blinn_defines);
+
+    if (shaders[0].isReady()) {
+
+        shaders[0].activate();
+        shaders[0].passFloat("shininess", blinn_shininess);
+        shaders[0].passFloat("lightPower", blinn_lightPower);
+        shaders[0].passFloat("minAmbientLight", blinn_minAmbientLight);
+
+    }
     
+    // Toon. The steps are baked into the variant.
+    std::map<std::string, std::string> toon_defines = mode_defines;
+    toon_defines["TOON_STEPS"] = std::to_string(toon_steps);
+    if (reduced[1]) toon_defines["DEFERRED"] = "1";
+    shaders[1].selectVariant(toon_defines);
+
+    if (shaders[1].isReady()) {
+
+        shaders[1].activate();
+        shaders[1].passFloat("margin", toon_margin);
+        shaders[1].passFloat("lightPower", toon_lightPower);
+        shaders[1].passFloat("minAmbientLight", toon_minAmbientLight);
+
+    }
+
+    if (current_shader == 2)
+        sweep.setGrid(sweep_columns, sweep_rows, glm::vec2(sweep_oren_roughness[0], sweep_oren_roughness[1]),
+                glm::vec2(sweep_oren_albedo[0], sweep_oren_albedo[1]));
+    else if (current_shader == 3)
+        sweep.setGrid(sweep_columns, sweep_rows, glm::vec2(sweep_cook_roughness[0], sweep_cook_roughness[1]),
+                glm::vec2(sweep_cook_F0[0], sweep_cook_F0[1]));
+
+    // Oren-Nayar. Swept instances take their roughness and albedo from the instance buffer.
+    std::map<std::string, std::string> oren_defines = mode_defines;
+    if (environment.isReady()) oren_defines["IBL"] = "1";
+    if (reduced[2]) oren_defines["DEFERRED"] = "1";
+    shaders[2].selectVariant(oren_defines);
+
+    if (shaders[2].isReady()) {
+
+        shaders[2].activate();
+        shaders[2].passFloat("shininess", oren_shininess);
+        shaders[2].passFloat("albedo", oren_albedo);
+        shaders[2].passFloat("roughness", oren_roughness);
+        shaders[2].passFloat("lightColorRatio", oren_ambientColRatio);
+        shaders[2].passFloat("environmentIntensity", environment_intensity);
+
+    }
+    
+    // Cook-Torrance. The Fresnel and distribution terms are baked into the variant,
+    // and swept instances take their roughness and F0 from the instance buffer.
+    std::map<std::string, std::string> cook_defines = mode_defines;
+    cook_defines["COOK_FRESNEL"] = std::to_string(cook_fresnel);
+    cook_defines["COOK_DISTRIBUTION"] = std::to_string(cook_distribution);
+    if (environment.isReady()) cook_defines["IBL"] = "1";
+    if (reduced[3]) cook_defines["DEFERRED"] = "1";
+    shaders[3].selectVariant(cook_defines);
+
+    if (shaders[3].isReady()) {
+
+        shaders[3].activate();
+        shaders[3].passFloat("F0", cook_F0);
+        shaders[3].passFloat("roughness", cook_roughness);
+        shaders[3].passFloat("k", cook_k);
+        shaders[3].passFloat("environmentIntensity", environment_intensity);
+
+    }
+    
+    // Pick the render scale from the GPU time of a finished frame.
+    if (dynamic_resolution) {
+
+        resolution_controller.setTarget(frame_budget);
+        render_scale = resolution_controller.update(aladdin_3d::Profiler::getLatestGPUTime());
+
+    }
+
+    // Draw the scene into its target at that scale.
+    render_width = std::max((int) (framebuffer_width * render_scale), 1);
+    render_height = std::max((int) (framebuffer_height * render_scale), 1);
+    scene_target.resize(render_width, render_height);
+
+    // Size the other targets before any of them is bound. The G-buffer is a quarter of
+    // the scene in the deferred grid and full size otherwise, each rate has its own target.
+    if (current_shader == -1 && !comparison && deferred_layout != 1)
+        gbuffer.resize(std::max(render_width / 2, 1), std::max(render_height / 2, 1));
+    else
+        gbuffer.resize(render_width, render_height);
+
+    for (int i = 0; i < 2; i++)
+        reduced_targets[i].resize(std::max(render_width >> (i + 1), 1), std::max(render_height >> (i + 1), 1));
+
+    scene_target.bind();
+
     // Specify the color of the background
     glClearColor(background.x, background.y, background.z, background.w);
 
     // Clean the back buffer and depth buffer
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    {
+        aladdin_3d::ProfilerScope scope("Clear", true);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
     
 	// Get the real current time.
 	auto current_time = std::chrono::system_clock::now();
 	double real_time = std::chrono::duration<double>(current_time.time_since_epoch()).count();
 
 	// Transformthis into the internal time.
+	double previous_time = internal_time;
 	internal_time = real_time - time_start;
 
-	// Get the current camera;
+	// The turntable only moves while it rotates.
+	if (turntable_enabled)
+		turntable_time += internal_time - previous_time;
+
+	// Get the current camera, looking at the pixels that are actually rendered.
 	aladdin_3d::Camera camera = cameras[current_camera];
+	camera.setViewport(render_width, render_height);
 	
 	// Updates and exports the camera matrix to the Vertex Shader
 	camera.update();
+	
+	// Sort the point lights into the clusters of this camera.
+	if (point_light_count > 0) {
+		aladdin_3d::ProfilerScope scope("Light clustering");
+		light_clusters.update(camera);
+	}
         
     // Get the current object to be displayed.
-    aladdin_3d::Object original_object = objects[current_object];
+    aladdin_3d::Object& original_object = objects[current_object];
     
     // Get info from the model.
     aladdin_3d::BoundingBox bb = original_object.getBoundingBox();
@@ -150,75 +417,449 @@ void display() {
     float max_dim = std::max(size.x, std::max(size.y, size.z));
     float scale_rat = NORM_SIZE / max_dim;
     
-    if (current_shader == -1) {
-    
-        // Do the same thing for each model.
-        for (int i = 0; i < shaders.size(); i++) {
-            
-            // Pass variables to the shader.
-            shaders[i].activate();
-            shaders[i].passFloat("time", internal_time);
+    // Place the objects on the turntable, one per shader in the comparison and one otherwise.
+    // The copies are only made again when the object or the layout changes, otherwise
+    // just their roots move, and nothing is computed again while the turntable stops.
+    double period = comparison ? 30.0 : 20.0;
+    float angle = (float) (std::fmod(turntable_time, period) / period * 360);
+    size_t placements = comparison ? shaders.size() : 1;
+
+    if (placed_object != current_object || draw_objects.size() != placements) {
+
+        // The copies get their own matrix buffers, so the old ones are deleted.
+        for (size_t i = 0; i < draw_objects.size(); i++)
+            draw_objects[i].getSceneGraph().remove();
+
+        draw_objects.assign(placements, original_object);
+        placed_object = current_object;
+
+    }
+
+    for (size_t i = 0; i < placements; i++) {
+
+        // Rotate the object according to time.
+        glm::quat rotation = glm::angleAxis(glm::radians(angle), glm::vec3(0.0f, 1.0f, 0.0f));
+
+        // Resize it to normalize it, and center it.
+        glm::vec3 offset = -centre * scale_rat;
+
+        if (comparison) {
 
-            // Copy the originaal object.
-            aladdin_3d::Object draw_object = original_object;
-            
-            // Rotate the object according to time.
-            draw_object.rotate(0.0, 1.0, 0.0, std::fmod(internal_time, 30) / 30 * 360);
-            
             // Rotate the object to be where it has to be depending on the iteration.
-            draw_object.rotate(0.0, 1.0, 0.0, 360 / shaders.size() * i);
-            
+            rotation = rotation * glm::angleAxis(glm::radians(360.0f / shaders.size() * i), glm::vec3(0.0f, 1.0f, 0.0f));
+
             // Move so that they do not collide.
-            draw_object.translate(0.0, 0.0, 0.7);
-            
-            // Resize it to normalize it.
-            draw_object.scale(scale_rat, scale_rat, scale_rat);
+            offset += glm::vec3(0.0f, 0.0f, 0.7f);
+
+        }
+
+        draw_objects[i].setTransform(rotation * offset, rotation, glm::vec3(scale_rat));
+
+    }
+
+    // Draw the shadow casters from the light. The objects only count as dynamic while
+    // the turntable rotates, otherwise they stay in the static cache and no pass runs.
+    if (shadows) {
+
+        aladdin_3d::ProfilerScope scope("Shadows", true);
+        aladdin_3d::Camera light_camera = shadow_map.getLightCamera();
+
+        int layout = (int) draw_objects.size();
+        uint64_t placement = aladdin_3d::ShadowMap::hash(&current_object, sizeof(current_object));
+        placement = aladdin_3d::ShadowMap::hash(&layout, sizeof(layout), placement);
+        uint64_t moving = aladdin_3d::ShadowMap::hash(&angle, sizeof(angle), placement);
+
+        shadow_map.setLight(scene_light.getPosition(), glm::vec3(0.0f));
+
+        // Static casters, or none while the turntable moves.
+        if (shadow_map.beginStatic(turntable_enabled ? 0 : moving)) {
+
+            shadow_shader.activate();
+
+            if (!turntable_enabled)
+                for (size_t i = 0; i < draw_objects.size(); i++)
+                    draw_objects[i].drawDepth(shadow_shader, light_camera);
+
+            shadow_map.end();
+
+        }
+
+        // Dynamic casters on top of the cache.
+        if (shadow_map.beginDynamic(turntable_enabled ? moving : 0)) {
+
+            shadow_shader.activate();
+
+            if (turntable_enabled)
+                for (size_t i = 0; i < draw_objects.size(); i++)
+                    draw_objects[i].drawDepth(shadow_shader, light_camera);
+
+            shadow_map.end();
+
+        }
+
+    }
+
+    // Measure the scene passes on their own, closing before the upscale and the end of the frame.
+    {
+        aladdin_3d::ProfilerScope scene_scope("Scene", true);
+
+        // Only the forward views shade per object. The pre-pass needs every full rate
+        // shader in the view ready, the fallback does not compute its depth the same way.
+        // Reduced rate objects write their own depth when they are upsampled.
+        bool forward = comparison || current_shader != -1;
+        bool prepass = forward && prepass_enabled && !sweeping && prepass_shader.isReady();
+
+        for (int i = 0; i < (int) shaders.size() && prepass; i++)
+            if ((comparison || i == current_shader) && !reduced[i])
+                prepass = shaders[i].isReady();
+
+        // Lay down the depth of everything first, so each pixel is only shaded once.
+        if (prepass) {
+
+            aladdin_3d::ProfilerScope scope("Depth pre-pass", true);
+
+            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            prepass_shader.activate();
+            prepass_shader.passFloat("time", internal_time);
+
+            for (size_t i = 0; i < draw_objects.size(); i++)
+                if (!reduced[comparison ? i : current_shader])
+                    draw_objects[i].drawDepth(prepass_shader, camera);
+
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+            // Then only shade the fragments that won.
+            glDepthFunc(GL_EQUAL);
+            glDepthMask(GL_FALSE);
+
+        }
+
+        // Only the full rate shading passes count their samples, to compare with and
+        // without the pre-pass. The reduced rate and upsample passes are left out.
+        if (current_shader == -1 && !comparison) {
+
+            // Rasterize it once and shade it with every shader.
+            displayDeferred(draw_objects[0], camera);
+
+        } else if (comparison) {
+    
+            // Do the same thing for each model.
+            for (int i = 0; i < (int) shaders.size(); i++) {
             
-            // Center the object and get it in the right position.
-            draw_object.translate(-centre.x, -centre.y, -centre.z);
+                // Use the fallback until the shader is ready, and skip it if none is.
+                bool ready = shaders[i].isReady();
+                if (!ready && !fallback_shader.isReady()) continue;
+                aladdin_3d::Shader& shader = ready ? shaders[i] : fallback_shader;
+
+                // Measure each shader on its own.
+                aladdin_3d::ProfilerScope shader_scope(ready ? shader_names[i] : "Fallback", true);
+
+                // Reduced rate shaders go through their own passes.
+                if (ready && reduced[i]) {
+
+                    displayReduced(i, draw_objects[i], camera);
+                    continue;
+
+                }
+
+                // Pass variables to the shader.
+                shader.activate();
+                shader.passFloat("time", internal_time);
+                if (ready && point_light_count > 0) light_clusters.bind(shader);
+                if (ready && shadows) shadow_map.bind(shader, camera);
+                if (ready) environment.bind(shader, camera, cook_distribution);
             
-            // Draw the current object.
-            draw_object.draw(shaders[i], camera);
+                // Draw the current object.
+                shaded_samples.begin();
+                draw_objects[i].draw(shader, camera);
+                shaded_samples.end();
             
-        }
+            }
         
-    } else {
+        } else if (shaders[current_shader].isReady() || fallback_shader.isReady()) {
         
-        // Pass variables to the shader.
-        shaders[current_shader].activate();
-        shaders[current_shader].passFloat("time", internal_time);
-        
-        // Copy the originaal object.
-        aladdin_3d::Object draw_object = original_object;
-        
-        // Rotate the object according to time.
-        draw_object.rotate(0.0, 1.0, 0.0, std::fmod(internal_time, 20) / 20 * 360);
-        
-        // Resize it to normalize it.
-        draw_object.scale(scale_rat, scale_rat, scale_rat);
+            // Use the fallback until the shader is ready.
+            aladdin_3d::Shader& shader = shaders[current_shader].isReady() ? shaders[current_shader] : fallback_shader;
+
+            // Measure the shader.
+            aladdin_3d::ProfilerScope shader_scope(shaders[current_shader].isReady() ? shader_names[current_shader] : "Fallback", true);
 
-        // Center the object and get it in the right position.
-        draw_object.translate(-centre.x, -centre.y, -centre.z);
+            // Pass variables to the shader.
+            shader.activate();
+            shader.passFloat("time", internal_time);
+            if (shaders[current_shader].isReady() && point_light_count > 0) light_clusters.bind(shader);
+            if (shaders[current_shader].isReady() && shadows) shadow_map.bind(shader, camera);
+            if (shaders[current_shader].isReady()) environment.bind(shader, camera, cook_distribution);
         
-        // Draw the current object.
-        draw_object.draw(shaders[current_shader], camera);
+            // Draw the object at a reduced rate, the whole sweep at once, or just the object.
+            if (reduced[current_shader] && shaders[current_shader].isReady()) {
+
+                displayReduced(current_shader, draw_objects[0], camera);
+
+            } else {
+
+                shaded_samples.begin();
+
+                if (sweeping && shaders[current_shader].isReady())
+                    sweep.draw(draw_objects[0], shader, camera);
+                else
+                    draw_objects[0].draw(shader, camera);
+
+                shaded_samples.end();
+
+            }
         
+        }
+
+        shaded_samples.endFrame();
+
+        // Back to the usual depth test.
+        if (prepass) {
+
+            glDepthFunc(GL_LESS);
+            glDepthMask(GL_TRUE);
+
+        }
     }
-    
+
+    // Scale the scene up to the window, under the interface.
+    scene_target.unbind();
+
+    {
+        aladdin_3d::ProfilerScope scope("Upscale", true);
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, scene_target.getID());
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, render_width, render_height, 0, 0, framebuffer_width, framebuffer_height,
+                GL_COLOR_BUFFER_BIT, render_scale < 1.0f ? GL_LINEAR : GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
     // Render ImGUI.
-    ImGui::Render();
+    {
+        aladdin_3d::ProfilerScope scope("ImGui", true);
+        ImGui::Render();
+    }
+    
+    // The frame is done.
+    aladdin_3d::Profiler::endFrame();
     
 }
 
+void displayDeferred(aladdin_3d::Object& draw_object, aladdin_3d::Camera& camera) {
+
+    // In the grid each quadrant shows the whole view, so the G-buffer is a quarter of
+    // the scene target. The split view shades different parts of a single full size one.
+    // Both are sized in display().
+    int width = render_width, height = render_height;
+    bool split = deferred_layout == 1;
+
+    // Where the split view is divided, in pixels from the bottom left.
+    int split_x = (int) (split_point[0] * width);
+    int split_y = (int) ((1.0f - split_point[1]) * height);
+
+    // Geometry pass, the only one that rasterizes the object.
+    {
+        aladdin_3d::ProfilerScope scope("G-buffer", true);
+
+        gbuffer.bind();
+        glClearColor(0.0, 0.0, 0.0, 0.0);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        gbuffer_shader.activate();
+        gbuffer_shader.passFloat("time", internal_time);
+        draw_object.draw(gbuffer_shader, camera);
+
+        gbuffer.unbind();
+    }
+
+    // Bind the G-buffer for the lighting passes.
+    for (GLuint i = 0; i < 3; i++) {
+
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, gbuffer.getTexture(i));
+
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+
+    // The lighting passes only shade what is in the G-buffer, there is no depth to test.
+    glDisable(GL_DEPTH_TEST);
+
+    // One lighting pass per shader, each in its quadrant from the top left.
+    for (int i = 0; i < (int) shaders.size(); i++) {
+
+        // Leave the quadrant empty until its variant is ready.
+        if (!shaders[i].isReady()) continue;
+
+        if (split) {
+
+            // Only shade the pixels on this side of the split point.
+            int x0 = (i % 2 == 0) ? 0 : split_x;
+            int x1 = (i % 2 == 0) ? split_x : width;
+            int y0 = (i / 2 == 0) ? split_y : 0;
+            int y1 = (i / 2 == 0) ? height : split_y;
+
+            if (x1 <= x0 || y1 <= y0) continue;
+
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(x0, y0, x1 - x0, y1 - y0);
+            glViewport(0, 0, width, height);
+
+        } else {
+
+            glViewport((i % 2) * (width / 2), (1 - i / 2) * (height / 2), width / 2, height / 2);
+
+        }
+
+        // Measure each shader on its own.
+        aladdin_3d::ProfilerScope shader_scope(shader_names[i], true);
+
+        shaders[i].activate();
+        shaders[i].passCamera(camera);
+        shaders[i].passInt("gPosition", 0);
+        shaders[i].passInt("gNormal", 1);
+        shaders[i].passInt("gAlbedo", 2);
+        if (point_light_count > 0) light_clusters.bind(shaders[i]);
+        if (shadows_enabled && shadow_shader.isReady()) shadow_map.bind(shaders[i], camera);
+        environment.bind(shaders[i], camera, cook_distribution);
+
+        aladdin_3d::FullscreenPass::draw();
+
+    }
+
+    // Mark the split with a line through the point each way.
+    if (split) {
+
+        glEnable(GL_SCISSOR_TEST);
+        glClearColor(1.0, 1.0, 1.0, 1.0);
+
+        glScissor(split_x - 1, 0, 2, height);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        glScissor(0, split_y - 1, width, 2);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+    }
+
+    glDisable(GL_SCISSOR_TEST);
+
+    // Back to drawing in the whole scene target.
+    glEnable(GL_DEPTH_TEST);
+    glViewport(0, 0, width, height);
+
+}
+
+void displayReduced(int index, aladdin_3d::Object& draw_object, aladdin_3d::Camera& camera) {
+
+    // The G-buffer is full rate, the shading is at a fraction of it each way. Both
+    // are sized in display(), so nothing is reallocated between the shaders.
+    int width = render_width, height = render_height;
+    aladdin_3d::FBO& reduced_target = reduced_targets[shader_rates[index] - 1];
+
+    // The passes need their own depth state, the pre-pass may have left it at equal.
+    GLint depth_func = GL_LESS;
+    GLboolean depth_mask = GL_TRUE;
+    glGetIntegerv(GL_DEPTH_FUNC, &depth_func);
+    glGetBooleanv(GL_DEPTH_WRITEMASK, &depth_mask);
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+
+    // Geometry pass at full rate, so the upsample knows every edge.
+    {
+        aladdin_3d::ProfilerScope scope("Reduced G-buffer", true);
+
+        gbuffer.bind();
+        glClearColor(0.0, 0.0, 0.0, 0.0);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        gbuffer_shader.activate();
+        gbuffer_shader.passFloat("time", internal_time);
+        draw_object.draw(gbuffer_shader, camera);
+
+        gbuffer.unbind();
+    }
+
+    // Bind the G-buffer for the other passes.
+    for (GLuint i = 0; i < 3; i++) {
+
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, gbuffer.getTexture(i));
+
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+    glDisable(GL_DEPTH_TEST);
+
+    // Shade one sample per block of pixels, nothing is written where there is no surface.
+    {
+        aladdin_3d::ProfilerScope scope((std::string(shader_names[index]) + " reduced").c_str(), true);
+
+        reduced_target.bind();
+        glClearColor(0.0, 0.0, 0.0, 0.0);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        shaders[index].activate();
+        shaders[index].passCamera(camera);
+        shaders[index].passInt("gPosition", 0);
+        shaders[index].passInt("gNormal", 1);
+        shaders[index].passInt("gAlbedo", 2);
+        if (point_light_count > 0) light_clusters.bind(shaders[index]);
+        if (shadows_enabled && shadow_shader.isReady()) shadow_map.bind(shaders[index], camera);
+        environment.bind(shaders[index], camera, cook_distribution);
+
+        aladdin_3d::FullscreenPass::draw();
+
+        reduced_target.unbind();
+    }
+
+    // Back to full rate, the upsample writes the depth of the surface so it sorts
+    // with the rest of the scene.
+    glViewport(0, 0, width, height);
+    glEnable(GL_DEPTH_TEST);
+
+    {
+        aladdin_3d::ProfilerScope scope("Upsample", true);
+
+        glActiveTexture(GL_TEXTURE3);
+        glBindTexture(GL_TEXTURE_2D, reduced_target.getTexture(0));
+        glActiveTexture(GL_TEXTURE0);
+
+        upsample_shader.activate();
+        upsample_shader.passInt("lowColor", 3);
+        upsample_shader.passInt("gPosition", 0);
+        upsample_shader.passInt("gNormal", 1);
+        upsample_shader.passCamera(camera);
+        glUniform2f(glGetUniformLocation(upsample_shader.getProgramID(), "lowSize"),
+                (float) reduced_target.getWidth(), (float) reduced_target.getHeight());
+
+        aladdin_3d::FullscreenPass::draw();
+    }
+
+    // Leave the depth state as it was.
+    glDepthFunc(depth_func);
+    glDepthMask(depth_mask);
+
+}
+
 void handleKeyEvents(GLFWwindow* window, int key, int scancode, int action, int mods) {
     
-    std::cerr << "HELLO HERE" << std::endl;
+    // Any key may change what is shown.
+    frame_pacer.requestFrames();
+
+    // Let ImGui see the key first, and keep it if a text field is being used.
+    ImGui_ImplGlfwGL3_KeyCallback(window, key, scancode, action, mods);
+    if (ImGui::GetIO().WantCaptureKeyboard) return;
+    
+    // Start or stop capturing a trace.
+    if (key == GLFW_KEY_F12 && action == GLFW_PRESS)
+        aladdin_3d::TraceRecorder::toggle();
     
     // Next shader.
     if (key == GLFW_KEY_P && action == GLFW_PRESS) {
         
         current_shader++;
-        if (current_shader >= shaders.size()) current_shader = -1;
+        if (current_shader >= (int) shaders.size()) current_shader = -1;
                 
     }
     
@@ -342,6 +983,82 @@ void handleKeyEvents(GLFWwindow* window, int key, int scancode, int action, int
 
 }
 
+void handleChar(GLFWwindow* window, unsigned int c) {
+
+    frame_pacer.requestFrames();
+    ImGui_ImplGlfwGL3_CharCallback(window, c);
+
+}
+
+void handleCursor([[maybe_unused]] GLFWwindow* window, [[maybe_unused]] double x, [[maybe_unused]] double y) {
+
+    // ImGui reads the cursor itself, it only needs the frames.
+    frame_pacer.requestFrames();
+
+}
+
+void handleMouseButton(GLFWwindow* window, int button, int action, int mods) {
+
+    frame_pacer.requestFrames();
+    ImGui_ImplGlfwGL3_MouseButtonCallback(window, button, action, mods);
+
+}
+
+void handleRefresh([[maybe_unused]] GLFWwindow* window) {
+
+    frame_pacer.requestFrames();
+
+}
+
+void handleScroll(GLFWwindow* window, double x, double y) {
+
+    frame_pacer.requestFrames();
+    ImGui_ImplGlfwGL3_ScrollCallback(window, x, y);
+
+}
+
+void handleResize([[maybe_unused]] GLFWwindow* window, int width, int height) {
+
+    // Draw at the new size.
+    frame_pacer.requestFrames();
+
+    // Nothing is drawn while the window is minimized, but keep the sizes valid.
+    framebuffer_width = std::max(width, 1);
+    framebuffer_height = std::max(height, 1);
+
+    // Every camera keeps the aspect ratio of the window.
+    for (size_t i = 0; i < cameras.size(); i++)
+        cameras[i].setViewport(framebuffer_width, framebuffer_height);
+
+    // The scene target follows at the current scale. The G-buffer and the reduced
+    // target are sized from it the next time they are drawn.
+    render_width = std::max((int) (framebuffer_width * render_scale), 1);
+    render_height = std::max((int) (framebuffer_height * render_scale), 1);
+    scene_target.resize(render_width, render_height);
+
+}
+
+bool isAnimating() {
+
+    // The turntable is the only thing that moves on its own, the camera moves on input.
+    if (turntable_enabled)
+        return true;
+
+    // Images and environments still loading show up when they are done.
+    if (aladdin_3d::Texture::hasPendingUploads() || environment.isFiltering())
+        return true;
+
+    // And so do the shaders still compiling. Only display() finishes them, as that
+    // may have to wait for the driver.
+    for (size_t i = 0; i < shaders.size(); i++)
+        if (shaders[i].isPending())
+            return true;
+
+    return fallback_shader.isPending() || gbuffer_shader.isPending() || shadow_shader.isPending() ||
+            prepass_shader.isPending() || upsample_shader.isPending();
+
+}
+
 void initElements() {
 
 	// Create a white light in the center of the world.
@@ -349,11 +1066,35 @@ void initElements() {
 	glm::vec4 light_color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
     scene_light = aladdin_3d::Light(light_pos, light_color);
 
+    // Get the fallback shader first, it is used while the others are compiling.
+    // All of them are only submitted here, so the driver can build them in parallel.
+    fallback_shader = aladdin_3d::Shader("fallback.vert", "fallback.frag");
+    fallback_shader.passLight(scene_light);
+
+    // Get the G-buffer and the shader that fills it, for the deferred comparison.
+    gbuffer_shader = aladdin_3d::Shader("gbuffer.vert", "gbuffer.frag");
+    gbuffer = aladdin_3d::FBO(WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2, { GL_RGBA32F, GL_RGBA16F, GL_RGBA8 });
+
+    // Get the shadow map and the shader that draws the casters into it.
+    shadow_shader = aladdin_3d::Shader("shadow_depth.vert", "shadow_depth.frag");
+    shadow_shader.passLight(scene_light);
+    shadow_map = aladdin_3d::ShadowMap(SHADOW_MAP_SIZE);
+
+    // Get the shader of the depth pre-pass.
+    prepass_shader = aladdin_3d::Shader("depth_prepass.vert", "depth_prepass.frag");
+
+    // Get the target and the shader of the reduced rate shading.
+    upsample_shader = aladdin_3d::Shader("upsample.vert", "upsample.frag");
+    reduced_targets[0] = aladdin_3d::FBO(WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2, { GL_RGBA16F }, false);
+    reduced_targets[1] = aladdin_3d::FBO(WINDOW_WIDTH / 4, WINDOW_HEIGHT / 4, { GL_RGBA16F }, false);
+
+    // Get the target the scene is rendered into before it is scaled to the window.
+    scene_target = aladdin_3d::FBO(WINDOW_WIDTH, WINDOW_HEIGHT, { GL_RGBA8 });
+
 	// Get the shaders.
 	aladdin_3d::Shader blinn_phong("blinn_phong.vert", "blinn_phong.frag");
 
-	// Pass the light to the shader.
-    blinn_phong.activate();
+    // Pass the light to the shader.
     blinn_phong.passLight(scene_light);
 
     shaders.push_back(blinn_phong);
@@ -362,7 +1103,6 @@ void initElements() {
     aladdin_3d::Shader gooch("toon.vert", "toon.frag");
 
     // Pass the light to the shader.
-    gooch.activate();
     gooch.passLight(scene_light);
 
     shaders.push_back(gooch);
@@ -371,7 +1111,6 @@ void initElements() {
     aladdin_3d::Shader oren_nayar("oren_nayar.vert", "oren_nayar.frag");
 
     // Pass the light to the shader.
-    oren_nayar.activate();
     oren_nayar.passLight(scene_light);
 
     shaders.push_back(oren_nayar);
@@ -380,7 +1119,6 @@ void initElements() {
     aladdin_3d::Shader cook_torrance("cook_torrance.vert", "cook_torrance.frag");
 
     // Pass the light to the shader.
-    cook_torrance.activate();
     cook_torrance.passLight(scene_light);
 
     shaders.push_back(cook_torrance);
@@ -404,6 +1142,9 @@ void initElements() {
     teapot.setShininess(100.0);
     objects.push_back(teapot);
     
+    // A plain sphere, to compare the BRDFs without the details of a model.
+    objects.push_back(aladdin_3d::ParameterSweep::buildSphere());
+    
 }
 
 GLFWwindow* initEnvironment(int argc, char** argv) {
@@ -433,9 +1174,6 @@ GLFWwindow* initEnvironment(int argc, char** argv) {
     }
     glfwMakeContextCurrent(window);
     
-    // Tell what function handles the events.
-    glfwSetKeyCallback(window, handleKeyEvents);
-    
     // Initialize GLEW and OpenGL.
     GLenum res = glewInit();
 
@@ -446,6 +1184,9 @@ GLFWwindow* initEnvironment(int argc, char** argv) {
         exit(1);
 
     }
+
+    // Let the driver compile the shaders on its own threads.
+    aladdin_3d::Shader::enableParallelCompile();
     
     // Get version info.
     std::cerr << "Renderer: " << glGetString(GL_RENDERER) << std::endl;
@@ -454,6 +1195,15 @@ GLFWwindow* initEnvironment(int argc, char** argv) {
     
     // Setup ImGui binding
     ImGui_ImplGlfwGL3_Init(window, true);
+    
+    // Tell what function handles the events. After ImGui, which installs its own.
+    glfwSetKeyCallback(window, handleKeyEvents);
+    glfwSetCharCallback(window, handleChar);
+    glfwSetMouseButtonCallback(window, handleMouseButton);
+    glfwSetScrollCallback(window, handleScroll);
+    glfwSetCursorPosCallback(window, handleCursor);
+    glfwSetWindowRefreshCallback(window, handleRefresh);
+    glfwSetFramebufferSizeCallback(window, handleResize);
 
     // tell GL to only draw onto a pixel if the shape is closer to the viewer
     glEnable(GL_DEPTH_TEST); // enable depth-testing
@@ -465,12 +1215,57 @@ GLFWwindow* initEnvironment(int argc, char** argv) {
 
 int main(int argc, char** argv) {
 
+	// Transcode a directory of images and exit, if asked to. No window is needed.
+	// Usage: --transcode <directory> [bc1|bc3|bc5|auto] [--srgb|--linear] [--no-flip]
+	for (int i = 1; i + 1 < argc; i++) {
+
+		if (std::string(argv[i]) != "--transcode")
+			continue;
+
+		std::string format = "auto", color_space = "auto";
+		bool flip = true;
+
+		for (int j = i + 2; j < argc; j++) {
+
+			std::string option = argv[j];
+
+			if (option == "--srgb" || option == "--linear")
+				color_space = option.substr(2);
+			else if (option == "--no-flip")
+				flip = false;
+			else if (j == i + 2)
+				format = option;
+
+		}
+
+		return aladdin_3d::Transcoder::run(argv[i + 1], format, color_space, flip);
+
+	}
+
+	// Capture a trace from the start, to see the loading too.
+	aladdin_3d::TraceRecorder::setThreadName("Main");
+
+	for (int i = 1; i + 1 < argc; i++)
+		if (std::string(argv[i]) == "--trace")
+			aladdin_3d::TraceRecorder::start(argv[i + 1]);
+
 	// Initialise the environment.
     GLFWwindow *window = initEnvironment(argc, argv);
     
 	// Initialise the objects and elements.
 	initElements();
 
+	// Size everything after the window, whose framebuffer may have more pixels than
+	// it has points.
+	int width = 0, height = 0;
+	glfwGetFramebufferSize(window, &width, &height);
+	handleResize(window, width, height);
+
+	// Start filtering the environment map, if one was given.
+	for (int i = 1; i + 1 < argc; i++)
+		if (std::string(argv[i]) == "--env")
+			environment.load(argv[i + 1]);
+
 	// Init the initial time.
 	auto current_time = std::chrono::system_clock::now();
 	time_start = std::chrono::duration<double>(current_time.time_since_epoch()).count();
@@ -478,13 +1273,38 @@ int main(int argc, char** argv) {
 	// Main loop.
     while(!glfwWindowShouldClose(window)) {
         
+        // Use the pacing chosen in the panel.
+        frame_pacer.setSwapMode(swap_mode);
+        frame_pacer.setLimit(frame_limit_enabled ? frame_limit : 0);
+        
+        // While nothing changes, sleep until an event comes or it is time to look at
+        // the background work again.
+        if (!frame_pacer.nextFrame(isAnimating() || !idle_enabled)) {
+            
+            glfwWaitEventsTimeout(FRAME_PACER_IDLE_TIMEOUT);
+            continue;
+            
+        }
+        
         // Make the things to print everything.
         display();
         
         // Update other events like input handling.
-        glfwPollEvents();
+        {
+            aladdin_3d::ProfilerScope scope("Events");
+            glfwPollEvents();
+        }
+        
+        // Hold the frame back to the limit.
+        {
+            aladdin_3d::ProfilerScope scope("Frame limiter");
+            frame_pacer.wait();
+        }
         
-        glfwSwapBuffers(window);
+        {
+            aladdin_3d::ProfilerScope scope("Swap");
+            glfwSwapBuffers(window);
+        }
         
     }
 
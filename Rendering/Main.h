@@ -3,10 +3,10 @@
  * @brief Main header aladdin 3d file.
  * @version 1.0.0 (2022-10-21)
  * @date 2022-10-21
- * @author Borja Garca Quiroga <garcaqub@tcd.ie>
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
  *
  *
- * Copyright (c) Borja Garca Quiroga, All Rights Reserved.
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
  *
  * The information and material provided below was developed as partial
  * requirements for the MSc in Computer Science at Trinity College Dublin,
@@ -29,12 +29,29 @@
 #include "GLFW/glfw3.h"
 
 #include "Classes/Camera/Camera.h"
+#include "Classes/Environment/Environment.h"
+#include "Classes/FBO/FBO.h"
+#include "Classes/FramePacer/FramePacer.h"
+#include "Classes/LightClusters/LightClusters.h"
 #include "Classes/Object/Object.h"
+#include "Classes/ParameterSweep/ParameterSweep.h"
+#include "Classes/ResolutionController/ResolutionController.h"
+#include "Classes/SampleCounter/SampleCounter.h"
 #include "Classes/Shader/Shader.h"
+#include "Classes/ShadowMap/ShadowMap.h"
 
 std::vector<aladdin_3d::Camera> cameras;	/// Holds all the existing cameras.
 std::vector<aladdin_3d::Object> objects;	/// Holds all the displayed objects.
+std::vector<aladdin_3d::Object> draw_objects;	/// Copies of the current object placed on the turntable.
+int placed_object = -1;                     /// Object the placed copies were made from.
 std::vector<aladdin_3d::Shader> shaders;	/// Holds all the initialized shanders.
+aladdin_3d::Shader fallback_shader;         /// Drawn with while the shaders are still compiling.
+aladdin_3d::Shader gbuffer_shader;          /// Writes the surfaces into the G-buffer.
+aladdin_3d::FBO gbuffer;                    /// Position, normal and albedo of the visible surfaces.
+bool deferred_enabled = false;              /// Whether the comparison shades a single G-buffer.
+int deferred_layout = 0;                    /// 0: A quadrant per shader, 1: Split view around a point.
+float split_point[2] = { 0.5, 0.5 };        /// Where the split view is divided, from the top left.
+const char* const shader_names[] = { "Blinn-Phong", "Toon", "Oren-Nayar", "Cook-Torrance" };	/// Names of the shaders, in order.
 int current_camera = 0;            /// Current camera activated.
 int current_object = 0;            /// Current camera activated.
 int current_shader = -1;           /// Current camera activated.
@@ -42,6 +59,36 @@ GLFWwindow *window = 0;						/// Window ID.
 double internal_time = 0;					/// Time that will rule everything in the game.
 double time_start = 0;						/// Time that will count as the beginning.
 aladdin_3d::Light scene_light;              /// The light in the scene.
+aladdin_3d::ParameterSweep sweep;           /// Grid of instances to compare BRDF parameters.
+aladdin_3d::LightClusters light_clusters;   /// Point lights sorted into view space clusters.
+int point_light_count = 0;                  /// How many point lights are in the scene.
+aladdin_3d::Shader shadow_shader;           /// Draws the casters into the shadow map.
+aladdin_3d::ShadowMap shadow_map;           /// Shadows of the scene light, cached while nothing moves.
+bool shadows_enabled = true;                /// Whether the scene light casts shadows.
+bool turntable_enabled = true;              /// Whether the objects rotate.
+double turntable_time = 0;                  /// Time the turntable has been rotating for.
+aladdin_3d::Environment environment;        /// Image-based lighting, if a map was given.
+float environment_intensity = 1.0;          /// Multiplier of the environment light.
+aladdin_3d::Shader prepass_shader;          /// Lays down the depth before shading.
+bool prepass_enabled = false;               /// Whether the forward views shade after a depth pre-pass.
+aladdin_3d::SampleCounter shaded_samples;   /// Samples shaded by the forward views.
+aladdin_3d::Shader upsample_shader;         /// Brings the reduced rate shading back to full rate.
+aladdin_3d::FBO reduced_targets[2];         /// Color shaded at half and at quarter rate.
+int shader_rates[4] = { 0, 0, 0, 0 };       /// Rate of each shader in the forward views. 0: Full, 1: Half, 2: Quarter.
+aladdin_3d::FBO scene_target;               /// The scene is rendered here, then scaled up to the window.
+aladdin_3d::ResolutionController resolution_controller;	/// Picks the render scale from the GPU frame time.
+bool dynamic_resolution = true;             /// Whether the render scale follows the frame budget.
+float frame_budget = 16.0;                  /// GPU time each frame should take, in milliseconds.
+float render_scale = 1.0;                   /// Scale of the scene along each side of the window.
+int framebuffer_width = WINDOW_WIDTH;       /// Width of the window in pixels.
+int framebuffer_height = WINDOW_HEIGHT;     /// Height of the window in pixels.
+int render_width = WINDOW_WIDTH;            /// Width the scene is rendered at.
+int render_height = WINDOW_HEIGHT;          /// Height the scene is rendered at.
+aladdin_3d::FramePacer frame_pacer;         /// Paces the frames and finds when nothing changes.
+int swap_mode = SWAP_VSYNC;                 /// SWAP_OFF, SWAP_VSYNC or SWAP_ADAPTIVE.
+bool frame_limit_enabled = false;           /// Whether the frame rate is limited.
+int frame_limit = 60;                       /// Highest frames per second when limited.
+bool idle_enabled = true;                   /// Whether to stop drawing while nothing changes.
 
 // Shader params.
 float blinn_shininess = 16.0;
@@ -61,6 +108,17 @@ float oren_ambientColRatio = 0.1;
 float cook_F0 = 0.8;
 float cook_roughness = 0.1;
 float cook_k = 0.2;
+int cook_fresnel = 0;               /// 0: Schlick, 1: Exact.
+int cook_distribution = 0;          /// 0: Beckmann, 1: GGX.
+
+// Parameter sweep, roughness along the columns and albedo or F0 along the rows.
+bool sweep_enabled = false;
+int sweep_columns = 16;
+int sweep_rows = 16;
+float sweep_oren_roughness[2] = { 0.0, 1.0 };
+float sweep_oren_albedo[2] = { 0.0, 2.0 };
+float sweep_cook_roughness[2] = { 0.05, 1.0 };
+float sweep_cook_F0[2] = { 0.02, 1.0 };
 
 const glm::vec4 background(82 / 255.0, 103 / 255.0, 125 / 255.0, 1.0);	/// This is just the fog color.
 
@@ -78,6 +136,31 @@ void clean();
  */
 void display();
 
+/**
+ * @brief Display the comparison with deferred shading.
+ *
+ * Rasterizes the object once into the G-buffer, then shades it with each
+ * shader in its own quadrant of the window, either showing the whole view in
+ * each one or splitting a single view around split_point.
+ *
+ * @param draw_object The object, already transformed.
+ * @param camera The camera.
+ */
+void displayDeferred(aladdin_3d::Object& draw_object, aladdin_3d::Camera& camera);
+
+/**
+ * @brief Display an object shaded at a reduced rate.
+ *
+ * Rasterizes the object into the G-buffer at full rate, shades it with the
+ * deferred variant of a shader into a smaller target, and upsamples that with
+ * weights that follow the depth and normal edges of the full rate surface.
+ *
+ * @param index Index of the shader.
+ * @param draw_object The object, already transformed.
+ * @param camera The camera.
+ */
+void displayReduced(int index, aladdin_3d::Object& draw_object, aladdin_3d::Camera& camera);
+
 /**
  * @brief Handles the key events.
  *
@@ -85,6 +168,63 @@ void display();
  */
 void handleKeyEvents(unsigned char key, int x, int y);
 
+/**
+ * @brief Handles the mouse button events.
+ *
+ * Wakes the main loop up and passes the event on to ImGui.
+ */
+void handleMouseButton(GLFWwindow* window, int button, int action, int mods);
+
+/**
+ * @brief Handles the cursor events.
+ *
+ * Wakes the main loop up, so the interface follows the cursor.
+ */
+void handleCursor(GLFWwindow* window, double x, double y);
+
+/**
+ * @brief Handles the scroll events.
+ *
+ * Wakes the main loop up and passes the event on to ImGui.
+ */
+void handleScroll(GLFWwindow* window, double x, double y);
+
+/**
+ * @brief Handles the character events.
+ *
+ * Wakes the main loop up and passes the event on to ImGui.
+ */
+void handleChar(GLFWwindow* window, unsigned int c);
+
+/**
+ * @brief Handles the window refresh events.
+ *
+ * Draws again when the contents of the window are damaged.
+ */
+void handleRefresh(GLFWwindow* window);
+
+/**
+ * @brief Handles the framebuffer resize events.
+ *
+ * Stores the new size of the window in pixels and passes it on to the cameras
+ * and the scene target. The other targets follow the next time they are drawn.
+ *
+ * @param window The window.
+ * @param width New width in pixels.
+ * @param height New height in pixels.
+ */
+void handleResize(GLFWwindow* window, int width, int height);
+
+/**
+ * @brief Checks if the scene changes on its own.
+ *
+ * Checks if anything would look different in the next frame without any input:
+ * the turntable, or work still being done in the background.
+ *
+ * @returns Whether the scene changes.
+ */
+bool isAnimating();
+
 /**
  * @brief Init the elements of the program
  *
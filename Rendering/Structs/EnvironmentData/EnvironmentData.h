@@ -0,0 +1,44 @@
+/**
+ * @file EnvironmentData.h
+ * @brief EnvironmentData struct header file.
+ * @version 1.0.0 (2023-02-27)
+ * @date 2023-02-27
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_STRUCT_ENVIRONMENTDATA_H_
+#define ALADDIN_3D_STRUCT_ENVIRONMENTDATA_H_
+
+#include <vector>
+
+#include "glm/glm.hpp"
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief A filtered environment.
+	 *
+	 * This Struct represents an environment map after filtering on the CPU:
+	 * the specular levels for each microfacet distribution, the lookup table of
+	 * the split-sum and the irradiance in spherical harmonics.
+	 */
+	struct EnvironmentData {
+
+		int width = 0;								/// Width of the first specular level, twice its height.
+		std::vector<std::vector<float>> beckmann;	/// Specular levels filtered with Beckmann, RGB, from smooth to rough.
+		std::vector<std::vector<float>> ggx;		/// Specular levels filtered with GGX, RGB, from smooth to rough.
+		std::vector<float> lut;						/// Scale and bias of F0 for Beckmann and GGX, RGBA.
+		glm::vec3 irradiance[9];					/// Irradiance over pi, in the first 9 spherical harmonics.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif //!ALADDIN_3D_STRUCT_ENVIRONMENTDATA_H_
@@ -0,0 +1,155 @@
+/**
+ * @file GltfDocument.h
+ * @brief Parsed glTF document struct header file.
+ * @version 1.0.0 (2023-03-04)
+ * @date 2023-03-04
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_STRUCT_GLTFDOCUMENT_H_
+#define ALADDIN_3D_STRUCT_GLTFDOCUMENT_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief A glTF accessor.
+	 *
+	 * This Struct holds how the elements of an accessor are laid out, and where
+	 * its sparse indices and values are, if it has any.
+	 */
+	struct GltfAccessor {
+
+		int buffer_view = -1;					/// Buffer view with the elements, -1 for all zeros.
+		size_t byte_offset = 0;					/// Offset of the first element in the view.
+		unsigned int component_type = 0;		/// OpenGL type of the components.
+		size_t count = 0;						/// Number of elements.
+		unsigned int components = 0;			/// Components per element, 0 if the type is unknown.
+		bool normalized = false;				/// Whether integer components map to [0, 1] or [-1, 1].
+		size_t sparse_count = 0;				/// Number of sparse elements, 0 for none.
+		int sparse_indices_view = -1;			/// Buffer view with the sparse indices.
+		size_t sparse_indices_offset = 0;		/// Offset of the sparse indices in their view.
+		unsigned int sparse_indices_type = 0;	/// OpenGL type of the sparse indices.
+		int sparse_values_view = -1;			/// Buffer view with the sparse values.
+		size_t sparse_values_offset = 0;		/// Offset of the sparse values in their view.
+
+	};
+
+	/**
+	 * @brief A glTF buffer view.
+	 *
+	 * This Struct holds the range of a buffer a view covers and, if it is
+	 * compressed with EXT_meshopt_compression, where its compressed data is and
+	 * how to decode it.
+	 */
+	struct GltfBufferView {
+
+		int buffer = 0;							/// Buffer the view is in.
+		size_t byte_offset = 0;					/// Offset of the view in the buffer.
+		size_t byte_length = 0;					/// Size of the view in bytes.
+		size_t byte_stride = 0;					/// Bytes from one element to the next, 0 if packed.
+		bool compressed = false;				/// Whether the view is compressed.
+		int compressed_buffer = 0;				/// Buffer with the compressed data.
+		size_t compressed_offset = 0;			/// Offset of the compressed data in its buffer.
+		size_t compressed_length = 0;			/// Size of the compressed data in bytes.
+		size_t compressed_stride = 0;			/// Size of each decoded element in bytes.
+		size_t compressed_count = 0;			/// Number of decoded elements.
+		std::string compressed_mode = "";		/// ATTRIBUTES, TRIANGLES or INDICES.
+		std::string compressed_filter = "NONE";	/// Filter to undo after decoding.
+
+	};
+
+	/**
+	 * @brief A glTF primitive.
+	 *
+	 * This Struct holds the accessors of the attributes of a primitive that are
+	 * drawn, and how its vertices make faces.
+	 */
+	struct GltfPrimitive {
+
+		int position = -1;						/// Accessor of the positions.
+		int normal = -1;						/// Accessor of the normals, -1 for none.
+		int texcoord = -1;						/// Accessor of the first texture coordinates, -1 for none.
+		int indices = -1;						/// Accessor of the indices, -1 for none.
+		int mode = 4;							/// OpenGL primitive mode, triangles by default.
+
+	};
+
+	/**
+	 * @brief A glTF mesh.
+	 *
+	 * This Struct holds the primitives of a mesh.
+	 */
+	struct GltfMesh {
+
+		std::vector<GltfPrimitive> primitives;	/// Primitives, drawn together.
+
+	};
+
+	/**
+	 * @brief A glTF node.
+	 *
+	 * This Struct holds the local transform of a node as the file gives it, its
+	 * mesh and its children.
+	 */
+	struct GltfNode {
+
+		glm::vec3 translation = glm::vec3(0.0f);			/// Translation from the parent.
+		float rotation[4] = { 0.0f, 0.0f, 0.0f, 1.0f };		/// Rotation quaternion, as x, y, z and w.
+		glm::vec3 scale = glm::vec3(1.0f);					/// Scale along each local axis.
+		bool has_matrix = false;							/// Whether the transform is given as a matrix.
+		float matrix[16] = { 0.0f };						/// Transform matrix, by columns.
+		int mesh = -1;										/// Mesh drawn with the node, -1 for none.
+		std::vector<unsigned int> children;					/// Nodes hanging from this one.
+
+	};
+
+	/**
+	 * @brief A glTF material.
+	 *
+	 * This Struct holds the name of a material and its base color texture.
+	 */
+	struct GltfMaterial {
+
+		std::string name = "";					/// Name of the material.
+		int base_color_texture = -1;			/// Texture of the base color, -1 for none.
+
+	};
+
+	/**
+	 * @brief A parsed glTF document.
+	 *
+	 * This Struct holds the parts of a glTF file the loader uses, with every
+	 * array indexed as in the file.
+	 */
+	struct GltfDocument {
+
+		std::vector<std::string> buffers;					/// URI of each buffer, empty if it has none.
+		std::vector<GltfBufferView> buffer_views;			/// Buffer views.
+		std::vector<GltfAccessor> accessors;				/// Accessors.
+		std::vector<GltfMesh> meshes;						/// Meshes.
+		std::vector<GltfNode> nodes;						/// Nodes.
+		std::vector<GltfMaterial> materials;				/// Materials.
+		std::vector<int> texture_sources;					/// Image of each texture, -1 if it does not say.
+		std::vector<std::string> images;					/// URI of each image.
+		std::vector<std::vector<unsigned int>> scenes;		/// Root nodes of each scene.
+		int scene = 0;										/// Scene to show.
+		std::vector<std::string> extensions_required;		/// Extensions needed to load the file.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif //!ALADDIN_3D_STRUCT_GLTFDOCUMENT_H_
@@ -0,0 +1,40 @@
+/**
+ * @file PointLight.h
+ * @brief PointLight struct header file.
+ * @version 1.0.0 (2023-02-25)
+ * @date 2023-02-25
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_STRUCT_POINTLIGHT_H_
+#define ALADDIN_3D_STRUCT_POINTLIGHT_H_
+
+#include "glm/glm.hpp"
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief A point light.
+	 *
+	 * This Struct represents a point light with a limited reach, so it only
+	 * lights the clusters its sphere touches.
+	 */
+	struct PointLight {
+
+		glm::vec3 position;		/// World coordinates of the light.
+		float radius;			/// Distance at which the light fades out.
+		glm::vec3 color;		/// Color of the light in RGB.
+		float intensity;		/// Multiplier of the color.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif //!ALADDIN_3D_STRUCT_POINTLIGHT_H_
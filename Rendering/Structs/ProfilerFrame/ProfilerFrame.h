@@ -0,0 +1,42 @@
+/**
+ * @file ProfilerFrame.h
+ * @brief ProfilerFrame struct header file.
+ * @version 1.0.0 (2023-02-20)
+ * @date 2023-02-20
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_STRUCT_PROFILERFRAME_H_
+#define ALADDIN_3D_STRUCT_PROFILERFRAME_H_
+
+#include <map>
+#include <string>
+
+#include "Structs/ProfilerSample/ProfilerSample.h"
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief A profiler frame struct.
+	 *
+	 * This Struct holds the measurements of one frame.
+	 */
+	struct ProfilerFrame {
+
+		double cpu_ms = 0.0;							// Milliseconds the frame took in the CPU.
+		double gpu_ms = 0.0;							// Milliseconds the frame took in the GPU.
+		bool gpu_resolved = false;						// Whether the GPU times have been read back.
+		std::map<std::string, ProfilerSample> samples;	// Time spent in each scope.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif //!ALADDIN_3D_STRUCT_PROFILERFRAME_H_
@@ -0,0 +1,37 @@
+/**
+ * @file ProfilerSample.h
+ * @brief ProfilerSample struct header file.
+ * @version 1.0.0 (2023-02-20)
+ * @date 2023-02-20
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_STRUCT_PROFILERSAMPLE_H_
+#define ALADDIN_3D_STRUCT_PROFILERSAMPLE_H_
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief A profiler sample struct.
+	 *
+	 * This Struct holds the time spent in a named scope during one frame, added
+	 * up over all the times the scope was entered.
+	 */
+	struct ProfilerSample {
+
+		double cpu_ms = 0.0;	// Milliseconds spent in the CPU.
+		double gpu_ms = 0.0;	// Milliseconds spent in the GPU, if it was measured.
+		int calls = 0;			// Times the scope was entered.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif //!ALADDIN_3D_STRUCT_PROFILERSAMPLE_H_
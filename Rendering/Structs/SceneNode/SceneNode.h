@@ -0,0 +1,43 @@
+/**
+ * @file SceneNode.h
+ * @brief SceneNode struct header file.
+ * @version 1.0.0 (2023-03-03)
+ * @date 2023-03-03
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_STRUCT_SCENENODE_H_
+#define ALADDIN_3D_STRUCT_SCENENODE_H_
+
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief A node of a scene graph.
+	 *
+	 * This Struct holds the local transform of a node as a translation, a
+	 * rotation and a scale, applied in the reverse order, and where it hangs
+	 * from in the graph.
+	 */
+	struct SceneNode {
+
+		glm::vec3 translation = glm::vec3(0.0f);			/// Translation from the parent.
+		glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);	/// Rotation, applied after the scale.
+		glm::vec3 scale = glm::vec3(1.0f);					/// Scale along each local axis.
+		int parent = -1;									/// Index of the parent, always before the node, -1 for a root.
+		int geometry = -1;									/// Index of the geometry drawn with the node, -1 for none.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif //!ALADDIN_3D_STRUCT_SCENENODE_H_
@@ -0,0 +1,38 @@
+/**
+ * @file SweepInstance.h
+ * @brief SweepInstance struct header file.
+ * @version 1.0.0 (2023-02-23)
+ * @date 2023-02-23
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_STRUCT_SWEEPINSTANCE_H_
+#define ALADDIN_3D_STRUCT_SWEEPINSTANCE_H_
+
+#include "glm/glm.hpp"
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief An instance of a parameter sweep.
+	 *
+	 * This Struct holds the per-instance attributes of one cell of a parameter
+	 * sweep, as laid out in the instance buffer.
+	 */
+	struct SweepInstance {
+
+		glm::vec4 placement;	/// World offset of the instance in xyz and its scale in w.
+		glm::vec2 parameters;	/// The two BRDF parameters of the instance.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif //!ALADDIN_3D_STRUCT_SWEEPINSTANCE_H_
@@ -0,0 +1,79 @@
+/**
+ * @file TextureImage.h
+ * @brief TextureImage struct header file.
+ * @version 1.0.0 (2023-02-06)
+ * @date 2023-02-06
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_STRUCT_TEXTUREIMAGE_H_
+#define ALADDIN_3D_STRUCT_TEXTUREIMAGE_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "GL/glew.h"
+
+#include "Structs/TextureLevel/TextureLevel.h"
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief Loading states of a texture image.
+	 *
+	 * Loading states of a texture image, in the order they go through.
+	 */
+	enum TextureImageState {
+
+		TEXTURE_IMAGE_DECODING,		// A worker is decoding the file.
+		TEXTURE_IMAGE_DECODED,		// The levels are waiting to be uploaded.
+		TEXTURE_IMAGE_UPLOADING,	// The pixels are in a PBO and the GPU is copying them.
+		TEXTURE_IMAGE_READY,		// The texture holds the image.
+		TEXTURE_IMAGE_FAILED		// The file could not be decoded.
+
+	};
+
+	/**
+	 * @brief A texture image struct.
+	 *
+	 * This Struct holds the OpenGL texture and the image data shared by all the
+	 * copies of a texture, along with the state of its asynchronous loading.
+	 * The decoding worker only writes the levels, size and source before
+	 * publishing the DECODED state, and a reloading worker only writes the
+	 * reloaded levels before clearing the reloading flag. Everything else is
+	 * only touched by the main thread.
+	 */
+	struct TextureImage {
+
+		GLuint ID = 0;										// OpenGL texture ID.
+		std::string path = "";								// File the image is read from.
+		bool flip = true;									// Whether the image is flipped vertically.
+		bool srgb = true;									// Whether the colors are sRGB encoded.
+		int width = 0;										// Width in pixels.
+		int height = 0;										// Height in pixels.
+		int channels = 0;									// Number of channels.
+		GLenum format = 0;									// Internal format of the levels.
+		std::vector<TextureLevel> levels;					// Mip chain. The pixels of the levels in OpenGL are released if there is a source.
+		std::string source = "";							// Container the levels can be read again from, empty to keep them all.
+		int resident_base = 0;								// Largest level in OpenGL, the largest the sampler uses.
+		int wanted_base = 0;								// Largest level requested since the last streaming update.
+		int streaming_level = -1;							// Level being copied from the pixel buffer by the streamer, -1 for none.
+		GLuint pbo = 0;										// Pixel buffer used for the upload.
+		GLsync fence = 0;									// Signalled when the upload is done.
+		std::atomic<int> state = TEXTURE_IMAGE_DECODING;	// Current TextureImageState.
+		std::atomic<bool> reloading = false;				// Whether a worker is reading the source again.
+		std::vector<TextureLevel> reloaded;					// Levels read again, until the streamer takes them.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif //!ALADDIN_3D_STRUCT_TEXTUREIMAGE_H_
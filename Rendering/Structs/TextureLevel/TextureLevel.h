@@ -0,0 +1,39 @@
+/**
+ * @file TextureLevel.h
+ * @brief TextureLevel struct header file.
+ * @version 1.0.0 (2023-02-11)
+ * @date 2023-02-11
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_STRUCT_TEXTURELEVEL_H_
+#define ALADDIN_3D_STRUCT_TEXTURELEVEL_H_
+
+#include <vector>
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief A texture level struct.
+	 *
+	 * This Struct holds one level of a mip chain, either as RGBA8 pixels or as
+	 * compressed blocks.
+	 */
+	struct TextureLevel {
+
+		int width = 0;						// Width in pixels.
+		int height = 0;						// Height in pixels.
+		std::vector<unsigned char> data;	// Pixels or blocks of the level.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif //!ALADDIN_3D_STRUCT_TEXTURELEVEL_H_
@@ -0,0 +1,41 @@
+/**
+ * @file TraceEvent.h
+ * @brief TraceEvent struct header file.
+ * @version 1.0.0 (2023-02-22)
+ * @date 2023-02-22
+ * @author Borja García Quiroga <garcaqub@tcd.ie>
+ *
+ *
+ * Copyright (c) Borja García Quiroga, All Rights Reserved.
+ *
+ * The information and material provided below was developed as partial
+ * requirements for the MSc in Computer Science at Trinity College Dublin,
+ * Ireland.
+ */
+
+#ifndef ALADDIN_3D_STRUCT_TRACEEVENT_H_
+#define ALADDIN_3D_STRUCT_TRACEEVENT_H_
+
+#include <string>
+
+namespace aladdin_3d {
+
+	/**
+	 * @brief A trace event struct.
+	 *
+	 * This Struct holds one complete event of a trace, a named span of time in
+	 * one thread.
+	 */
+	struct TraceEvent {
+
+		std::string name;			// Name of the event.
+		std::string category;		// Category, to filter in the viewer.
+		double start_us = 0.0;		// Start, in microseconds since the program started.
+		double duration_us = 0.0;	// Duration in microseconds.
+		int thread = 0;				// Thread it happened in.
+
+	};
+
+} // namespace aladdin_3d
+
+#endif //!ALADDIN_3D_STRUCT_TRACEEVENT_H_
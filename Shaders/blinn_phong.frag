@@ -1,18 +1,50 @@
 #version 330 core
 
+#ifdef DEFERRED
+uniform sampler2D gPosition;        // Position from the geometry pass, w is 0 where there is no surface.
+uniform sampler2D gNormal;          // Normal from the geometry pass, w is the material shininess.
+uniform sampler2D gAlbedo;          // Color from the geometry pass.
+in vec2 screenUV;                   // Where to read the G-buffer.
+
+vec3 vertexPosition;                // Position from the G-buffer.
+vec3 vertexNormal;                  // Normal from the G-buffer.
+vec3 vertexColor;                   // Color from the G-buffer.
+vec2 vertexUV = vec2(0.0);          // Not stored, the color is already resolved.
+float materialShininess;            // Shininess from the G-buffer.
+
+// Reads the surface of this pixel. Returns false where there is none.
+bool readSurface() {
+
+    vec4 position = texture(gPosition, screenUV);
+    if (position.w == 0.0) return false;
+
+    vec4 normal = texture(gNormal, screenUV);
+    vertexPosition = position.xyz;
+    vertexNormal = normal.xyz;
+    vertexColor = texture(gAlbedo, screenUV).rgb;
+    materialShininess = normal.w;
+
+    return true;
+
+}
+#else
 in vec3 vertexPosition; // Position from the VS.
 in vec3 vertexNormal;	// Normal from the VS.
 in vec3 vertexColor;	// Color from the VS.
 in vec2 vertexUV;		//UV coordinates from the VS.
+uniform float materialShininess;    // Extra shininess.
+#endif
 
 uniform vec4 lightColor;		    // Light color.
 uniform vec3 lightPos;			    // Light position.
 uniform vec3 cameraPosition;	    // Position of the camera.
-uniform float materialShininess;    // Extra shininess.
 uniform float shininess;
 uniform float lightPower;
 uniform float minAmbientLight;
 
+#include "clustered.glsl"
+#include "shadows.glsl"
+
 const float screenGamma = 2.2; // Assume the monitor is calibrated to the sRGB color space.
 
 out vec4 outColor; // Outputs color in RGBA.
@@ -30,6 +62,11 @@ vec4 interpolate(vec4 a, vec4 b, float step) {
 
 void main() {
 
+#ifdef DEFERRED
+    // Shade the surface from the G-buffer, and leave the background alone.
+    if (!readSurface()) discard;
+#endif
+
     // Get the normal ready to use.
     vec3 normal = normalize(vertexNormal);
 
@@ -76,8 +113,32 @@ void main() {
     // Get the specular final color.
     vec3 specularColor = vec3(textureColor) * specular * vec3(lightColor) * lightPower / dist;
 
+#ifdef SHADOWS
+    // Only the scene light casts shadows.
+    float shadow = getShadow(vertexPosition, normal);
+    diffuseColor *= shadow;
+    specularColor *= shadow;
+#endif
+
     // Get the final color that would go in the fragment.
     vec3 fragmentColor = ambientColor + diffuseColor + specularColor;
+
+#ifdef CLUSTERED
+    // Add the point lights of this cluster.
+    uvec2 cluster = getClusterLights(vertexPosition);
+    vec3 pointViewDir = normalize(-vertexPosition);
+
+    for (uint i = 0u; i < cluster.y; i++) {
+
+        vec3 pointDir;
+        vec3 radiance = getPointLight(texelFetch(clusterLights, int(cluster.x + i)).r, vertexPosition, pointDir);
+        float pointLambertian = max(dot(pointDir, normal), 0.0);
+        float pointSpecular = pointLambertian > 0.0 ? pow(max(dot(normalize(pointDir + pointViewDir), normal), 0.0), fragmentShininess) : 0.0;
+
+        fragmentColor += vec3(textureColor) * (pointLambertian + pointSpecular) * radiance;
+
+    }
+#endif
     
     // Apply gamma correction.
     fragmentColor = pow(fragmentColor, vec3(1.0 / screenGamma));
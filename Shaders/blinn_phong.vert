@@ -8,8 +8,9 @@ layout (location = 3) in vec2 inUV;		// UV coordinates.
 uniform mat4 Model;			// Imports the model matrix.
 uniform mat4 View;			// Imports the View matrix.
 uniform mat4 Projection;	// Imports the projection matrix.
-uniform mat4 modelView;		// Imports the modelView already multiplied.
-uniform mat4 normalMatrix;	// Imports the normal matrix.
+layout(std140) uniform NodeMatrices {
+	mat4 normalMatrix;		// Imports the normal matrix.
+};
 uniform vec3 lightPos;		// Light position.
 uniform float time;			// Time in seconds.
 uniform float velocity;		// Velocity in m/s.
@@ -19,8 +20,22 @@ out vec3 vertexColor;		// Passes the color to the fragment shader.
 out vec2 vertexUV;			// Passes the UV coordinates to the fragment shader.
 out vec3 vertexPosition;	// Passes the current vertex to the fragment shader.
 
+// Computed the same way as in depth_prepass.vert, so the depth pre-pass matches.
+invariant gl_Position;
+
+#ifdef DEFERRED
+out vec2 screenUV;			// Passes where to read the G-buffer to the fragment shader.
+#endif
+
 void main() {
 
+#ifdef DEFERRED
+	// Cover the screen with one triangle, the surface comes from the G-buffer.
+	screenUV = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+	gl_Position = vec4(screenUV * 2.0 - 1.0, 0.0, 1.0);
+	return;
+#endif
+
 	// Assigns the direct passes.
 	vertexNormal = vec3(normalMatrix * vec4(inNormal, 0.0));
 	vertexColor = inColor;
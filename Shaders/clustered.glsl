@@ -0,0 +1,53 @@
+// Clustered point lights, shared by the forward and deferred shaders.
+// Included after the uniforms of each shader, only used by the CLUSTERED variant.
+
+#ifdef CLUSTERED
+
+#define MAX_POINT_LIGHTS 256
+
+layout(std140) uniform PointLights {
+    vec4 pointLightPositions[MAX_POINT_LIGHTS];     // View space position, and radius in w.
+    vec4 pointLightColors[MAX_POINT_LIGHTS];        // Color, and intensity in w.
+};
+
+uniform usamplerBuffer clusterTable;    // First index and count of the lights of each cluster.
+uniform usamplerBuffer clusterLights;   // Light indices of all the clusters, one after the other.
+uniform ivec3 clusterGrid;              // Number of clusters in each axis.
+uniform vec2 clusterDepth;              // Scale and bias to get the slice from the log of the depth.
+uniform vec4 clusterViewport;           // Viewport the clusters cover, in pixels.
+
+// Gets where the lights of the cluster of this fragment start, and how many there are.
+uvec2 getClusterLights(vec3 position) {
+
+    // Tile from the pixel, slice from the depth.
+    vec2 screen = clamp((gl_FragCoord.xy - clusterViewport.xy) / clusterViewport.zw, 0.0, 0.999999);
+    ivec2 tile = ivec2(screen * vec2(clusterGrid.xy));
+    int slice = int(floor(log(max(-position.z, 1e-4)) * clusterDepth.x + clusterDepth.y));
+    slice = clamp(slice, 0, clusterGrid.z - 1);
+
+    int cluster = (slice * clusterGrid.y + tile.y) * clusterGrid.x + tile.x;
+
+    return texelFetch(clusterTable, cluster).rg;
+
+}
+
+// Gets the radiance of a point light at a position, and the direction towards it.
+vec3 getPointLight(uint index, vec3 position, out vec3 direction) {
+
+    vec4 light = pointLightPositions[index];
+    vec4 color = pointLightColors[index];
+
+    direction = light.xyz - position;
+    float dist = length(direction);
+    direction /= max(dist, 1e-4);
+
+    // Inverse square falloff, windowed so it reaches zero at the radius.
+    float ratio = dist / light.w;
+    float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+    float attenuation = window * window / (dist * dist + 1.0);
+
+    return color.rgb * color.a * attenuation;
+
+}
+
+#endif
@@ -1,20 +1,67 @@
 #version 330 core
 
+#ifdef DEFERRED
+uniform sampler2D gPosition;        // Position from the geometry pass, w is 0 where there is no surface.
+uniform sampler2D gNormal;          // Normal from the geometry pass, w is the material shininess.
+uniform sampler2D gAlbedo;          // Color from the geometry pass.
+in vec2 screenUV;                   // Where to read the G-buffer.
+
+vec3 vertexPosition;                // Position from the G-buffer.
+vec3 vertexNormal;                  // Normal from the G-buffer.
+vec3 vertexColor;                   // Color from the G-buffer.
+vec2 vertexUV = vec2(0.0);          // Not stored, the color is already resolved.
+float materialShininess;            // Shininess from the G-buffer.
+
+// Reads the surface of this pixel. Returns false where there is none.
+bool readSurface() {
+
+    vec4 position = texture(gPosition, screenUV);
+    if (position.w == 0.0) return false;
+
+    vec4 normal = texture(gNormal, screenUV);
+    vertexPosition = position.xyz;
+    vertexNormal = normal.xyz;
+    vertexColor = texture(gAlbedo, screenUV).rgb;
+    materialShininess = normal.w;
+
+    return true;
+
+}
+#else
 in vec3 vertexPosition; // Position from the VS.
 in vec3 vertexNormal;    // Normal from the VS.
 in vec3 vertexColor;    // Color from the VS.
 in vec2 vertexUV;        //UV coordinates from the VS.
+uniform float materialShininess;    // Whether to use the texture specular color or not.
+#endif
 
 uniform vec4 lightColor;            // Light color.
 uniform vec3 lightPos;                // Light position.
 uniform vec3 cameraPosition;        // Position of the camera.
-uniform float materialShininess;    // Whether to use the texture specular color or not.
+#ifdef INSTANCED
+flat in vec2 instanceParameters;    // Roughness and F0 of the instance, from the sweep.
+#define roughness instanceParameters.x
+#define F0 instanceParameters.y
+#else
 uniform float F0;
 uniform float roughness;
+#endif
 uniform float k;
 
+#include "clustered.glsl"
+#include "shadows.glsl"
+#include "environment.glsl"
+
 const float PI = 3.1415926535897932384626433832795;
 
+// Terms baked in by the variant.
+#ifndef COOK_FRESNEL
+#define COOK_FRESNEL 0              // 0: Schlick, 1: Exact dielectric Fresnel.
+#endif
+#ifndef COOK_DISTRIBUTION
+#define COOK_DISTRIBUTION 0         // 0: Beckmann, 1: GGX.
+#endif
+
 out vec4 outColor; // Outputs color in RGBA.
 
 vec3 CookTorrance(vec3 materialDiffuseColor, vec3 materialSpecularColor, vec3 normal, vec3 lightDir, vec3 viewDir, vec3 lightColor) {
@@ -29,16 +76,33 @@ vec3 CookTorrance(vec3 materialDiffuseColor, vec3 materialSpecularColor, vec3 no
         float NdotV = max(0, dot(normal, viewDir));
         float VdotH = max(0, dot(lightDir, H));
         
+#if COOK_FRESNEL == 1
+        // Exact Fresnel reflectance for the index of refraction matching F0
+        float sqrt_F0 = sqrt(min(F0, 0.99));
+        float eta = (1.0 + sqrt_F0) / (1.0 - sqrt_F0);
+        float g = sqrt(eta * eta - 1.0 + VdotH * VdotH);
+        float f1 = (g - VdotH) / (g + VdotH);
+        float f2 = (VdotH * (g + VdotH) - 1.0) / (VdotH * (g - VdotH) + 1.0);
+        float F = 0.5 * f1 * f1 * (1.0 + f2 * f2);
+#else
         // Fresnel reflectance
         float F = pow(1.0 - VdotH, 5.0);
         F *= (1.0 - F0);
         F += F0;
+#endif
         
+#if COOK_DISTRIBUTION == 1
+        // Microfacet distribution by Trowbridge-Reitz (GGX), same normalisation as Beckmann below
+        float alpha_squared = roughness * roughness * roughness * roughness;
+        float d = NdotH * NdotH * (alpha_squared - 1.0) + 1.0;
+        float D = alpha_squared / (4.0 * d * d);
+#else
         // Microfacet distribution by Beckmann
         float m_squared = roughness * roughness;
         float r1 = 1.0 / (4.0 * m_squared * pow(NdotH, 4.0));
         float r2 = (NdotH * NdotH - 1.0) / (m_squared * NdotH * NdotH);
         float D = r1 * exp(r2);
+#endif
         
         // Geometric shadowing
         float two_NdotH = 2.0 * NdotH;
@@ -58,6 +122,11 @@ vec3 CookTorrance(vec3 materialDiffuseColor, vec3 materialSpecularColor, vec3 no
 
 void main() {
 
+#ifdef DEFERRED
+    // Shade the surface from the G-buffer, and leave the background alone.
+    if (!readSurface()) discard;
+#endif
+
     // Get the normal ready to use.
     vec3 normal = normalize(vertexNormal);
     
@@ -71,6 +140,34 @@ void main() {
     vec4 fragmentColor = vec4(vertexColor, 1.0);
     
     vec3 color = CookTorrance(fragmentColor.rgb, lightColor.rgb, normal, lightDir, viewDir, lightColor.rgb);
+
+#ifdef SHADOWS
+    // Only the scene light casts shadows.
+    color *= getShadow(vertexPosition, normal);
+#endif
+
+#ifdef IBL
+    // Light from the environment, the prefiltered radiance times the scale and bias of F0.
+    float NdotV = max(dot(normal, viewDir), 0.0);
+    vec2 environmentBRDF = getEnvironmentBRDF(NdotV, roughness);
+    vec3 prefiltered = getPrefiltered(reflect(-viewDir, normal), roughness);
+
+    color += fragmentColor.rgb * getIrradiance(normal) + prefiltered * (min(F0, 1.0) * environmentBRDF.x + environmentBRDF.y);
+#endif
+
+#ifdef CLUSTERED
+    // Add the point lights of this cluster.
+    uvec2 cluster = getClusterLights(vertexPosition);
+
+    for (uint i = 0u; i < cluster.y; i++) {
+
+        vec3 pointDir;
+        vec3 radiance = getPointLight(texelFetch(clusterLights, int(cluster.x + i)).r, vertexPosition, pointDir);
+
+        color += CookTorrance(fragmentColor.rgb, radiance, normal, pointDir, viewDir, radiance);
+
+    }
+#endif
     
     // Clip colors.
     color.x = (color.x > 1.0) ? 1.0 : color.x;
@@ -0,0 +1,6 @@
+#version 330 core
+
+// Nothing to write, the pre-pass only lays down the depth.
+void main() {
+
+}
@@ -0,0 +1,28 @@
+#version 330 core
+
+layout (location = 0) in vec3 inVertex;	// Vertex, from the positions alone.
+
+uniform mat4 Model;			// Imports the model matrix.
+uniform mat4 View;			// Imports the View matrix.
+uniform mat4 Projection;	// Imports the projection matrix.
+uniform float time;			// Time in seconds.
+uniform float velocity;		// Velocity in m/s.
+
+// The depth has to match the shading pass bit for bit, so it is computed the same way.
+invariant gl_Position;
+
+void main() {
+
+	// Make the MRU calculations.
+	float displacement = velocity * time;
+
+	// Get the point after applying Model transformations.
+	vec4 transformedPosition = Model * vec4(inVertex, 1.0);
+
+	// Make it move.
+	transformedPosition.z -= displacement;
+
+	// Sets the visualized position by applying the camera matrix.
+	gl_Position = Projection * View * transformedPosition;
+
+}
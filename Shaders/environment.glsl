@@ -0,0 +1,54 @@
+// Image-based lighting from a filtered environment map, split in two sums.
+// Included after the uniforms of each shader, only used by the IBL variant.
+
+#ifdef IBL
+
+uniform sampler2D environmentSpecular;  // Prefiltered radiance, a level per roughness.
+uniform sampler2D environmentLUT;       // Scale and bias of F0, Beckmann in rg and GGX in ba.
+uniform vec3 environmentSH[9];          // Irradiance over pi in spherical harmonics.
+uniform mat3 environmentRotation;       // From view space to the directions of the map.
+uniform int environmentDistribution;    // 0: Beckmann, 1: GGX.
+uniform float environmentLevels;        // Number of specular levels.
+uniform float environmentIntensity;     // Multiplier of all the environment light.
+
+const float ENVIRONMENT_PI = 3.1415926535897932384626433832795;
+
+// Gets the diffuse light arriving at a view space normal, over pi.
+vec3 getIrradiance(vec3 normal) {
+
+    vec3 d = normalize(environmentRotation * normal);
+
+    vec3 irradiance = environmentSH[0] * 0.282095
+        + environmentSH[1] * 0.488603 * d.y
+        + environmentSH[2] * 0.488603 * d.z
+        + environmentSH[3] * 0.488603 * d.x
+        + environmentSH[4] * 1.092548 * d.x * d.y
+        + environmentSH[5] * 1.092548 * d.y * d.z
+        + environmentSH[6] * 0.315392 * (3.0 * d.z * d.z - 1.0)
+        + environmentSH[7] * 1.092548 * d.x * d.z
+        + environmentSH[8] * 0.546274 * (d.x * d.x - d.y * d.y);
+
+    return max(irradiance, vec3(0.0)) * environmentIntensity;
+
+}
+
+// Gets the light reflected around a view space direction, blurred by the roughness.
+vec3 getPrefiltered(vec3 direction, float roughness) {
+
+    vec3 d = normalize(environmentRotation * direction);
+    vec2 uv = vec2(atan(d.x, -d.z) / (2.0 * ENVIRONMENT_PI) + 0.5, acos(clamp(d.y, -1.0, 1.0)) / ENVIRONMENT_PI);
+
+    return textureLod(environmentSpecular, uv, clamp(roughness, 0.0, 1.0) * (environmentLevels - 1.0)).rgb * environmentIntensity;
+
+}
+
+// Gets the scale and bias of F0 for the second sum.
+vec2 getEnvironmentBRDF(float NdotV, float roughness) {
+
+    vec4 lut = texture(environmentLUT, vec2(clamp(NdotV, 0.0, 1.0), clamp(roughness, 0.0, 1.0)));
+
+    return environmentDistribution == 1 ? lut.ba : lut.rg;
+
+}
+
+#endif
@@ -0,0 +1,21 @@
+#version 330 core
+
+in vec3 vertexPosition; // Position from the VS.
+in vec3 vertexNormal;	// Normal from the VS.
+in vec3 vertexColor;	// Color from the VS.
+
+uniform vec3 lightPos;	// Light position.
+
+out vec4 outColor; // Outputs color in RGBA.
+
+// Plain Lambert shading, used while the real shaders are still compiling.
+void main() {
+
+    vec3 normal = normalize(vertexNormal);
+    vec3 lightDir = normalize(lightPos - vertexPosition);
+
+    float lambertian = max(dot(lightDir, normal), 0.0);
+
+    outColor = vec4(vertexColor * (0.25 + 0.75 * lambertian), 1.0);
+
+}
@@ -0,0 +1,31 @@
+#version 330 core
+
+layout (location = 0) in vec3 inVertex;	// Vertex.
+layout (location = 1) in vec3 inNormal;	// Normal (not necessarily normalized).
+layout (location = 2) in vec3 inColor;	// Color (not necessarily normalized).
+
+uniform mat4 Model;			// Imports the model matrix.
+uniform mat4 View;			// Imports the View matrix.
+uniform mat4 Projection;	// Imports the projection matrix.
+layout(std140) uniform NodeMatrices {
+	mat4 normalMatrix;		// Imports the normal matrix.
+};
+
+out vec3 vertexNormal;		// Passes the normal to the fragment shader.
+out vec3 vertexColor;		// Passes the color to the fragment shader.
+out vec3 vertexPosition;	// Passes the current vertex to the fragment shader.
+
+void main() {
+
+	// Assigns the direct passes.
+	vertexNormal = vec3(normalMatrix * vec4(inNormal, 0.0));
+	vertexColor = inColor;
+
+	// Calculates the vertex by applying the transforms to it.
+	vec4 tmpVertexPosition = View * Model * vec4(inVertex, 1.0);
+	vertexPosition = vec3(tmpVertexPosition) / tmpVertexPosition.w;
+
+	// Sets the visualized position by applying the camera matrix.
+	gl_Position = Projection * tmpVertexPosition;
+
+}
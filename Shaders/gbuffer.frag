@@ -0,0 +1,21 @@
+#version 330 core
+
+in vec3 vertexPosition; // Position from the VS.
+in vec3 vertexNormal;	// Normal from the VS.
+in vec3 vertexColor;	// Color from the VS.
+in vec2 vertexUV;		// UV coordinates from the VS.
+
+uniform float materialShininess;    // Shininess of the material.
+
+layout (location = 0) out vec4 outPosition; // Position, w marks that there is a surface.
+layout (location = 1) out vec4 outNormal;   // Normal, w is the material shininess.
+layout (location = 2) out vec4 outAlbedo;   // Surface color.
+
+// Writes the surface into the G-buffer, the lighting passes shade it later.
+void main() {
+
+    outPosition = vec4(vertexPosition, 1.0);
+    outNormal = vec4(vertexNormal, materialShininess);
+    outAlbedo = vec4(vertexColor, 1.0);
+
+}
@@ -1,19 +1,58 @@
 #version 330 core
 
+#ifdef DEFERRED
+uniform sampler2D gPosition;        // Position from the geometry pass, w is 0 where there is no surface.
+uniform sampler2D gNormal;          // Normal from the geometry pass, w is the material shininess.
+uniform sampler2D gAlbedo;          // Color from the geometry pass.
+in vec2 screenUV;                   // Where to read the G-buffer.
+
+vec3 vertexPosition;                // Position from the G-buffer.
+vec3 vertexNormal;                  // Normal from the G-buffer.
+vec3 vertexColor;                   // Color from the G-buffer.
+vec2 vertexUV = vec2(0.0);          // Not stored, the color is already resolved.
+float materialShininess;            // Shininess from the G-buffer.
+
+// Reads the surface of this pixel. Returns false where there is none.
+bool readSurface() {
+
+    vec4 position = texture(gPosition, screenUV);
+    if (position.w == 0.0) return false;
+
+    vec4 normal = texture(gNormal, screenUV);
+    vertexPosition = position.xyz;
+    vertexNormal = normal.xyz;
+    vertexColor = texture(gAlbedo, screenUV).rgb;
+    materialShininess = normal.w;
+
+    return true;
+
+}
+#else
 in vec3 vertexPosition; // Position from the VS.
 in vec3 vertexNormal;    // Normal from the VS.
 in vec3 vertexColor;    // Color from the VS.
 in vec2 vertexUV;        //UV coordinates from the VS.
+uniform float materialShininess;    // Extra shininess.
+#endif
 
 uniform vec4 lightColor;            // Light color.
 uniform vec3 lightPos;              // Light position.
 uniform vec3 cameraPosition;        // Position of the camera.
-uniform float materialShininess;    // Extra shininess.
 uniform float shininess;
+#ifdef INSTANCED
+flat in vec2 instanceParameters;    // Roughness and albedo of the instance, from the sweep.
+#define roughness instanceParameters.x
+#define albedo instanceParameters.y
+#else
 uniform float albedo;
 uniform float roughness;
+#endif
 uniform float lightColorRatio;
 
+#include "clustered.glsl"
+#include "shadows.glsl"
+#include "environment.glsl"
+
 const float PI = 3.1415926535897932384626433832795;
 
 vec3 ambientCol = lightColor.rgb * lightColorRatio;
@@ -32,6 +71,11 @@ float t(float s, vec3 lightDir, vec3 norm, vec3 eye) {
 }
 
 void main() {
+
+#ifdef DEFERRED
+    // Shade the surface from the G-buffer, and leave the background alone.
+    if (!readSurface()) discard;
+#endif
     
     // Get the normal ready to use.
     vec3 normal = normalize(vertexNormal);
@@ -58,8 +102,38 @@ void main() {
         specularity = pow(specularAngle, shininess);
     }
     
+#ifdef SHADOWS
+    // Only the scene light casts shadows.
+    float shadow = getShadow(vertexPosition, normal);
+    lambert *= shadow;
+    specularity *= shadow;
+#endif
+
     vec3 fragColour = ambientCol + lambert * textureColor.rgb + specularity * specularCol;
 
+#ifdef IBL
+    // Diffuse light from the environment. Under uniform light only the A term of the
+    // model is left, a is already divided by pi.
+    fragColour += albedo * textureColor.rgb * getIrradiance(normal) * a * PI;
+#endif
+
+#ifdef CLUSTERED
+    // Add the point lights of this cluster.
+    uvec2 cluster = getClusterLights(vertexPosition);
+    vec3 pointViewDir = normalize(viewDir);
+
+    for (uint i = 0u; i < cluster.y; i++) {
+
+        vec3 pointDir;
+        vec3 radiance = getPointLight(texelFetch(clusterLights, int(cluster.x + i)).r, vertexPosition, pointDir);
+        float pointS = dot(pointDir, pointViewDir) - (dot(normal, pointDir) * dot(normal, pointViewDir));
+        float pointLambert = albedo * max(dot(normal, pointDir), 0.0) * (a + (b * (pointS / t(pointS, pointDir, normal, pointViewDir))));
+
+        fragColour += pointLambert * textureColor.rgb * radiance;
+
+    }
+#endif
+
     outColor = vec4(fragColour, 1);
 
 }
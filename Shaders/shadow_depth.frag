@@ -0,0 +1,6 @@
+#version 330 core
+
+// Nothing to write, the depth is all the shadow map keeps.
+void main() {
+
+}
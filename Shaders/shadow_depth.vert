@@ -0,0 +1,14 @@
+#version 330 core
+
+layout (location = 0) in vec3 inVertex;	// Vertex.
+
+uniform mat4 Model;			// Imports the model matrix.
+uniform mat4 View;			// Imports the View matrix of the light.
+uniform mat4 Projection;	// Imports the projection matrix of the light.
+
+// Only the depth from the light is needed.
+void main() {
+
+	gl_Position = Projection * View * Model * vec4(inVertex, 1.0);
+
+}
@@ -0,0 +1,32 @@
+// Shadow map of the scene light, shared by the forward and deferred shaders.
+// Included after the uniforms of each shader, only used by the SHADOWS variant.
+
+#ifdef SHADOWS
+
+uniform sampler2DShadow shadowMap;  // Depth from the light, compared when sampled.
+uniform mat4 shadowMatrix;          // From view space to the coordinates of the map.
+
+// Gets how lit a view space position is, from 0 in shadow to 1.
+float getShadow(vec3 position, vec3 normal) {
+
+    // Push the point out a bit along the normal, so the surface does not shadow itself.
+    vec4 coord = shadowMatrix * vec4(position + normalize(normal) * 0.01, 1.0);
+    coord.xyz /= coord.w;
+
+    // Everything out of the light frustum is lit.
+    if (coord.z >= 1.0 || any(lessThan(coord.xy, vec2(0.0))) || any(greaterThan(coord.xy, vec2(1.0))))
+        return 1.0;
+
+    // 3x3 filtered comparisons, each one already blending 4 texels.
+    vec2 texel = 1.0 / vec2(textureSize(shadowMap, 0));
+    float lit = 0.0;
+
+    for (int y = -1; y <= 1; y++)
+        for (int x = -1; x <= 1; x++)
+            lit += texture(shadowMap, vec3(coord.xy + vec2(x, y) * texel, coord.z));
+
+    return lit / 9.0;
+
+}
+
+#endif
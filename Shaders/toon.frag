@@ -1,19 +1,55 @@
 #version 330 core
 
+#ifdef DEFERRED
+uniform sampler2D gPosition;        // Position from the geometry pass, w is 0 where there is no surface.
+uniform sampler2D gNormal;          // Normal from the geometry pass, w is the material shininess.
+uniform sampler2D gAlbedo;          // Color from the geometry pass.
+in vec2 screenUV;                   // Where to read the G-buffer.
+
+vec3 vertexPosition;                // Position from the G-buffer.
+vec3 vertexNormal;                  // Normal from the G-buffer.
+vec3 vertexColor;                   // Color from the G-buffer.
+vec2 vertexUV = vec2(0.0);          // Not stored, the color is already resolved.
+float materialShininess;            // Shininess from the G-buffer.
+
+// Reads the surface of this pixel. Returns false where there is none.
+bool readSurface() {
+
+    vec4 position = texture(gPosition, screenUV);
+    if (position.w == 0.0) return false;
+
+    vec4 normal = texture(gNormal, screenUV);
+    vertexPosition = position.xyz;
+    vertexNormal = normal.xyz;
+    vertexColor = texture(gAlbedo, screenUV).rgb;
+    materialShininess = normal.w;
+
+    return true;
+
+}
+#else
 in vec3 vertexPosition; // Position from the VS.
 in vec3 vertexNormal;	// Normal from the VS.
 in vec3 vertexColor;	// Color from the VS.
 in vec2 vertexUV;		//UV coordinates from the VS.
+uniform float materialShininess;    // Shininess extra.
+#endif
 
 uniform vec4 lightColor;		    // Light color.
 uniform vec3 lightPos;			    // Light position.
 uniform vec3 cameraPosition;	    // Position of the camera.
-uniform float materialShininess;    // Shininess extra.
 uniform float margin;
+#ifdef TOON_STEPS
+const int steps = TOON_STEPS;       // Baked in by the variant.
+#else
 uniform int steps;
+#endif
 uniform float lightPower;
 uniform float minAmbientLight;
 
+#include "clustered.glsl"
+#include "shadows.glsl"
+
 const float PI = 3.1415926535897932384626433832795;
 
 out vec4 outColor; // Outputs color in RGBA.
@@ -31,6 +67,11 @@ vec4 interpolate(vec4 a, vec4 b, float step) {
 
 void main() {
 
+#ifdef DEFERRED
+    // Shade the surface from the G-buffer, and leave the background alone.
+    if (!readSurface()) discard;
+#endif
+
     // Get the normal ready to use.
     vec3 normal = normalize(vertexNormal);
     
@@ -46,10 +87,28 @@ void main() {
     // Modify intensity.
     if (intensity > 1.0) intensity = 1.0;
     if (intensity < 0.0) intensity = 0.0;
+#ifdef SHADOWS
+    intensity *= getShadow(vertexPosition, normal);
+#endif
     intensity = round(intensity * steps) / steps;
 
     // Final color.
     vec4 color = interpolate(vec4(minColor, 1.0), fragmentColor, intensity);
+
+#ifdef CLUSTERED
+    // Add the point lights of this cluster, banded like the main light.
+    uvec2 cluster = getClusterLights(vertexPosition);
+
+    for (uint i = 0u; i < cluster.y; i++) {
+
+        vec3 pointDir;
+        vec3 radiance = getPointLight(texelFetch(clusterLights, int(cluster.x + i)).r, vertexPosition, pointDir);
+        float pointIntensity = round(clamp(dot(pointDir, normal), 0.0, 1.0) * steps) / steps;
+
+        color.rgb += fragmentColor.rgb * pointIntensity * radiance;
+
+    }
+#endif
         
     // Get the vector from the observer to the fragment.
     vec3 viewVector = normalize(cameraPosition - vertexPosition);
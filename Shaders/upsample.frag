@@ -0,0 +1,72 @@
+#version 330 core
+
+uniform sampler2D lowColor;         // Color shaded at the reduced rate, alpha is 0 where there is no surface.
+uniform sampler2D gPosition;        // Full rate position, w is 0 where there is no surface.
+uniform sampler2D gNormal;          // Full rate normal.
+uniform vec2 lowSize;               // Size of the reduced rate target, in pixels.
+uniform mat4 Projection;            // Imports the projection matrix, to write the depth back.
+in vec2 screenUV;                   // Where to read the targets.
+
+const float depthSharpness = 50.0;  // How fast the weight falls with the difference in depth.
+const float normalSharpness = 16.0; // How fast the weight falls with the difference in normal.
+
+out vec4 outColor; // Outputs color in RGBA.
+
+void main() {
+
+    // Only where the object is.
+    vec4 position = texture(gPosition, screenUV);
+    if (position.w == 0.0) discard;
+
+    vec3 normal = normalize(texture(gNormal, screenUV).xyz);
+
+    // The 4 reduced rate samples around this pixel.
+    vec2 coord = screenUV * lowSize - 0.5;
+    vec2 base = floor(coord);
+    vec2 blend = coord - base;
+
+    vec3 color = vec3(0.0);
+    float total = 0.0;
+    vec3 nearest = vec3(0.0);
+    float best = -1.0;
+
+    for (int i = 0; i < 4; i++) {
+
+        vec2 offset = vec2(i & 1, i >> 1);
+        vec2 uv = clamp((base + offset + 0.5) / lowSize, vec2(0.0), vec2(1.0));
+
+        // Samples off the surface were never shaded.
+        vec4 sampleColor = texture(lowColor, uv);
+        if (sampleColor.a == 0.0) continue;
+
+        // The surface the sample shaded, read the same way the reduced pass did.
+        vec3 samplePosition = texture(gPosition, uv).xyz;
+        vec3 sampleNormal = normalize(texture(gNormal, uv).xyz);
+
+        // Bilinear weight, lowered across depth and normal edges.
+        float bilinear = mix(1.0 - blend.x, blend.x, offset.x) * mix(1.0 - blend.y, blend.y, offset.y);
+        float similarity = exp(-abs(samplePosition.z - position.z) * depthSharpness) * pow(max(dot(sampleNormal, normal), 0.0), normalSharpness);
+        float weight = bilinear * similarity;
+
+        color += sampleColor.rgb * weight;
+        total += weight;
+
+        // Keep the most similar one, for when every weight vanishes.
+        if (similarity > best) {
+
+            best = similarity;
+            nearest = sampleColor.rgb;
+
+        }
+
+    }
+
+    if (best < 0.0) discard;
+
+    outColor = vec4(total > 1e-4 ? color / total : nearest, 1.0);
+
+    // Write the depth of the surface, so it sorts with the full rate objects.
+    vec4 clip = Projection * vec4(position.xyz, 1.0);
+    gl_FragDepth = clip.z / clip.w * 0.5 + 0.5;
+
+}
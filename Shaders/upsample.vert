@@ -0,0 +1,11 @@
+#version 330 core
+
+out vec2 screenUV;			// Passes where to read the targets to the fragment shader.
+
+void main() {
+
+	// Cover the screen with one triangle.
+	screenUV = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+	gl_Position = vec4(screenUV * 2.0 - 1.0, 0.0, 1.0);
+
+}